@@ -0,0 +1,105 @@
+//-----------------------------------------------------------------------
+// <copyright file="Program.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "P3/Actor.h"
+#include "P3/Runtime.h"
+#include "P3/TestingServices.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+// Measures the latency of a scheduling point during testing, by bouncing
+// events between two actors, so that almost every step hands off from the
+// thread of one actor to the thread of the other.
+
+class PingEvent : public Event
+{
+public:
+    const ActorId* Id;
+    int Count;
+
+    PingEvent(const ActorId* id, int count) : Event("PingEvent"), Id(id), Count(count) { }
+};
+
+// Bounces every ping back to its sender, until the count runs out. A ping
+// without a sender creates the bouncer to play against.
+class Bouncer : public Actor
+{
+protected:
+    void HandleEvent(std::unique_ptr<Event> event)
+    {
+        auto ping = static_cast<PingEvent*>(event.get());
+        auto target = ping->Id != nullptr ? ping->Id : CreateActor<Bouncer>("Ponger");
+        if (ping->Count > 0)
+        {
+            Send(*target, std::make_unique<PingEvent>(GetId(), ping->Count - 1));
+        }
+    }
+};
+
+static int NumOfPings = 1000;
+
+int main(int argc, char* argv[])
+{
+    // Usage: SchedulingLatency [iterations] [pings] [single]
+    std::unique_ptr<Configuration> configuration(Configuration::Create());
+    configuration->SchedulingIterations = argc > 1 ? std::atoi(argv[1]) : 100;
+    configuration->RandomSchedulingSeed = 1;
+    configuration->ToolVerbosity = false;
+    configuration->EnableSingleThreadMode = argc > 3 && std::string(argv[3]) == "single";
+    NumOfPings = argc > 2 ? std::atoi(argv[2]) : 1000;
+    bool isSingleThreaded = configuration->EnableSingleThreadMode;
+
+    std::unique_ptr<BugFindingEngine> engine(BugFindingEngine::Create(
+        std::move(configuration),
+        [](Runtime& runtime)
+    {
+        runtime.CreateActor<Bouncer>("Pinger", std::make_unique<PingEvent>(nullptr, NumOfPings));
+    }));
+
+    auto start = std::chrono::steady_clock::now();
+    engine->Run();
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    auto report = engine->GetReport();
+    if (isSingleThreaded)
+    {
+        std::cout << "Handoff: none, single-thread mode" << std::endl;
+    }
+    else
+    {
+#ifdef P3_USE_FUTEX_HANDOFF
+        std::cout << "Handoff: futex" << std::endl;
+#else
+        std::cout << "Handoff: condition variable" << std::endl;
+#endif
+    }
+
+    std::cout << "Iterations: " << report->NumOfExploredSchedules << std::endl;
+    std::cout << "Scheduling steps: " << report->TotalExploredSteps << std::endl;
+    std::cout << "Time: " << elapsed.count() / 1000000 << " ms" << std::endl;
+    std::cout << "Iterations per second: " << report->NumOfExploredSchedules * 1e9 / elapsed.count() << std::endl;
+    if (report->TotalExploredSteps > 0)
+    {
+        std::cout << "Latency: " << elapsed.count() / report->TotalExploredSteps <<
+            " ns per scheduling step" << std::endl;
+    }
+
+    return 0;
+}
@@ -16,6 +16,7 @@
 #define MICROSOFT_P3_ACTOR_H
 
 #include "P3/Event.h"
+#include <chrono>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -40,6 +41,11 @@ namespace Microsoft { namespace P3
     public:
         virtual ~Actor() = 0;
 
+        // Actors created during a testing iteration are allocated from
+        // the arena of the iteration.
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr);
+
     protected:
         // The runtime that executes the actor with this id.
         Runtime* Runtime;
@@ -60,11 +66,29 @@ namespace Microsoft { namespace P3
             return Runtime->CreateMachine<T>(name, move(event));
         }
 
+        // Creates a new machine of the specified type on the specified node
+        // of the simulated network.
+        template<typename T>
+        const ActorId* CreateMachine(int node, std::string name, std::unique_ptr<Event> event = nullptr)
+        {
+            return Runtime->CreateMachine<T>(node, name, move(event));
+        }
+
         // Sends an asynchronous event to the target.
         void Send(const ActorId& target, std::unique_ptr<Event> event);
         
         // Invokes the monitor with the specified name.
-        void InvokeMonitor(std::string name, std::unique_ptr<Event> event);
+        void InvokeMonitor(const std::string& name, std::unique_ptr<Event> event);
+
+        // Invokes the monitor of the specified type.
+        template<typename T>
+        void InvokeMonitor(std::unique_ptr<Event> event)
+        {
+            Runtime->template InvokeMonitor<T>(move(event));
+        }
+
+        // Invokes every monitor that handles the event in any of its states.
+        void InvokeMonitors(std::unique_ptr<Event> event);
 
         // Logs the specified message.
         void Log(const std::string& message);
@@ -81,6 +105,27 @@ namespace Microsoft { namespace P3
         // Checks if the assertion holds, and if not it throws an exception.
         void Assert(bool predicate, std::ostringstream& stream);
 
+        // Returns a nondeterministic boolean choice, which is controlled
+        // by the exploration strategy during testing.
+        bool RandomBoolean();
+
+        // Returns a nondeterministic integer choice in [0, maxValue), which
+        // is controlled by the exploration strategy during testing.
+        int RandomInteger(int maxValue);
+
+        // Returns the time elapsed since the runtime started. During testing
+        // this is a virtual time, which only advances when a timer fires.
+        std::chrono::milliseconds Now();
+
+        // Starts a timer that sends the specified event to this actor once the
+        // due time has elapsed, and returns its id. During testing the timer
+        // fires without waiting, when the exploration strategy chooses to.
+        long StartTimer(std::chrono::milliseconds dueTime, std::unique_ptr<Event> event);
+
+        // Stops the timer with the specified id. An event that the timer
+        // already sent is not removed from the inbox.
+        void StopTimer(long timer);
+
         // Handles the specified event.
         virtual void HandleEvent(std::unique_ptr<Event> event) = 0;
 
@@ -111,7 +156,15 @@ namespace Microsoft { namespace P3
         std::unique_ptr<Event> GetNextEvent();
         
         virtual void Start(std::unique_ptr<Event> event);
-        virtual void RunEventHandler();
+        void RunEventHandler();
+
+        // Handles the next event. Returns false, and stops running, if there
+        // is no event to handle.
+        virtual bool HandleNextEvent();
+
+        // Returns true if the actor has an event to handle next. If not, it
+        // stops running, so that the next event it receives runs a new handler.
+        virtual bool HasNextEvent();
         
         // Sets the unique id of this actor.
         void SetActorId(std::unique_ptr<const ActorId> id);
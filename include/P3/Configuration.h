@@ -16,6 +16,7 @@
 #define MICROSOFT_P3_CONFIGURATION_H
 
 #include "TestingServices/ExplorationStrategy.h"
+#include <string>
 
 namespace Microsoft { namespace P3
 {
@@ -33,12 +34,140 @@ namespace Microsoft { namespace P3
         // Enables verbose output in the tool.
         bool ToolVerbosity;
 
-        // Number of scheduling iterations.
+        // Number of runtime log records that each testing iteration keeps in
+        // memory. The oldest records are overwritten, and they are only
+        // formatted, and written, if the iteration finds a bug. By default, the
+        // latest 1000 records are kept. If zero, the runtime logs only if verbose.
+        int LogBufferSize;
+
+        // Number of scheduling iterations. If zero and a timeout is set, the
+        // campaign runs until the timeout expires.
         int SchedulingIterations;
 
+        // Maximum number of scheduling steps of a single iteration. An
+        // iteration that reaches it is cut off. If zero, there is no bound.
+        int MaxSchedulingSteps;
+
+        // Maximum number of timers that fire during a single iteration. Once
+        // it is reached, pending timers no longer fire, and the iteration ends
+        // when only timers remain, so that a timer that restarts itself does
+        // not keep the iteration alive forever. If zero, there is no bound.
+        int MaxTimerFirings;
+
+        // Number of scheduling steps that a monitor can spend in a hot state
+        // before a liveness bug is reported. If zero, it is half of the max
+        // scheduling steps, or unbounded if those are unbounded.
+        int LivenessTemperatureThreshold;
+
+        // Wall-clock budget of the whole testing campaign, in seconds. The
+        // campaign stops once it is exhausted, even if iterations remain. If
+        // zero, there is no budget.
+        int Timeout;
+
+        // Wall-clock budget of a single iteration, in milliseconds. An
+        // iteration that exceeds it is cut off at its next scheduling point.
+        // If zero, there is no budget.
+        int IterationTimeout;
+
+        // Time, in milliseconds, after which an iteration that reaches no
+        // scheduling point is reported as hung and quarantined, so that an actor
+        // that blocks outside of the scheduler does not stall the campaign. The
+        // campaign stops when too many hung iterations are still blocked.
+        // If zero, which is the default, the watchdog is disabled.
+        int WatchdogTimeout;
+
+        // Number of faults that the simulated network injects per iteration
+        // into the events sent between machines on different nodes: delays,
+        // which reorder events, drops, duplicates, and crashes of the target
+        // node, which then restarts. The strategy chooses when they happen.
+        // If zero, events between nodes are delivered like local events.
+        int MaxNetworkFaults;
+
+        // Number of child processes that explore schedules in parallel, each
+        // with its own slice of the schedules. In single-thread mode, the
+        // testing process runs the steps before the first choice once, and
+        // forks each iteration from there, so they share the setup; else it
+        // forks each iteration from its start. The testing process keeps the
+        // progress of the slices. Only supported on Linux. If zero, all
+        // iterations run in the testing process.
+        int ForkedProcesses;
+
+        // Assigns a portfolio of strategies to the forked processes instead of
+        // the configured one, and rebalances iterations, between rounds, toward
+        // the strategies that cover new activities or find bugs. Requires
+        // ForkedProcesses.
+        bool EnableStrategyPortfolio;
+
         // Exploration strategy to be used during testing.
         TestingServices::ExplorationStrategy Strategy;
 
+        // Bound of the exploration strategy: the number of delays per
+        // iteration of the delay-bounding strategy, or the depth of the PCT
+        // strategy, which changes priorities at depth - 1 steps. The
+        // production-replay strategy deviates from the trace as many times.
+        int StrategyBound;
+
+        // Shrinks the schedule trace of a buggy iteration to a minimal
+        // schedule that still triggers the bug.
+        bool EnableScheduleMinimization;
+
+        // Fingerprints the program state at every scheduling step, from the
+        // state stacks, inboxes and hashed fields of the machines and monitors.
+        // The distinct states are counted, a liveness bug is reported when a
+        // fair cycle of the execution keeps a monitor hot, and the DFS strategy
+        // prunes states that it already explored.
+        bool EnableStateHashing;
+
+        // Inserts scheduling points only where an actor receives its next
+        // event, instead of before every send, so that each event handler runs
+        // atomically. This explores far fewer schedules, but misses the bugs
+        // that need a reply to overtake a later send of the same handler, or
+        // monitor invocations of different handlers to interleave.
+        bool ScheduleOnlyAtReceives;
+
+        // Runs every event handler to completion on the testing thread, instead
+        // of on a thread of its own, and only lets the strategy choose whose
+        // next event is handled. This explores the interleavings of
+        // ScheduleOnlyAtReceives without any context switch, but an actor that
+        // blocks stalls the whole iteration. The step bound and the time
+        // budgets still cut an iteration off between two handlers, but the
+        // watchdog does not run in this mode, as it would watch the thread that
+        // runs the handlers: a handler that never returns hangs the campaign
+        // without a hang report.
+        bool EnableSingleThreadMode;
+
+        // Records the states, transitions and events that machines and monitors
+        // cover during testing, and writes a coverage report to the output
+        // directory.
+        bool ReportActivityCoverage;
+
+        // Seed of the random scheduling strategy. Each iteration derives
+        // its own seed from it. By default, it is chosen randomly.
+        unsigned int RandomSchedulingSeed;
+
+#pragma warning(push)
+#pragma warning(disable: 4251)
+        // Directory where the schedule traces of buggy iterations are
+        // written. If empty, no trace is written.
+        std::string OutputFilePath;
+
+        // Schedule trace to replay with the replay strategy.
+        std::string ScheduleFile;
+
+        // Event trace that the actor runtime records in production, and that
+        // the production-replay strategy replays. The runtime writes the trace
+        // as it grows, when a handler fails, and when it is destroyed. If
+        // empty, the actor runtime records nothing.
+        std::string EventTraceFile;
+
+        // File that keeps the exploration progress of the testing campaign
+        // across runs: the next iteration, the coverage, and the progress of
+        // the strategy. If the file exists, testing resumes from it with the
+        // seed that the campaign started with, and it is updated once testing
+        // ends. If empty, every run starts a new campaign.
+        std::string CampaignFile;
+#pragma warning(pop)
+
         static Configuration* Create();
         static Configuration* CopyFrom(const Configuration& that);
         
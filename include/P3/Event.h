@@ -15,6 +15,8 @@
 #ifndef MICROSOFT_P3_EVENT_H
 #define MICROSOFT_P3_EVENT_H
 
+#include <cstddef>
+#include <memory>
 #include <string>
 
 namespace Microsoft { namespace P3
@@ -25,12 +27,28 @@ namespace Microsoft { namespace P3
         friend class Actor;
         friend class Machine;
         friend class Monitor;
+        friend class Runtime;
         friend class ActorRuntime;
         friend class BugFindingRuntime;
 
     public:
         virtual ~Event() = 0;
 
+        // Events created during a testing iteration are allocated from
+        // the arena of the iteration.
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr);
+
+        // Returns a copy of this event, which the simulated network sends when
+        // it duplicates the event. By default events are not copied, and the
+        // network does not duplicate them.
+        virtual std::unique_ptr<Event> Clone() const;
+
+        // Returns a hash of the payload of this event, which is part of the
+        // fingerprint of the program state while the event is in an inbox. By
+        // default, events are only told apart by their name.
+        virtual size_t HashState() const;
+
     protected:
         Event(std::string name);
 
@@ -25,6 +25,7 @@
 #include <sstream>
 #include <stack>
 #include <string>
+#include <vector>
 
 namespace Microsoft { namespace P3
 {
@@ -67,14 +68,22 @@ namespace Microsoft { namespace P3
         // Adds a state with the specified name to the machine.
         MachineState* AddState(std::string name, bool isStart = false);
 
+        // Returns a hash of the fields of the machine, which is part of the
+        // fingerprint of the program state when state hashing is enabled. A
+        // machine that keeps state in its fields must hash them, so that its
+        // different states are not taken for the same one. By default, it
+        // returns zero.
+        virtual size_t HashState() const;
+
     private:
 #pragma warning(push)
 #pragma warning(disable: 4251)
         // Available states of this machine.
         std::map<std::string, std::unique_ptr<MachineState>> m_states;
 
-        // Stack of currently installed machine states.
-        std::stack<MachineState*> m_stateStack;
+        // Stack of currently installed machine states, with the current state
+        // at the back, so that the runtime can hash it without copying it.
+        std::vector<MachineState*> m_stateStack;
 
         // A stack of maps that determine event handling action for each event type.
         // These maps do not keep transition handlers. This stack has always the
@@ -96,7 +105,8 @@ namespace Microsoft { namespace P3
         std::unique_ptr<Event> GetNextEvent(bool& isDequeued);
         
         void Start(std::unique_ptr<Event> event);
-        void RunEventHandler();
+        bool HandleNextEvent();
+        bool HasNextEvent();
         
         void HandleEvent(std::unique_ptr<Event> event);
         void GotoState(std::string state, std::unique_ptr<Event> event);
@@ -63,6 +63,11 @@ namespace Microsoft { namespace P3
         // Adds a state with the specified name to the monitor.
         MonitorState* AddState(std::string name, bool isStart = false);
 
+        // Returns a hash of the fields of the monitor, which is part of the
+        // fingerprint of the program state when state hashing is enabled. By
+        // default, it returns zero.
+        virtual size_t HashState() const;
+
     private:
         // The runtime that executes this monitor.
         Runtime* m_runtime;
@@ -42,6 +42,14 @@ namespace Microsoft { namespace P3
         // Sets the action handler that is invoked when the monitor receives the specified event in this state.
         void SetOnEventDoAction(std::string event, Action action);
 
+        // Marks this state as hot. During testing, a monitor that stays in hot states
+        // for too long, or until execution ends, reports a liveness bug.
+        void SetHot();
+
+        // Marks this state as cold. Entering a cold state resets the time that the
+        // monitor has spent in hot states.
+        void SetCold();
+
     private:
         // Handler to the monitor that owns this state.
         Monitor* m_monitor;
@@ -64,6 +72,12 @@ namespace Microsoft { namespace P3
         std::map<std::string, Action> m_actionBindings;
 #pragma warning(pop)
 
+        // Is this a hot state.
+        bool m_isHot;
+
+        // Is this a cold state.
+        bool m_isCold;
+
         MonitorState(std::string name, Monitor& monitor);
 
         // Copy is disabled.
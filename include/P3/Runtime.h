@@ -20,9 +20,12 @@
 #include "Actor.h"
 #include "Machine.h"
 #include "Monitor.h"
+#include <chrono>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <typeinfo>
 
 namespace Microsoft { namespace P3
 {
@@ -43,7 +46,7 @@ namespace Microsoft { namespace P3
         // Creates a new actor runtime with the specified configuration.
         static Runtime* Create(std::unique_ptr<Configuration> configuration);
 
-        // Creates a new actor of the specified type.
+        // Creates a new actor of the specified type, on the node of its creator.
         template<typename T>
         const ActorId* CreateActor(std::string name, std::unique_ptr<Event> event = nullptr)
         {
@@ -51,18 +54,28 @@ namespace Microsoft { namespace P3
             auto actor = new T();
             Assert(actor != nullptr, "Failed to create actor '" + name + "'.");
             InitializeActor(actor, name);
+            PlaceOnNode(*actor, -1, &Runtime::Construct<T>);
             RunEventHandler(*actor, move(event), true);
             return actor->m_id.get();
         }
 
-        // Creates a new machine of the specified type.
+        // Creates a new machine of the specified type, on the node of its creator.
         template<typename T>
         const ActorId* CreateMachine(std::string name, std::unique_ptr<Event> event = nullptr)
+        {
+            return CreateMachine<T>(-1, name, move(event));
+        }
+
+        // Creates a new machine of the specified type on the specified node of
+        // the simulated network, or on the node of its creator if negative.
+        template<typename T>
+        const ActorId* CreateMachine(int node, std::string name, std::unique_ptr<Event> event = nullptr)
         {
             Assert(std::is_base_of<Machine, T>::value, "Type is not a machine.");
             auto machine = new T();
             Assert(machine != nullptr, "Failed to create machine '" + name + "'.");
             InitializeMachine(machine, name);
+            PlaceOnNode(*machine, node, &Runtime::Construct<T>);
             RunEventHandler(*machine, move(event), true);
             return machine->m_id.get();
         }
@@ -81,7 +94,18 @@ namespace Microsoft { namespace P3
         void SendEvent(const ActorId& target, std::unique_ptr<Event> event);
 
         // Invokes the monitor with the specified name.
-        virtual void InvokeMonitor(std::string name, std::unique_ptr<Event> event) = 0;
+        virtual void InvokeMonitor(const std::string& name, std::unique_ptr<Event> event) = 0;
+
+        // Invokes the monitor of the specified type, which must be registered once.
+        template<typename T>
+        void InvokeMonitor(std::unique_ptr<Event> event)
+        {
+            static_assert(std::is_base_of<Monitor, T>::value, "Type is not a monitor.");
+            InvokeMonitor(typeid(T), move(event));
+        }
+
+        // Invokes every monitor that handles the event in any of its states.
+        virtual void InvokeMonitors(std::unique_ptr<Event> event) = 0;
 
         // Logs the specified message.
         virtual void Log(const std::string& message);
@@ -110,6 +134,9 @@ namespace Microsoft { namespace P3
         Runtime();
         Runtime(std::unique_ptr<Configuration> configuration);
 
+        // Restarts the unique ids of new actors from zero.
+        void ResetIdCounter();
+
         // Initializes the specified actor.
         virtual void InitializeActor(Actor* actor, std::string name) = 0;
 
@@ -119,12 +146,39 @@ namespace Microsoft { namespace P3
         // Initializes the specified monitor.
         virtual void InitializeMonitor(Monitor* monitor, std::string name) = 0;
 
+        // Invokes the monitor of the specified type.
+        virtual void InvokeMonitor(const std::type_info& type, std::unique_ptr<Event> event) = 0;
+
+        // Type of a function that creates a new actor of a given type.
+        typedef Actor* (*ActorFactory)();
+
+        // Places the specified actor on a node of the simulated network, or on
+        // the node of its creator if negative. The factory creates the actor
+        // again when its node restarts after a crash.
+        virtual void PlaceOnNode(Actor& actor, int node, ActorFactory factory);
+
         // Runs a new asynchronous event handler for the specified actor.
         virtual void RunEventHandler(Actor& actor, std::unique_ptr<Event> event, bool isFresh) = 0;
 
         // Sends an asynchronous event to the specified actor.
         virtual void SendEvent(const ActorId& target, std::unique_ptr<Event> event, const ActorId* sender) = 0;
 
+        // Returns a nondeterministic boolean choice for the specified actor.
+        virtual bool GetNondeterministicBooleanChoice(Actor& actor, int maxValue) = 0;
+
+        // Returns a nondeterministic integer choice, in [0, maxValue), for the specified actor.
+        virtual int GetNondeterministicIntegerChoice(Actor& actor, int maxValue) = 0;
+
+        // Returns the time elapsed since the runtime started, on its clock.
+        virtual std::chrono::milliseconds GetTime() = 0;
+
+        // Starts a timer that sends the specified event to the actor once
+        // the due time has elapsed, and returns its id.
+        virtual long StartTimer(Actor& actor, std::chrono::milliseconds dueTime, std::unique_ptr<Event> event) = 0;
+
+        // Stops the timer with the specified id, if it has not fired yet.
+        virtual void StopTimer(long timer) = 0;
+
         // Notifies that a machine entered a state.
         virtual void NotifyEnteredState(Machine& machine);
 
@@ -152,6 +206,15 @@ namespace Microsoft { namespace P3
         // Notifies that a machine popped its state.
         virtual void NotifyPoppedState(Machine& machine);
 
+        // Notifies that a machine dequeued an event.
+        virtual void NotifyDequeuedEvent(Machine& machine, Event& event);
+
+        // Notifies that an actor, which is not a machine, dequeued an event.
+        virtual void NotifyDequeuedEvent(Actor& actor, Event& event);
+
+        // Notifies that an actor enqueued an event into its inbox.
+        virtual void NotifyEnqueuedEvent(Actor& actor, Event& event);
+
     private:
         // Monotonically increasing id counter.
         volatile long m_idCounter;
@@ -159,6 +222,13 @@ namespace Microsoft { namespace P3
         // Returns the next unique id.
         long GetNextId();
 
+        // Creates a new actor of the specified type.
+        template<typename T>
+        static Actor* Construct()
+        {
+            return new T();
+        }
+
         // Copy is disabled.
         Runtime(const Runtime& that) = delete;
         Runtime &operator=(Runtime const &) = delete;
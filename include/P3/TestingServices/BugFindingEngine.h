@@ -18,12 +18,24 @@
 #include "Statistics/TestReport.h"
 #include "P3/Configuration.h"
 #include "P3/Runtime.h"
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <vector>
+
+namespace Microsoft { namespace P3
+{
+    class BugFindingRuntime;
+    class RuntimeQuarantine;
+} }
 
 namespace Microsoft { namespace P3 { namespace TestingServices
 {
+    class CoverageInfo;
     class IExplorationStrategy;
+    class ScheduleTrace;
+    class StrategyPortfolio;
 
     // Type of a machine action.
     typedef std::function<void(Runtime&)> TestAction;
@@ -38,9 +50,20 @@ namespace Microsoft { namespace P3 { namespace TestingServices
         // Runs the engine.
         void Run();
 
+        // Runs a single iteration whose choices are derived from the specified
+        // input, and returns true if it triggered a bug. Requires the input-driven
+        // strategy. It is meant to be called from a fuzzer entry point, such as
+        // LLVMFuzzerTestOneInput, which should abort when a bug is found. Set
+        // MaxSchedulingSteps, so that every input runs quickly.
+        bool RunInput(const uint8_t* data, size_t size);
+
         // Returns the generated test report.
         TestReport* GetReport();
 
+        // Returns the strategy portfolio of the campaign, or null if it does
+        // not use one.
+        const StrategyPortfolio* GetPortfolio() const;
+
         ~BugFindingEngine();
 
     private:
@@ -52,15 +75,114 @@ namespace Microsoft { namespace P3 { namespace TestingServices
 
         // The test report.
         std::unique_ptr<TestReport> m_report;
+
+        // The runtime, which is reused across iterations.
+        std::unique_ptr<BugFindingRuntime> m_runtime;
+
+        // The runtimes of hung iterations, until their processes return.
+        std::unique_ptr<RuntimeQuarantine> m_quarantine;
+
+        // The activity coverage of the campaign, if it is recorded.
+        std::unique_ptr<CoverageInfo> m_coverage;
+
+        // The strategy portfolio of the campaign, if it is used.
+        std::unique_ptr<StrategyPortfolio> m_portfolio;
+
+        // Iteration that the campaign resumes from.
+        int m_firstIteration;
+
+        // Number of iterations of this process that covered activities that
+        // it had not covered before, or found a bug, which rewards its
+        // strategy in a portfolio.
+        long long m_numOfRewardedIterations;
         
         // The entry point to the test.
         TestAction m_testAction;
 
+        // Time at which the testing campaign runs out of budget, if any.
+        std::chrono::steady_clock::time_point m_deadline;
+        bool m_hasDeadline;
+
+        // The strategies of the slices of the schedules that forked processes
+        // explore, which keep the progress that the processes report back.
+        std::vector<std::unique_ptr<IExplorationStrategy>> m_slices;
+
+        // The iterations of a round of forked processes.
+        struct ForkedRound;
+
         BugFindingEngine(std::unique_ptr<Configuration> configuration, TestAction);
 
         void Initialize();        
+
+        // Creates the specified strategy, with the specified bound.
+        std::unique_ptr<IExplorationStrategy> CreateStrategy(ExplorationStrategy strategy, int bound);
+
         void RunNextIteration(int iteration);
 
+        // Prepares the runtime for the next iteration, and returns the number
+        // of activities covered so far.
+        size_t StartIteration();
+
+        // Cuts the iteration off when either its own or the campaign budget runs out.
+        void SetIterationDeadline();
+
+        // Records the iteration that the runtime completed, which started at
+        // the specified time, when the specified number of activities was
+        // covered, and whose strategy took the steps of the trace from the
+        // specified position.
+        void CompleteIteration(int iteration, std::chrono::steady_clock::time_point start,
+            size_t numOfCoveredItems, size_t numOfPrefixSteps);
+
+        // Runs every stride-th iteration, starting from the specified one, up to
+        // the specified end, or up to the configured limit if the end is negative.
+        void RunIterations(int first, int stride, int end);
+
+        // Runs the iterations in forked processes, and merges their results.
+        void RunForkedProcesses();
+
+        // Runs the iterations from first up to end in forked processes, split in
+        // slices that each use the strategy assigned to it from the portfolio,
+        // if any, and merges their results. Returns false if no process could
+        // be forked.
+        bool RunForkedRound(int first, int end, StrategyPortfolio* portfolio, const std::vector<size_t>& arms);
+
+        // Forks a process for the next iteration of each slice of the round,
+        // until the round ends, and merges their results. Returns true in a
+        // forked process, which then runs its iteration.
+        bool RunSlices(ForkedRound& round);
+
+        // Merges the result that the forked process of the slice with the
+        // specified index reported, and exited with the specified status.
+        void MergeSliceResult(ForkedRound& round, size_t index, int status);
+
+        // Reports the result of the iteration of this forked process to the
+        // testing process, and exits.
+        void ExitForkedProcess(ForkedRound& round);
+
+        // Runs the iterations in rounds of forked processes, rebalancing the
+        // strategies of the portfolio between rounds. Returns false if no
+        // process could be forked.
+        bool RunStrategyPortfolio();
+
+        // Writes and minimizes the trace of the specified bug, as configured.
+        void HandleBug(const ScheduleTrace& trace, const std::string& bugReport, int bug);
+
+        // Shrinks the specified buggy trace, and writes the result to the output directory.
+        void MinimizeTrace(const ScheduleTrace& trace, const std::string& bugReport, const std::string& name);
+
+        // Writes the specified trace to the output directory.
+        void SaveTrace(const ScheduleTrace& trace, const std::string& name);
+
+        // Writes the log that the runtime kept in memory during the buggy
+        // iteration to the output directory, or to the output if there is none.
+        void SaveLog(const std::string& name);
+
+        // Resumes the campaign from the configured campaign file, if it exists.
+        void LoadCampaign();
+
+        // Writes the progress of the campaign to the configured campaign file.
+        void SaveCampaign();
+
         void Log(const std::string& message);
 
         // Copy is disabled.
@@ -21,7 +21,15 @@ namespace Microsoft { namespace P3 { namespace TestingServices
 {
     enum class ExplorationStrategy
     {
-        Random = 0
+        Random = 0,
+        Replay,
+        CoverageGuided,
+        InputDriven,
+        RoundRobin,
+        DelayBounding,
+        PCT,
+        DFS,
+        ProductionReplay
     };
 } } }
 
@@ -15,18 +15,120 @@
 #ifndef MICROSOFT_P3_TESTINGSERVICES_STATISTICS_TESTREPORT_H
 #define MICROSOFT_P3_TESTINGSERVICES_STATISTICS_TESTREPORT_H
 
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
 namespace Microsoft { namespace P3 { namespace TestingServices
 {
     // Test report generated by the bug-finding engine.
     class TestReport
     {
     public:
+        // Reason why the testing campaign stopped.
+        enum class TerminationReason
+        {
+            // All requested iterations were executed.
+            IterationLimit = 0,
+            // The wall-clock budget was exhausted.
+            Timeout,
+            // A bug was found.
+            BugFound,
+            // The exploration strategy has no more schedules to explore.
+            StrategyExhausted,
+            // Too many hung iterations are still blocked.
+            HangLimit
+        };
+
+        // Number of buckets of the scheduling steps histogram.
+        static const int NumOfHistogramBuckets = 32;
+
         // Number of found bugs.
         int NumOfFoundBugs;
 
+        // Number of iterations that completed with actors waiting on deferred
+        // events, and of iterations that were abandoned by the watchdog.
+        int NumOfDeadlocks;
+        int NumOfHangs;
+
+        // Number of explored schedules, one per executed iteration.
+        int NumOfExploredSchedules;
+
+        // Number of explored schedules that were cut off by the step bound
+        // or the iteration timeout before they completed.
+        int NumOfCutOffSchedules;
+
+        // Total number of scheduling steps over all explored schedules.
+        long long TotalExploredSteps;
+
+        // Minimum and maximum number of scheduling steps of an explored schedule.
+        int MinExploredSteps;
+        int MaxExploredSteps;
+
+        // Number of explored schedules per number of scheduling steps. Bucket
+        // zero counts schedules without steps, and bucket k > 0 counts schedules
+        // with [2^(k-1), 2^k) steps.
+        int ExploredStepsHistogram[NumOfHistogramBuckets];
+
+        // Wall-clock time spent testing, in seconds.
+        double TestingTime;
+
+        // Minimum and maximum wall-clock time of an iteration, in seconds.
+        double MinIterationTime;
+        double MaxIterationTime;
+
+        // Total wall-clock time of all iterations, in seconds.
+        double TotalIterationTime;
+
+        // Number of actors created over all explored schedules.
+        long long NumOfCreatedActors;
+
+        // Number of events sent over all explored schedules.
+        long long NumOfSentEvents;
+
+        // Number of distinct program states visited over all explored
+        // schedules, if state hashing is enabled.
+        long long NumOfProgramStates;
+
+#pragma warning(push)
+#pragma warning(disable: 4251)
+        // Iterations that triggered a bug.
+        std::vector<int> BugIterations;
+#pragma warning(pop)
+
+        // Reason why the testing campaign stopped.
+        TerminationReason Termination;
+
         TestReport();
         ~TestReport();
 
+        // Records the statistics of an explored schedule.
+        void RecordIteration(int steps, double time, long long createdActors, long long sentEvents);
+
+        // Returns the number of explored schedules per second.
+        double GetSchedulesPerSecond() const;
+
+        // Returns the average number of scheduling steps of an explored schedule.
+        double GetAverageExploredSteps() const;
+
+        // Returns the average wall-clock time of an iteration, in seconds.
+        double GetAverageIterationTime() const;
+
+        // Merges the report of a testing campaign that ran in parallel to this one.
+        void Merge(const TestReport& that);
+
+        // Returns the report as a JSON object.
+        std::string ToJson() const;
+
+        // Writes the report in a binary format, to pass it to another process
+        // on the same machine.
+        void Serialize(std::ostream& stream) const;
+
+        // Reads a report in its binary format. Returns false if the stream
+        // does not contain a valid report.
+        bool Deserialize(std::istream& stream);
+
         static TestReport* CopyFrom(const TestReport& that);
 
     private:
@@ -13,6 +13,7 @@
 //-----------------------------------------------------------------------
 
 #include "P3/Configuration.h"
+#include <random>
 
 using namespace Microsoft::P3;
 using namespace TestingServices;
@@ -27,8 +28,29 @@ Configuration* Configuration::CopyFrom(const Configuration& that)
     auto copy = new Configuration();
     copy->Verbosity = that.Verbosity;
     copy->ToolVerbosity = that.ToolVerbosity;
+    copy->LogBufferSize = that.LogBufferSize;
     copy->SchedulingIterations = that.SchedulingIterations;
+    copy->MaxSchedulingSteps = that.MaxSchedulingSteps;
+    copy->MaxTimerFirings = that.MaxTimerFirings;
+    copy->LivenessTemperatureThreshold = that.LivenessTemperatureThreshold;
+    copy->Timeout = that.Timeout;
+    copy->IterationTimeout = that.IterationTimeout;
+    copy->WatchdogTimeout = that.WatchdogTimeout;
+    copy->MaxNetworkFaults = that.MaxNetworkFaults;
+    copy->ForkedProcesses = that.ForkedProcesses;
+    copy->EnableStrategyPortfolio = that.EnableStrategyPortfolio;
     copy->Strategy = that.Strategy;
+    copy->StrategyBound = that.StrategyBound;
+    copy->EnableScheduleMinimization = that.EnableScheduleMinimization;
+    copy->EnableStateHashing = that.EnableStateHashing;
+    copy->ScheduleOnlyAtReceives = that.ScheduleOnlyAtReceives;
+    copy->EnableSingleThreadMode = that.EnableSingleThreadMode;
+    copy->ReportActivityCoverage = that.ReportActivityCoverage;
+    copy->RandomSchedulingSeed = that.RandomSchedulingSeed;
+    copy->OutputFilePath = that.OutputFilePath;
+    copy->ScheduleFile = that.ScheduleFile;
+    copy->EventTraceFile = that.EventTraceFile;
+    copy->CampaignFile = that.CampaignFile;
     return copy;
 }
 
@@ -36,8 +58,29 @@ Configuration::Configuration()
 {
     Verbosity = false;
     ToolVerbosity = true;
+    LogBufferSize = 1000;
     SchedulingIterations = 1;
+    MaxSchedulingSteps = 0;
+    MaxTimerFirings = 1000;
+    LivenessTemperatureThreshold = 0;
+    Timeout = 0;
+    IterationTimeout = 0;
+    WatchdogTimeout = 0;
+    MaxNetworkFaults = 0;
+    ForkedProcesses = 0;
+    EnableStrategyPortfolio = false;
     Strategy = ExplorationStrategy::Random;
+    StrategyBound = 2;
+    EnableScheduleMinimization = false;
+    EnableStateHashing = false;
+    ScheduleOnlyAtReceives = false;
+    EnableSingleThreadMode = false;
+    ReportActivityCoverage = false;
+    RandomSchedulingSeed = std::random_device()();
+    OutputFilePath = "";
+    ScheduleFile = "";
+    EventTraceFile = "";
+    CampaignFile = "";
 }
 
 Configuration::~Configuration() { }
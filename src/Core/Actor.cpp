@@ -15,6 +15,7 @@
 #include "P3/Actor.h"
 #include "P3/ActorId.h"
 #include "P3/Runtime.h"
+#include "../Runtime/IterationArena.h"
 #include <iostream>
 #include <memory>
 
@@ -33,11 +34,43 @@ void Actor::Send(const ActorId& target, std::unique_ptr<Event> event)
     Runtime->SendEvent(target, std::move(event), m_id.get());
 }
 
-void Actor::InvokeMonitor(std::string name, std::unique_ptr<Event> event)
+bool Actor::RandomBoolean()
+{
+    return Runtime->GetNondeterministicBooleanChoice(*this, 2);
+}
+
+int Actor::RandomInteger(int maxValue)
+{
+    Runtime->Assert(maxValue > 0, "The maximum value of a random integer must be positive.");
+    return Runtime->GetNondeterministicIntegerChoice(*this, maxValue);
+}
+
+std::chrono::milliseconds Actor::Now()
+{
+    return Runtime->GetTime();
+}
+
+long Actor::StartTimer(std::chrono::milliseconds dueTime, std::unique_ptr<Event> event)
+{
+    Runtime->Assert(event != nullptr, "Cannot start a timer with a null event.");
+    return Runtime->StartTimer(*this, dueTime, std::move(event));
+}
+
+void Actor::StopTimer(long timer)
+{
+    Runtime->StopTimer(timer);
+}
+
+void Actor::InvokeMonitor(const std::string& name, std::unique_ptr<Event> event)
 {
     Runtime->InvokeMonitor(name, move(event));
 }
 
+void Actor::InvokeMonitors(std::unique_ptr<Event> event)
+{
+    Runtime->InvokeMonitors(move(event));
+}
+
 void Actor::Log(const std::string& message)
 {
     Runtime->Log(message);
@@ -83,7 +116,7 @@ void Actor::Enqueue(std::unique_ptr<Event> event, bool& runNewHandler)
         return;
     }
     
-    Runtime->Log("<EnqueueLog> '" + m_id->m_name + "' enqueued event '" + event->m_name + "'.");
+    Runtime->NotifyEnqueuedEvent(*this, *event);
 
     // Inserts the event into the inbox queue.
     m_inbox.push_back(std::move(event));
@@ -123,31 +156,43 @@ void Actor::Start(std::unique_ptr<Event> event)
 // no next event to process or if the actor is halted.
 void Actor::RunEventHandler()
 {
-    if (m_isHalted)
+    // If the actor has halted, do nothing.
+    while (!m_isHalted && HandleNextEvent()) { }
+}
+
+bool Actor::HandleNextEvent()
+{
+    std::unique_ptr<Event> nextEvent = nullptr;
     {
-        // If the actor has halted, do nothing.
-        return;
+        // Lock the queue to avoid data races.
+        std::lock_guard<std::mutex> lock(m_inboxLock);
+        nextEvent = GetNextEvent();
     }
 
-    std::unique_ptr<Event> nextEvent = nullptr;
-    while (!m_isHalted)
+    // Check if next event to process is null.
+    if (nextEvent == nullptr)
+    {
+        m_isRunning = false;
+        return false;
+    }
+
+    Runtime->NotifyDequeuedEvent(*this, *nextEvent);
+
+    // Handle the next event.
+    HandleEvent(std::move(nextEvent));
+    return true;
+}
+
+bool Actor::HasNextEvent()
+{
+    std::lock_guard<std::mutex> lock(m_inboxLock);
+    if (m_isHalted || m_inbox.empty())
     {
-        {
-            // Lock the queue to avoid data races.
-            std::lock_guard<std::mutex> lock(m_inboxLock);
-            nextEvent = GetNextEvent();
-        }
-
-        // Check if next event to process is null.
-        if (nextEvent == nullptr)
-        {
-            m_isRunning = false;
-            break;
-        }
-
-        // Handle the next event.
-        HandleEvent(std::move(nextEvent));
+        m_isRunning = false;
+        return false;
     }
+
+    return true;
 }
 
 void Actor::SetActorId(std::unique_ptr<const ActorId> id)
@@ -156,4 +201,14 @@ void Actor::SetActorId(std::unique_ptr<const ActorId> id)
     m_id = std::move(id);
 }
 
+void* Actor::operator new(size_t size)
+{
+    return IterationArena::AllocateObject(size);
+}
+
+void Actor::operator delete(void* ptr)
+{
+    IterationArena::FreeObject(ptr);
+}
+
 Actor::~Actor() { }
@@ -13,6 +13,7 @@
 //-----------------------------------------------------------------------
 
 #include "P3/Event.h"
+#include "../../Runtime/IterationArena.h"
 
 using namespace Microsoft::P3;
 
@@ -20,4 +21,24 @@ Event::Event(std::string name) :
     m_name(name)
 { }
 
+void* Event::operator new(size_t size)
+{
+    return IterationArena::AllocateObject(size);
+}
+
+void Event::operator delete(void* ptr)
+{
+    IterationArena::FreeObject(ptr);
+}
+
+std::unique_ptr<Event> Event::Clone() const
+{
+    return nullptr;
+}
+
+size_t Event::HashState() const
+{
+    return 0;
+}
+
 Event::~Event() { }
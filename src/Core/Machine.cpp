@@ -90,6 +90,7 @@ std::unique_ptr<Event> Machine::GetNextEvent(bool& isDequeued)
                 nextEvent = std::move((*i));
                 i = m_inbox.erase(i);
                 isDequeued = true;
+                break;
             }
             else
             {
@@ -101,37 +102,63 @@ std::unique_ptr<Event> Machine::GetNextEvent(bool& isDequeued)
     return nextEvent;
 }
 
-// Runs the event handler. The handler terminates if there is
-// no next event to process or if the machine is halted.
-void Machine::RunEventHandler()
+// Handles the next event, giving priority to a raised event. Returns false,
+// and stops running, if there is no event to handle.
+bool Machine::HandleNextEvent()
 {
-    if (m_isHalted)
+    bool isDequeued = false;
+    std::unique_ptr<Event> nextEvent = nullptr;
     {
-        // If the machine has halted, do nothing.
-        return;
+        // Lock the queue to avoid data races.
+        std::lock_guard<std::mutex> lock(m_inboxLock);
+        nextEvent = GetNextEvent(isDequeued);
     }
 
-    std::unique_ptr<Event> nextEvent = nullptr;
-    while (!m_isHalted)
+    // Check if next event to process is null.
+    if (nextEvent == nullptr)
+    {
+        m_isRunning = false;
+        return false;
+    }
+
+    if (isDequeued)
     {
-        bool isDequeued = false;
+        Runtime->NotifyDequeuedEvent(*this, *nextEvent);
+    }
+
+    // Handle the next event.
+    HandleEvent(std::move(nextEvent));
+    return true;
+}
 
+// Checks if the machine has a raised event, or an event in its inbox that it
+// does not defer. Ignored events are dropped, like when they are dequeued.
+bool Machine::HasNextEvent()
+{
+    std::lock_guard<std::mutex> lock(m_inboxLock);
+    if (!m_isHalted && m_raisedEvent)
+    {
+        return true;
+    }
+
+    for (auto i = m_inbox.begin(); !m_isHalted && i != m_inbox.end();)
+    {
+        if (IsIgnored((*i)->m_name))
         {
-            // Lock the queue to avoid data races.
-            std::lock_guard<std::mutex> lock(m_inboxLock);
-            nextEvent = GetNextEvent(isDequeued);
+            i = m_inbox.erase(i);
         }
-
-        // Check if next event to process is null.
-        if (nextEvent == nullptr)
+        else if (!IsDeferred((*i)->m_name))
         {
-            m_isRunning = false;
-            break;
+            return true;
+        }
+        else
+        {
+            ++i;
         }
-
-        // Handle the next event.
-        HandleEvent(std::move(nextEvent));
     }
+
+    m_isRunning = false;
+    return false;
 }
 
 // Handles the specified event.
@@ -196,6 +223,13 @@ void Machine::Start(std::unique_ptr<Event> event)
 {
     Assert(!m_stateStack.empty(),
         "The start state for machine '" + m_id->m_name + "' has not been declared.");
+
+    // The start state is pushed when it is added, before its handlers are
+    // declared, so it is pushed again to install them.
+    auto startState = m_stateStack.back();
+    DoStatePop();
+    DoStatePush(startState);
+
     ExecuteCurrentStateOnEntry(std::move(event));
 }
 
@@ -227,7 +261,7 @@ void Machine::ExecuteCurrentStateOnEntry(std::unique_ptr<Event> event)
     // Notifies the runtime that the machine transitions to a new state.
     Runtime->NotifyEnteredState(*this);
 
-    Action entryAction = m_stateStack.top()->m_onEntryAction;
+    Action entryAction = m_stateStack.back()->m_onEntryAction;
 
     // Invokes the on-entry action of the new state, if there is one available.
     if (entryAction)
@@ -249,7 +283,7 @@ void Machine::ExecuteCurrentStateOnExit()
     // Notifies the runtime that the machine exits the current state.
     Runtime->NotifyExitedState(*this);
 
-    Action exitAction = m_stateStack.top()->m_onExitAction;
+    Action exitAction = m_stateStack.back()->m_onExitAction;
 
     // Invokes the on-exit action of the current state, if there is one available.
     if (exitAction)
@@ -370,14 +404,14 @@ void Machine::DoStatePush(MachineState* state)
         eventHandlerMap.erase(event.first);
     }
 
-    m_stateStack.push(state);
+    m_stateStack.push_back(state);
     m_actionHandlerStack.push(eventHandlerMap);
 }
 
 // Configures the state transitions of the machine when a state is poped from the stack.
 void Machine::DoStatePop()
 {
-    m_stateStack.pop();
+    m_stateStack.pop_back();
     m_actionHandlerStack.pop();
 
     if (m_stateStack.empty())
@@ -387,26 +421,45 @@ void Machine::DoStatePop()
     }
     else
     {
-        m_gotoTransitions = m_stateStack.top()->m_gotoTransitions;
-        m_pushTransitions = m_stateStack.top()->m_pushTransitions;
+        m_gotoTransitions = m_stateStack.back()->m_gotoTransitions;
+        m_pushTransitions = m_stateStack.back()->m_pushTransitions;
     }
 }
 
 // Checks if the machine ignores the specified event.
 bool Machine::IsIgnored(std::string event)
 {
-    return false;
+    if (m_actionHandlerStack.empty())
+    {
+        return false;
+    }
+
+    auto& handlers = m_actionHandlerStack.top();
+    auto handler = handlers.find(event);
+    return handler != handlers.end() && handler->second->m_type == EventHandler::Type::Ignore;
 }
 
 // Checks if the machine defers the specified event.
 bool Machine::IsDeferred(std::string event)
 {
-    return false;
+    if (m_actionHandlerStack.empty())
+    {
+        return false;
+    }
+
+    auto& handlers = m_actionHandlerStack.top();
+    auto handler = handlers.find(event);
+    return handler != handlers.end() && handler->second->m_type == EventHandler::Type::Defer;
 }
 
 std::string Machine::GetCurrentState()
 {
-    return m_stateStack.top()->m_name;
+    return m_stateStack.back()->m_name;
+}
+
+size_t Machine::HashState() const
+{
+    return 0;
 }
 
 Machine::~Machine()
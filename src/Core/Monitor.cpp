@@ -168,4 +168,9 @@ std::string Monitor::GetCurrentState()
     return m_currentState->m_name;
 }
 
+size_t Monitor::HashState() const
+{
+    return 0;
+}
+
 Monitor::~Monitor() { }
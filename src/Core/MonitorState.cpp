@@ -25,6 +25,8 @@ MonitorState::MonitorState(std::string name, Monitor& monitor)
     m_monitor = &monitor;
     m_onEntryAction = nullptr;
     m_onExitAction = nullptr;
+    m_isHot = false;
+    m_isCold = false;
 }
 
 void MonitorState::SetOnEntryAction(Action onEntry)
@@ -53,6 +55,20 @@ void MonitorState::SetOnEventDoAction(std::string event, Action action)
     m_actionBindings[event] = action;
 }
 
+void MonitorState::SetHot()
+{
+    m_monitor->Assert(!m_isCold,
+        "State '" + m_name + "' in monitor '" + m_monitor->m_name + "' cannot be both hot and cold.");
+    m_isHot = true;
+}
+
+void MonitorState::SetCold()
+{
+    m_monitor->Assert(!m_isHot,
+        "State '" + m_name + "' in monitor '" + m_monitor->m_name + "' cannot be both hot and cold.");
+    m_isCold = true;
+}
+
 // Checks if the event has been already declared in a handler for this state.
 void MonitorState::CheckPreviousDeclaration(std::string event)
 {
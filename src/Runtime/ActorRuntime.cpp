@@ -18,16 +18,58 @@
 #include "P3/ActorId.h"
 #include "P3/Runtime/AssertionFailureException.h"
 #include "P3/Event.h"
+#include <algorithm>
 #include <iostream>
+#include <random>
 
 using namespace Microsoft::P3;
 
+// Actor whose event handler runs on the calling thread, or -1 if none.
+static thread_local long CurrentActor = -1;
+
+// Operation of the calling thread that enqueues an event, which the event
+// trace records once the event enters the inbox, so that records follow the
+// order of the inbox.
+struct PendingEnqueue
+{
+    bool IsActive;
+    EventTraceRecorder::RecordType Type;
+    long Actor;
+};
+
+static thread_local PendingEnqueue CurrentEnqueue = { false, EventTraceRecorder::RecordType::SendEvent, -1 };
+
+// Returns the random generator of the calling thread, which is seeded on first use.
+static std::minstd_rand& GetGenerator()
+{
+    thread_local std::minstd_rand generator(std::random_device{}());
+    return generator;
+}
+
 // Creates a new runtime.
 ActorRuntime::ActorRuntime(std::unique_ptr<Configuration> configuration)
     : Runtime(move(configuration))
-{ }
+{
+    m_startTime = std::chrono::steady_clock::now();
+    m_lastTimerId = 0;
+    m_isDisposed = false;
+    if (!Config->EventTraceFile.empty())
+    {
+        m_recorder = std::make_unique<EventTraceRecorder>(Config->EventTraceFile);
+    }
+}
 
-void ActorRuntime::InvokeMonitor(std::string name, std::unique_ptr<Event> event)
+void ActorRuntime::InvokeMonitor(const std::string& name, std::unique_ptr<Event> event)
+{
+    // No-op for production.
+}
+
+void ActorRuntime::InvokeMonitor(const std::type_info& type, std::unique_ptr<Event> event)
+{
+    // No-op for production.
+}
+
+void ActorRuntime::InvokeMonitors(std::unique_ptr<Event> event)
 {
     // No-op for production.
 }
@@ -42,6 +84,11 @@ void ActorRuntime::InitializeActor(Actor* actor, std::string name)
 {
     std::unique_ptr<const ActorId> id(new ActorId(name, *this));
     Log("<CreateLog> Actor '" + id->m_name + "' is created.");
+    if (m_recorder != nullptr)
+    {
+        m_recorder->Add(EventTraceRecorder::RecordType::CreateActor, CurrentActor, id->m_value, 0);
+    }
+
     m_actorMap[id->m_value] = std::unique_ptr<Actor>(actor);
     actor->SetActorId(move(id));
 }
@@ -50,6 +97,11 @@ void ActorRuntime::InitializeMachine(Machine* machine, std::string name)
 {
     std::unique_ptr<const ActorId> id(new ActorId(name, *this));
     Log("<CreateLog> Machine '" + id->m_name + "' is created.");
+    if (m_recorder != nullptr)
+    {
+        m_recorder->Add(EventTraceRecorder::RecordType::CreateActor, CurrentActor, id->m_value, 0);
+    }
+
     m_actorMap[id->m_value] = std::unique_ptr<Actor>(machine);
     machine->SetActorId(move(id));
     machine->Initialize();
@@ -75,13 +127,122 @@ void ActorRuntime::SendEvent(const ActorId& target, std::unique_ptr<Event> event
     }
 
     bool runNewHandler = false;
+    CurrentEnqueue = { m_recorder != nullptr, EventTraceRecorder::RecordType::SendEvent,
+        sender != nullptr ? sender->m_value : -1 };
     EnqueueEvent(*actor, std::move(event), runNewHandler);
+    CurrentEnqueue.IsActive = false;
     if (runNewHandler)
     {
         RunEventHandler(*actor, nullptr, false);
     }
 }
 
+bool ActorRuntime::GetNondeterministicBooleanChoice(Actor& actor, int maxValue)
+{
+    std::uniform_int_distribution<int> dis(0, std::max(maxValue, 2) - 1);
+    bool choice = dis(GetGenerator()) == 0;
+    if (m_recorder != nullptr)
+    {
+        m_recorder->Add(EventTraceRecorder::RecordType::BooleanChoice, actor.m_id->m_value, -1, choice ? 1 : 0);
+    }
+
+    return choice;
+}
+
+int ActorRuntime::GetNondeterministicIntegerChoice(Actor& actor, int maxValue)
+{
+    std::uniform_int_distribution<int> dis(0, std::max(maxValue, 1) - 1);
+    int choice = dis(GetGenerator());
+    if (m_recorder != nullptr)
+    {
+        m_recorder->Add(EventTraceRecorder::RecordType::IntegerChoice, actor.m_id->m_value, -1, choice);
+    }
+
+    return choice;
+}
+
+std::chrono::milliseconds ActorRuntime::GetTime()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_startTime);
+}
+
+long ActorRuntime::StartTimer(Actor& actor, std::chrono::milliseconds dueTime, std::unique_ptr<Event> event)
+{
+    std::lock_guard<std::mutex> lock(m_timerLock);
+    long id = ++m_lastTimerId;
+    Log("<TimerLog> '" + actor.m_id->m_name + "' started timer " + std::to_string(id) + " for event '" +
+        event->m_name + "' due in " + std::to_string(dueTime.count()) + " ms.");
+    m_timers.emplace(std::chrono::steady_clock::now() + dueTime, Timer{ id, &actor, std::move(event) });
+    if (!m_timerThread.joinable())
+    {
+        m_timerThread = std::thread(&ActorRuntime::RunTimers, this);
+    }
+
+    m_timersChanged.notify_one();
+    return id;
+}
+
+void ActorRuntime::StopTimer(long timer)
+{
+    std::lock_guard<std::mutex> lock(m_timerLock);
+    for (auto it = m_timers.begin(); it != m_timers.end(); ++it)
+    {
+        if (it->second.Id == timer)
+        {
+            m_timers.erase(it);
+            return;
+        }
+    }
+}
+
+void ActorRuntime::RunTimers()
+{
+    std::unique_lock<std::mutex> lock(m_timerLock);
+    while (!m_isDisposed)
+    {
+        if (m_timers.empty())
+        {
+            m_timersChanged.wait(lock);
+            continue;
+        }
+
+        auto next = m_timers.begin();
+        if (std::chrono::steady_clock::now() < next->first)
+        {
+            m_timersChanged.wait_until(lock, next->first);
+            continue;
+        }
+
+        long id = next->second.Id;
+        auto target = next->second.Target;
+        auto event = std::move(next->second.Payload);
+        m_timers.erase(next);
+
+        // The event is delivered without the lock, as the handler may start timers.
+        lock.unlock();
+        Log("<TimerLog> Timer " + std::to_string(id) + " sent event '" + event->m_name + "' to '" +
+            target->m_id->m_name + "'.");
+        bool runNewHandler = false;
+        CurrentEnqueue = { m_recorder != nullptr, EventTraceRecorder::RecordType::FireTimer, -1 };
+        EnqueueEvent(*target, std::move(event), runNewHandler);
+        CurrentEnqueue.IsActive = false;
+        if (runNewHandler)
+        {
+            RunEventHandler(*target, nullptr, false);
+        }
+
+        lock.lock();
+    }
+}
+
+void ActorRuntime::FlushEventTrace()
+{
+    if (m_recorder != nullptr && !m_recorder->Flush())
+    {
+        Log("<ErrorLog> Failed to write event trace '" + Config->EventTraceFile + "'.");
+    }
+}
+
 inline
 void ActorRuntime::EnqueueEvent(Actor& target, std::unique_ptr<Event> event, bool& runNewHandler)
 {
@@ -90,16 +251,31 @@ void ActorRuntime::EnqueueEvent(Actor& target, std::unique_ptr<Event> event, boo
 
 void ActorRuntime::RunEventHandler(Actor& actor, std::unique_ptr<Event> event, bool isFresh)
 {
-    auto task = std::async(std::launch::async, [](Actor& actor, std::unique_ptr<Event> event, bool isFresh)
+    auto task = std::async(std::launch::async, [this](Actor& actor, std::unique_ptr<Event> event, bool isFresh)
     {
-        if (isFresh)
+        CurrentActor = actor.m_id->m_value;
+        try
         {
-            actor.Start(move(event));
+            if (isFresh)
+            {
+                actor.Start(move(event));
+            }
+
+            actor.RunEventHandler();
+        }
+        catch (...)
+        {
+            // The program may not outlive a failed handler, so the trace that
+            // led to the failure is written before the failure propagates.
+            FlushEventTrace();
+            CurrentActor = -1;
+            throw;
         }
 
-        actor.RunEventHandler();
+        CurrentActor = -1;
     }, std::ref(actor), std::move(event), isFresh);
 
+    std::lock_guard<std::mutex> lock(m_taskLock);
     m_actorTasks.emplace_back(std::move(task));
 }
 
@@ -152,4 +328,57 @@ void ActorRuntime::NotifyPoppedState(Machine& machine)
     Log("<PopLog> '" + machine.m_id->m_name + "' popped state '" + machine.GetCurrentState() + "'.");
 }
 
-ActorRuntime::~ActorRuntime() { }
+void ActorRuntime::NotifyEnqueuedEvent(Actor& actor, Event& event)
+{
+    Runtime::NotifyEnqueuedEvent(actor, event);
+
+    // Called with the inbox locked, so the sequence of the record follows the
+    // order in which the inbox receives events. The start event of an actor
+    // is recorded with its creation.
+    if (CurrentEnqueue.IsActive)
+    {
+        m_recorder->Add(CurrentEnqueue.Type, CurrentEnqueue.Actor, actor.m_id->m_value,
+            EventTraceRecorder::HashName(event.m_name));
+    }
+}
+
+ActorRuntime::~ActorRuntime()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_timerLock);
+        m_isDisposed = true;
+        m_timersChanged.notify_one();
+    }
+
+    if (m_timerThread.joinable())
+    {
+        m_timerThread.join();
+    }
+
+    if (m_recorder != nullptr)
+    {
+        // The handlers must stop recording before the rest of the trace is
+        // written, and may start new handlers until they do.
+        for (std::vector<std::future<void>> tasks;;)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_taskLock);
+                tasks.swap(m_actorTasks);
+            }
+
+            if (tasks.empty())
+            {
+                break;
+            }
+
+            for (auto& task : tasks)
+            {
+                task.wait();
+            }
+
+            tasks.clear();
+        }
+
+        FlushEventTrace();
+    }
+}
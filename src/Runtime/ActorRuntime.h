@@ -15,10 +15,16 @@
 #ifndef MICROSOFT_P3_RUNTIME_ACTORRUNTIME_H
 #define MICROSOFT_P3_RUNTIME_ACTORRUNTIME_H
 
+#include "EventTraceRecorder.h"
 #include "P3/Runtime.h"
+#include <chrono>
+#include <condition_variable>
 #include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -34,7 +40,10 @@ namespace Microsoft { namespace P3
         ~ActorRuntime();
 
         // Invokes the monitor with the specified name.
-        void InvokeMonitor(std::string name, std::unique_ptr<Event> event);
+        void InvokeMonitor(const std::string& name, std::unique_ptr<Event> event);
+
+        // Invokes every monitor that handles the event in any of its states.
+        void InvokeMonitors(std::unique_ptr<Event> event);
 
         // Checks if the assertion holds, and if not it throws an exception.
         void Assert(bool predicate, const std::string& message);
@@ -55,9 +64,28 @@ namespace Microsoft { namespace P3
         // Initializes the specified monitor.
         void InitializeMonitor(Monitor* monitor, std::string name);
 
+        // Invokes the monitor of the specified type.
+        void InvokeMonitor(const std::type_info& type, std::unique_ptr<Event> event);
+
         // Sends an asynchronous event to the specified actor.
         void SendEvent(const ActorId& target, std::unique_ptr<Event> event, const ActorId* sender);
 
+        // Returns a nondeterministic boolean choice for the specified actor.
+        bool GetNondeterministicBooleanChoice(Actor& actor, int maxValue);
+
+        // Returns a nondeterministic integer choice for the specified actor.
+        int GetNondeterministicIntegerChoice(Actor& actor, int maxValue);
+
+        // Returns the time elapsed since the runtime started.
+        std::chrono::milliseconds GetTime();
+
+        // Starts a timer that sends the specified event to the actor once
+        // the due time has elapsed, and returns its id.
+        long StartTimer(Actor& actor, std::chrono::milliseconds dueTime, std::unique_ptr<Event> event);
+
+        // Stops the timer with the specified id, if it has not fired yet.
+        void StopTimer(long timer);
+
         // Runs a new asynchronous event handler for the specified actor.
         void RunEventHandler(Actor& actor, std::unique_ptr<Event> event, bool isFresh);
 
@@ -76,16 +104,56 @@ namespace Microsoft { namespace P3
         // Notifies that a machine popped its state.
         void NotifyPoppedState(Machine& machine);
 
+        // Notifies that an actor enqueued an event into its inbox.
+        void NotifyEnqueuedEvent(Actor& actor, Event& event);
+
     private:
         // Map from unique ids to actor.
         std::unordered_map<long, std::unique_ptr<Actor>> m_actorMap;
 
-        // Spawned actor tasks.
+        // Spawned actor tasks, which handlers of any actor add to.
         std::vector<std::future<void>> m_actorTasks;
+        std::mutex m_taskLock;
+
+        // A pending timer.
+        struct Timer
+        {
+            long Id;
+            Actor* Target;
+            std::unique_ptr<Event> Payload;
+        };
+
+        // Time at which the runtime started.
+        std::chrono::steady_clock::time_point m_startTime;
+
+        // Pending timers, ordered by due time.
+        std::multimap<std::chrono::steady_clock::time_point, Timer> m_timers;
+
+        // Id of the last started timer.
+        long m_lastTimerId;
+
+        // Thread that fires the timers, which is started with the first timer.
+        std::thread m_timerThread;
+
+        // Set when the runtime is disposed.
+        bool m_isDisposed;
+
+        // Recorder of the event trace, if it is configured.
+        std::unique_ptr<EventTraceRecorder> m_recorder;
+
+        // Protects the timers, and signals when they change.
+        std::mutex m_timerLock;
+        std::condition_variable m_timersChanged;
+
+        // Fires the timers once they are due, until the runtime is disposed.
+        void RunTimers();
 
         // Enqueues an asynchronous event to the target actor.
         void EnqueueEvent(Actor& target, std::unique_ptr<Event> event, bool& runNewHandler);
 
+        // Writes the buffered records of the event trace, if it is configured.
+        void FlushEventTrace();
+
         // Copy is disabled.
         ActorRuntime(const ActorRuntime& that) = delete;
         ActorRuntime &operator=(ActorRuntime const &) = delete;
@@ -14,85 +14,321 @@
 
 #include "BugFindingRuntime.h"
 #include "../Exceptions/ExecutionCanceledException.h"
+#include "../TestingServices/Coverage/CoverageInfo.h"
 #include "../TestingServices/Scheduling/BugFindingScheduler.h"
 #include "P3/Actor.h"
 #include "P3/Machine.h"
 #include "P3/ActorId.h"
 #include "P3/Runtime/AssertionFailureException.h"
 #include "P3/Event.h"
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <typeinfo>
 
 using namespace Microsoft::P3;
 using namespace TestingServices;
 
+// Faults of the simulated network, in the order of the strategy choice.
+enum class NetworkFault
+{
+    Delay = 0,
+    Drop,
+    Duplicate,
+    Crash,
+    Count
+};
+
+// A randomized strategy faults a send between nodes with probability
+// 1/NetworkFaultOdds, so that most sends are delivered as usual.
+static const int NetworkFaultOdds = 4;
+
+// Maximum delay, in milliseconds, of a delayed network event.
+static const int MaxNetworkDelay = 100;
+
+// Name of the unused fields of a log record.
+static const std::string EmptyName;
+
 // Creates a new runtime.
 BugFindingRuntime::BugFindingRuntime(std::unique_ptr<Configuration> configuration, IExplorationStrategy* strategy)
-    : Runtime(move(configuration))
+    : Runtime(move(configuration)),
+      m_clock(std::bind(&BugFindingRuntime::FireTimer, this, std::placeholders::_1, std::placeholders::_2)),
+      m_log(Config->LogBufferSize > 0 ? Config->LogBufferSize : 0)
 {
-    std::unique_ptr<BugFindingScheduler> scheduler(new BugFindingScheduler(Config.get(), strategy));
+    BugFindingScheduler::StateHasher hasher;
+    if (Config->EnableStateHashing)
+    {
+        hasher = std::bind(&BugFindingRuntime::GetStateFingerprint, this);
+    }
+
+    std::unique_ptr<BugFindingScheduler> scheduler(new BugFindingScheduler(Config.get(), strategy, &m_clock, hasher));
     m_scheduler = move(scheduler);
+    m_numOfCreatedActors = 0;
+    m_numOfSentEvents = 0;
+    m_coverage = nullptr;
+    m_numOfNetworkFaults = 0;
+    m_firstActorId = 0;
+    m_hasHandledEvent = false;
+}
+
+void BugFindingRuntime::RunTest(const std::function<void(Runtime&)>& test)
+{
+    IterationArena::Scope scope(m_arena);
+    test(*this);
 }
 
 void BugFindingRuntime::Wait()
 {
+    if (Config->EnableSingleThreadMode)
+    {
+        RunInlineProcesses();
+    }
+
     m_scheduler->Wait();
-    for (auto& task : m_actorTasks)
+    if (m_scheduler->IsHung)
+    {
+        // The blocked process never returns its worker.
+        return;
+    }
+
+    m_workers.WaitForIdle();
+    if (m_scheduler->HasFullyExploredSchedule && !m_scheduler->BugFound)
+    {
+        CheckForDeadlock();
+    }
+}
+
+void BugFindingRuntime::Reset()
+{
+    m_clock.Reset();
+    m_log.Clear();
+    m_fingerprint.Clear();
+    m_changedActors.clear();
+    m_changedMonitors.clear();
+    m_handlerSteps.clear();
+    m_actorMap.clear();
+    m_crashedActors.clear();
+    m_inlineProcesses.clear();
+    m_monitors.clear();
+    m_monitorsByName.clear();
+    m_monitorsByType.clear();
+    m_observers.clear();
+    m_exitedStates.clear();
+    m_placements.clear();
+    m_nodes.clear();
+    m_numOfCreatedActors = 0;
+    m_numOfSentEvents = 0;
+    m_numOfNetworkFaults = 0;
+    m_scheduler->Reset();
+    m_arena.Release();
+    ResetIdCounter();
+}
+
+void BugFindingRuntime::WriteLog(std::ostream& stream) const
+{
+    m_log.Write(stream);
+}
+
+void BugFindingRuntime::Log(const std::string& message)
+{
+    Trace(LogBuffer::RecordType::Message, EmptyName, message);
+}
+
+void BugFindingRuntime::Log(std::ostringstream& stream)
+{
+    Trace(LogBuffer::RecordType::Message, EmptyName, stream.str());
+}
+
+inline
+void BugFindingRuntime::Trace(LogBuffer::RecordType type, const std::string& actor, const std::string& name,
+    const std::string& target, long long value, long long time)
+{
+    m_log.Add(type, actor, name, target, value, time);
+    if (Config->Verbosity)
     {
-        task.wait();
+        LogBuffer::Record record = { type, actor, name, target, value, time };
+        LogBuffer::Format(record, std::cout);
+        std::cout << std::endl;
     }
 }
 
 void BugFindingRuntime::InitializeActor(Actor* actor, std::string name)
 {
-    // Insert a scheduling point.
-    m_scheduler->Schedule();
+    // No scheduling point is needed, as no other actor knows the new one yet,
+    // and it runs its handlers as a process of its own.
 
     // Create a new unique id.
     std::unique_ptr<const ActorId> id(new ActorId(name, *this));
-    Log("<CreateLog> Actor '" + id->m_name + "' is created.");
+    Trace(LogBuffer::RecordType::CreateActor, id->m_name);
+    if (m_actorMap.empty())
+    {
+        m_firstActorId = id->m_value;
+    }
+
+    NotifyOperation(EventTraceRecorder::RecordType::CreateActor, m_scheduler->GetScheduledProcessId(),
+        id->m_value, nullptr);
+
+    if (Config->EnableStateHashing)
+    {
+        m_changedActors.push_back(actor);
+    }
+
     m_actorMap[id->m_value] = std::unique_ptr<Actor>(actor);
+    m_numOfCreatedActors.fetch_add(1, std::memory_order_relaxed);
     actor->SetActorId(std::move(id));
 }
 
 void BugFindingRuntime::InitializeMachine(Machine* machine, std::string name)
 {
-    // Insert a scheduling point.
-    m_scheduler->Schedule();
+    // No scheduling point is needed, as no other actor knows the new one yet,
+    // and it runs its handlers as a process of its own.
 
     // Create a new unique id.
     std::unique_ptr<const ActorId> id(new ActorId(name, *this));
-    Log("<CreateLog> Machine '" + id->m_name + "' is created.");
+    Trace(LogBuffer::RecordType::CreateMachine, id->m_name);
+    if (m_actorMap.empty())
+    {
+        m_firstActorId = id->m_value;
+    }
+
+    NotifyOperation(EventTraceRecorder::RecordType::CreateActor, m_scheduler->GetScheduledProcessId(),
+        id->m_value, nullptr);
+
+    if (Config->EnableStateHashing)
+    {
+        m_changedActors.push_back(machine);
+    }
+
     m_actorMap[id->m_value] = std::unique_ptr<Actor>(machine);
+    m_numOfCreatedActors.fetch_add(1, std::memory_order_relaxed);
     machine->SetActorId(std::move(id));
     machine->Initialize();
+
+    auto coverage = m_coverage.load();
+    if (coverage != nullptr && !coverage->IsDeclared(typeid(*machine)))
+    {
+        // Declare the states and events of the machine type, the first time it is created.
+        for (auto& entry : machine->m_states)
+        {
+            auto state = entry.second.get();
+            coverage->DeclareState(typeid(*machine), false, state->m_name);
+            for (auto& transition : state->m_gotoTransitions)
+            {
+                coverage->DeclareEvent(typeid(*machine), state->m_name, transition.first);
+            }
+
+            for (auto& transition : state->m_pushTransitions)
+            {
+                coverage->DeclareEvent(typeid(*machine), state->m_name, transition.first);
+            }
+
+            for (auto& binding : state->m_actionBindings)
+            {
+                coverage->DeclareEvent(typeid(*machine), state->m_name, binding.first);
+            }
+        }
+    }
 }
 
 void BugFindingRuntime::InitializeMonitor(Monitor* monitor, std::string name)
 {
-    Log("<MonitorLog> Monitor '" + name + "' is registered.");
-    std::unique_ptr<Monitor> mptr(monitor);
-    m_monitors.insert(move(mptr));
+    Trace(LogBuffer::RecordType::RegisterMonitor, name);
+    m_monitors.emplace_back(monitor);
+    Assert(m_monitorsByName.emplace(name, monitor).second, "Monitor '" + name + "' is already registered.");
+    auto byType = m_monitorsByType.emplace(typeid(*monitor), monitor);
+    if (!byType.second)
+    {
+        byType.first->second = nullptr;
+    }
+
+    if (Config->EnableStateHashing)
+    {
+        m_changedMonitors.push_back(monitor);
+    }
+
     monitor->Setup(name, *this);
+    m_scheduler->GetLivenessChecker().RegisterMonitor(monitor, name);
     monitor->Initialize();
+
+    // Index the monitor by the events that it handles in any of its states.
+    for (auto& entry : monitor->m_states)
+    {
+        auto state = entry.second.get();
+        for (auto& transition : state->m_gotoTransitions)
+        {
+            auto& observers = m_observers[transition.first];
+            if (observers.empty() || observers.back() != monitor)
+            {
+                observers.push_back(monitor);
+            }
+        }
+
+        for (auto& binding : state->m_actionBindings)
+        {
+            auto& observers = m_observers[binding.first];
+            if (observers.empty() || observers.back() != monitor)
+            {
+                observers.push_back(monitor);
+            }
+        }
+    }
+
+    auto coverage = m_coverage.load();
+    if (coverage != nullptr && !coverage->IsDeclared(typeid(*monitor)))
+    {
+        // Declare the states and events of the monitor type, the first time it is registered.
+        for (auto& entry : monitor->m_states)
+        {
+            auto state = entry.second.get();
+            coverage->DeclareState(typeid(*monitor), true, state->m_name);
+            for (auto& transition : state->m_gotoTransitions)
+            {
+                coverage->DeclareEvent(typeid(*monitor), state->m_name, transition.first);
+            }
+
+            for (auto& binding : state->m_actionBindings)
+            {
+                coverage->DeclareEvent(typeid(*monitor), state->m_name, binding.first);
+            }
+        }
+    }
+
     monitor->GotoStartState(nullptr);
 }
 
 void BugFindingRuntime::SendEvent(const ActorId& target, std::unique_ptr<Event> event, const ActorId* sender)
 {
-    // Insert a scheduling point.
-    m_scheduler->Schedule();
+    if (!Config->ScheduleOnlyAtReceives && !Config->EnableSingleThreadMode)
+    {
+        // Insert a scheduling point.
+        m_scheduler->Schedule();
+    }
 
     auto actor = m_actorMap[target.m_value].get();
+    m_numOfSentEvents.fetch_add(1, std::memory_order_relaxed);
 
     if (sender != nullptr)
     {
-        Log("<SendLog> '" + sender->m_name + "' sent event '" + event->m_name + "' to '" + target.m_name + "'.");
+        Trace(LogBuffer::RecordType::Send, sender->m_name, event->m_name, target.m_name);
     }
     else
     {
-        Log("<SendLog> Event '" + event->m_name + "' was sent to '" + target.m_name + "'.");
+        Trace(LogBuffer::RecordType::SendExternal, EmptyName, event->m_name, target.m_name);
+    }
+
+    NotifyOperation(EventTraceRecorder::RecordType::SendEvent, sender != nullptr ? sender->m_value : -1,
+        target.m_value, event.get());
+
+    if (sender != nullptr && m_numOfNetworkFaults < Config->MaxNetworkFaults)
+    {
+        int node = m_nodes[target.m_value];
+        if (m_nodes[sender->m_value] != node && InjectNetworkFault(*actor, node, event))
+        {
+            return;
+        }
     }
 
     bool runNewHandler = false;
@@ -103,20 +339,386 @@ void BugFindingRuntime::SendEvent(const ActorId& target, std::unique_ptr<Event>
     }
 }
 
-void BugFindingRuntime::InvokeMonitor(std::string name, std::unique_ptr<Event> event)
+void BugFindingRuntime::PlaceOnNode(Actor& actor, int node, ActorFactory factory)
+{
+    if (node < 0)
+    {
+        auto creator = m_nodes.find(m_scheduler->GetScheduledProcessId());
+        node = creator != m_nodes.end() ? creator->second : 0;
+    }
+
+    m_placements.push_back({ actor.m_id->m_value, node, factory });
+    m_nodes[actor.m_id->m_value] = node;
+}
+
+bool BugFindingRuntime::InjectNetworkFault(Actor& target, int node, std::unique_ptr<Event>& event)
+{
+    // Whether to fault the send is a biased choice of its own, and only
+    // then the strategy picks the fault.
+    if (!m_scheduler->GetNextNondeterministicBooleanChoice(NetworkFaultOdds))
+    {
+        return false;
+    }
+
+    auto fault = static_cast<NetworkFault>(m_scheduler->GetNextNondeterministicIntegerChoice(
+        static_cast<int>(NetworkFault::Count)));
+
+    auto& name = target.m_id->m_name;
+    if (fault == NetworkFault::Delay)
+    {
+        // The delayed event is delivered by the clock, after the events
+        // that the strategy delivers meanwhile.
+        m_numOfNetworkFaults++;
+        int delay = m_scheduler->GetNextNondeterministicIntegerChoice(MaxNetworkDelay) + 1;
+        Trace(LogBuffer::RecordType::NetworkDelay, EmptyName, event->m_name, name, 0, delay);
+        m_clock.StartTimer(target, std::chrono::milliseconds(delay), std::move(event));
+        return true;
+    }
+    else if (fault == NetworkFault::Drop)
+    {
+        m_numOfNetworkFaults++;
+        Trace(LogBuffer::RecordType::NetworkDrop, EmptyName, event->m_name, name);
+        event.reset();
+        return true;
+    }
+    else if (fault == NetworkFault::Duplicate)
+    {
+        auto copy = event->Clone();
+        if (copy != nullptr)
+        {
+            m_numOfNetworkFaults++;
+            Trace(LogBuffer::RecordType::NetworkDuplicate, EmptyName, event->m_name, name);
+            m_clock.StartTimer(target, std::chrono::milliseconds(0), std::move(copy));
+        }
+
+        return false;
+    }
+
+    m_numOfNetworkFaults++;
+    Trace(LogBuffer::RecordType::NetworkCrash, EmptyName, event->m_name, name, node);
+    event.reset();
+    RestartNode(node);
+    return true;
+}
+
+void BugFindingRuntime::RestartNode(int node)
+{
+    // Actors that are created while restarting are placed at the end.
+    size_t count = m_placements.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        auto placement = m_placements[i];
+        if (placement.Node != node)
+        {
+            continue;
+        }
+
+        // The crashed actor loses its state and its pending events.
+        auto& entry = m_actorMap[placement.Id];
+        {
+            std::lock_guard<std::mutex> lock(entry->m_inboxLock);
+            entry->m_isHalted = true;
+            entry->m_inbox.clear();
+        }
+
+        m_scheduler->NotifyProcessCrashed(placement.Id);
+        if (Config->EnableStateHashing)
+        {
+            auto crashed = entry.get();
+            m_fingerprint.Remove(crashed);
+            m_changedActors.erase(std::remove(m_changedActors.begin(), m_changedActors.end(), crashed),
+                m_changedActors.end());
+            m_handlerSteps.erase(crashed);
+        }
+
+        auto id = std::move(entry->m_id);
+        m_crashedActors.push_back(std::move(entry));
+
+        // The restarted actor keeps the id, so that other actors can still send it events.
+        auto actor = placement.Factory();
+        Trace(LogBuffer::RecordType::NetworkRestart, id->m_name, EmptyName, EmptyName, node);
+        actor->SetActorId(std::move(id));
+        entry.reset(actor);
+        if (Config->EnableStateHashing)
+        {
+            m_changedActors.push_back(actor);
+        }
+
+        if (auto machine = dynamic_cast<Machine*>(actor))
+        {
+            machine->Initialize();
+        }
+
+        RunEventHandler(*actor, nullptr, true);
+    }
+}
+
+void BugFindingRuntime::InvokeMonitor(const std::string& name, std::unique_ptr<Event> event)
+{
+    auto monitor = m_monitorsByName.find(name);
+    if (monitor == m_monitorsByName.end())
+    {
+        Assert(false, "<MonitorLog> Invoking unregistered monitor '" + name + "'.");
+        return;
+    }
+
+    DeliverToMonitor(*monitor->second, std::move(event));
+}
+
+void BugFindingRuntime::InvokeMonitor(const std::type_info& type, std::unique_ptr<Event> event)
 {
-    Log("<MonitorLog> Monitor '" + name + "' invoked with event '" + event->m_name + "'.");
+    auto monitor = m_monitorsByType.find(type);
+    if (monitor == m_monitorsByType.end())
+    {
+        Assert(false, "<MonitorLog> Invoking unregistered monitor of type '" + std::string(type.name()) + "'.");
+        return;
+    }
 
-    for (auto& monitor : m_monitors)
+    if (monitor->second == nullptr)
+    {
+        Assert(false, "<MonitorLog> Invoking monitor of type '" + std::string(type.name()) +
+            "', which is registered more than once.");
+        return;
+    }
+
+    DeliverToMonitor(*monitor->second, std::move(event));
+}
+
+void BugFindingRuntime::InvokeMonitors(std::unique_ptr<Event> event)
+{
+    auto observers = m_observers.find(event->m_name);
+    if (observers == m_observers.end())
     {
-        if (monitor->m_name == name)
+        return;
+    }
+
+    // Every observer but the last receives its own copy of the event.
+    auto& monitors = observers->second;
+    for (size_t i = 0; i + 1 < monitors.size(); i++)
+    {
+        auto copy = event->Clone();
+        if (copy == nullptr)
         {
-            monitor->HandleEvent(std::move(event));
+            Assert(false, "<MonitorLog> Event '" + event->m_name +
+                "' is handled by more than one monitor, but cannot be copied.");
             return;
         }
+
+        DeliverToMonitor(*monitors[i], std::move(copy));
     }
 
-    Assert(false, "<MonitorLog> Invoking unregistered monitor '" + name + "'.");
+    DeliverToMonitor(*monitors.back(), std::move(event));
+}
+
+void BugFindingRuntime::DeliverToMonitor(Monitor& monitor, std::unique_ptr<Event> event)
+{
+    Trace(LogBuffer::RecordType::InvokeMonitor, monitor.m_name, event->m_name);
+    auto coverage = m_coverage.load();
+    if (coverage != nullptr)
+    {
+        coverage->AddEvent(typeid(monitor), monitor.m_currentState->m_name, event->m_name);
+    }
+
+    if (Config->EnableStateHashing)
+    {
+        m_changedMonitors.push_back(&monitor);
+    }
+
+    monitor.HandleEvent(std::move(event));
+}
+
+bool BugFindingRuntime::GetNondeterministicBooleanChoice(Actor& actor, int maxValue)
+{
+    auto choice = m_scheduler->GetNextNondeterministicBooleanChoice(maxValue);
+    Trace(LogBuffer::RecordType::RandomBoolean, actor.m_id->m_name, EmptyName, EmptyName, choice ? 1 : 0);
+    return choice;
+}
+
+int BugFindingRuntime::GetNondeterministicIntegerChoice(Actor& actor, int maxValue)
+{
+    auto choice = m_scheduler->GetNextNondeterministicIntegerChoice(maxValue);
+    Trace(LogBuffer::RecordType::RandomInteger, actor.m_id->m_name, EmptyName, EmptyName, choice);
+    return choice;
+}
+
+std::chrono::milliseconds BugFindingRuntime::GetTime()
+{
+    return m_clock.Now();
+}
+
+long BugFindingRuntime::StartTimer(Actor& actor, std::chrono::milliseconds dueTime, std::unique_ptr<Event> event)
+{
+    // The clock owns the event until the timer fires, so its name outlives the call.
+    auto& name = event->m_name;
+    long id = m_clock.StartTimer(actor, dueTime, std::move(event));
+    Trace(LogBuffer::RecordType::StartTimer, actor.m_id->m_name, name, EmptyName, id, dueTime.count());
+    return id;
+}
+
+void BugFindingRuntime::StopTimer(long timer)
+{
+    m_clock.StopTimer(timer);
+}
+
+uint64_t BugFindingRuntime::GetStateFingerprint()
+{
+    // Besides the inboxes and monitors that are recorded as they change, only
+    // the actor that ran since the last step could change its own state, and
+    // it reached one more scheduling point of its handler.
+    auto scheduled = m_actorMap.find(m_scheduler->GetScheduledProcessId());
+    if (scheduled != m_actorMap.end())
+    {
+        m_handlerSteps[scheduled->second.get()]++;
+        m_changedActors.push_back(scheduled->second.get());
+    }
+
+    for (auto actor : m_changedActors)
+    {
+        m_fingerprint.Update(actor, HashState(*actor));
+    }
+
+    for (auto monitor : m_changedMonitors)
+    {
+        m_fingerprint.Update(monitor, HashState(*monitor));
+    }
+
+    m_changedActors.clear();
+    m_changedMonitors.clear();
+
+    // Pending timers are few, and they are hashed in firing order, with the
+    // time left until they are due, so that the same timers started at
+    // different times are the same state.
+    uint64_t fingerprint = m_fingerprint.Get();
+    m_clock.VisitPendingTimers([this, &fingerprint](Actor& actor, Event& event, std::chrono::milliseconds timeLeft)
+    {
+        fingerprint = StateFingerprint::Combine(fingerprint, actor.m_id->m_value - m_firstActorId);
+        fingerprint = StateFingerprint::Combine(fingerprint, StateFingerprint::Hash(event.m_name));
+        fingerprint = StateFingerprint::Combine(fingerprint, event.HashState());
+        fingerprint = StateFingerprint::Combine(fingerprint, timeLeft.count());
+    });
+
+    auto coverage = m_coverage.load();
+    if (coverage != nullptr)
+    {
+        coverage->AddProgramState(fingerprint);
+    }
+
+    return fingerprint;
+}
+
+uint64_t BugFindingRuntime::HashState(Actor& actor) const
+{
+    // An actor that is running has yet to handle its start or inbox events,
+    // and it resumes its handler after the scheduling point that it reached.
+    uint64_t hash = StateFingerprint::Combine(actor.m_id->m_value - m_firstActorId,
+        (actor.m_isHalted ? 2 : 0) | (actor.m_isRunning ? 1 : 0));
+    if (actor.m_isRunning)
+    {
+        auto steps = m_handlerSteps.find(&actor);
+        hash = StateFingerprint::Combine(hash, steps != m_handlerSteps.end() ? steps->second : 0);
+    }
+
+    if (auto machine = dynamic_cast<Machine*>(&actor))
+    {
+        for (auto state : machine->m_stateStack)
+        {
+            hash = StateFingerprint::Combine(hash, StateFingerprint::Hash(state->m_name));
+        }
+
+        hash = StateFingerprint::Combine(hash, machine->HashState());
+    }
+
+    for (auto& event : actor.m_inbox)
+    {
+        hash = StateFingerprint::Combine(hash, StateFingerprint::Hash(event->m_name));
+        hash = StateFingerprint::Combine(hash, event->HashState());
+    }
+
+    return hash;
+}
+
+uint64_t BugFindingRuntime::HashState(Monitor& monitor) const
+{
+    uint64_t hash = StateFingerprint::Hash(monitor.m_name);
+    if (monitor.m_currentState != nullptr)
+    {
+        hash = StateFingerprint::Combine(hash, StateFingerprint::Hash(monitor.m_currentState->m_name));
+    }
+
+    return StateFingerprint::Combine(hash, monitor.HashState());
+}
+
+void BugFindingRuntime::FireTimer(Actor& actor, std::unique_ptr<Event> event)
+{
+    if (actor.m_isHalted)
+    {
+        // The actor crashed with its node, and lost its timers.
+        return;
+    }
+
+    Trace(LogBuffer::RecordType::FireTimer, EmptyName, event->m_name, actor.m_id->m_name, 0,
+        m_clock.Now().count());
+    NotifyOperation(EventTraceRecorder::RecordType::FireTimer, -1, actor.m_id->m_value, event.get());
+    bool runNewHandler = false;
+    EnqueueEvent(actor, std::move(event), runNewHandler);
+    if (runNewHandler)
+    {
+        RunEventHandler(actor, nullptr, false);
+    }
+}
+
+inline
+void BugFindingRuntime::NotifyOperation(EventTraceRecorder::RecordType type, long actor, long target,
+    const Event* event)
+{
+    if (Config->Strategy == ExplorationStrategy::ProductionReplay)
+    {
+        // Actors are identified by their creation index, as in production.
+        m_scheduler->NotifyOperation(type, actor >= 0 ? actor - m_firstActorId : -1,
+            target - m_firstActorId, event != nullptr ? EventTraceRecorder::HashName(event->m_name) : 0);
+    }
+}
+
+void BugFindingRuntime::CheckForDeadlock()
+{
+    // Actors are reported in creation order.
+    std::map<long, Actor*> stuckActors;
+    for (auto& entry : m_actorMap)
+    {
+        auto actor = entry.second.get();
+        if (!actor->m_isHalted && !actor->m_inbox.empty())
+        {
+            stuckActors[entry.first] = actor;
+        }
+    }
+
+    if (stuckActors.empty())
+    {
+        return;
+    }
+
+    std::string report = "Deadlock detected:";
+    for (auto& entry : stuckActors)
+    {
+        auto actor = entry.second;
+        report += " '" + actor->m_id->m_name + "'";
+        if (auto machine = dynamic_cast<Machine*>(actor))
+        {
+            report += " in state '" + machine->GetCurrentState() + "'";
+        }
+
+        report += " waits with pending events";
+        for (auto& event : actor->m_inbox)
+        {
+            report += " '" + event->m_name + "'";
+        }
+
+        report += ";";
+    }
+
+    report.back() = '.';
+    Trace(LogBuffer::RecordType::Error, EmptyName, report);
+    m_scheduler->NotifyDeadlock(report);
 }
 
 inline
@@ -127,13 +729,27 @@ void BugFindingRuntime::EnqueueEvent(Actor& target, std::unique_ptr<Event> event
 
 void BugFindingRuntime::RunEventHandler(Actor& actor, std::unique_ptr<Event> event, bool isFresh)
 {
-    m_scheduler->NotifyProcessCreated(actor.m_id->m_value);
+    // The id is captured by value, as a crashed actor hands its id over to
+    // the restarted one.
+    long id = actor.m_id->m_value;
+    m_scheduler->NotifyProcessCreated(id);
+    if (Config->EnableSingleThreadMode)
+    {
+        // The process runs once the scheduler chooses it.
+        m_inlineProcesses[id] = { &actor, std::move(event), isFresh };
+        return;
+    }
 
-    auto task = async([this](Actor& actor, std::unique_ptr<Event> event, bool isFresh)
+    // The event is handed to the task through a raw pointer, as the task must be copyable.
+    auto eventPtr = event.release();
+    m_workers.Run([this, &actor, id, eventPtr, isFresh]()
     {
+        IterationArena::Scope scope(m_arena);
+        std::unique_ptr<Event> event(eventPtr);
         try
         {
-            m_scheduler->NotifyProcessStarted(actor.m_id->m_value);
+            m_scheduler->NotifyProcessStarted(id);
+            m_hasHandledEvent = false;
 
             if (isFresh)
             {
@@ -142,24 +758,59 @@ void BugFindingRuntime::RunEventHandler(Actor& actor, std::unique_ptr<Event> eve
 
             actor.RunEventHandler();
 
-            m_scheduler->NotifyProcessHalted(actor.m_id->m_value);
+            m_scheduler->NotifyProcessHalted(id);
         }
         catch (const ExecutionCanceledException&)
         {
             // Ignore this exception, as it is bening.
         }
-    }, std::ref(actor), std::move(event), isFresh);
+    });
 
-    m_actorTasks.emplace_back(std::move(task));
+    m_scheduler->WaitForProcessToStart(id);
+}
+
+void BugFindingRuntime::RunInlineProcesses()
+{
+    IterationArena::Scope scope(m_arena);
+    try
+    {
+        // The scheduler stops, and throws, once no process is enabled.
+        for (;;)
+        {
+            long id = m_scheduler->ScheduleNextHandler();
+            auto& process = m_inlineProcesses[id];
+            auto& actor = *(process.Target);
+
+            // A started machine already handled its initial event.
+            m_hasHandledEvent = false;
+            if (process.IsFresh)
+            {
+                process.IsFresh = false;
+                actor.Start(std::move(process.StartEvent));
+            }
+
+            if (!m_hasHandledEvent)
+            {
+                actor.HandleNextEvent();
+            }
 
-    m_scheduler->WaitForProcessToStart(actor.m_id->m_value);
+            if (!actor.HasNextEvent())
+            {
+                m_scheduler->NotifyProcessHalted(id);
+            }
+        }
+    }
+    catch (const ExecutionCanceledException&)
+    {
+        // Ignore this exception, as it is benign.
+    }
 }
 
 void BugFindingRuntime::Assert(bool predicate, const std::string& message)
 {
     if (!predicate)
     {
-        Log("<ErrorLog> " + message);
+        Trace(LogBuffer::RecordType::Error, EmptyName, message);
         m_scheduler->NotifyAssertionFailure(message);
     }
 }
@@ -169,7 +820,7 @@ void BugFindingRuntime::Assert(bool predicate, std::ostringstream& stream)
     if (!predicate)
     {
         auto message = stream.str();
-        Log("<ErrorLog> " + message);
+        Trace(LogBuffer::RecordType::Error, EmptyName, message);
         m_scheduler->NotifyAssertionFailure(message);
     }
 }
@@ -177,55 +828,148 @@ void BugFindingRuntime::Assert(bool predicate, std::ostringstream& stream)
 inline
 void BugFindingRuntime::NotifyEnteredState(Machine& machine)
 {
-    Log("<StateLog> '" + machine.m_id->m_name + "' enters state '" + machine.GetCurrentState() + "'.");
+    // A started machine handles its initial event on entry to its start state.
+    m_hasHandledEvent = true;
+    Trace(LogBuffer::RecordType::EnterState, machine.m_id->m_name, machine.m_stateStack.back()->m_name);
+    auto coverage = m_coverage.load();
+    if (coverage != nullptr)
+    {
+        auto& state = machine.m_stateStack.back()->m_name;
+        coverage->AddState(typeid(machine), state);
+
+        auto exited = m_exitedStates.find(&machine);
+        if (exited != m_exitedStates.end())
+        {
+            coverage->AddTransition(typeid(machine), *(exited->second), state);
+            m_exitedStates.erase(exited);
+        }
+    }
 }
 
 inline
 void BugFindingRuntime::NotifyEnteredState(Monitor& monitor)
 {
-    Log("<MonitorLog> '" + monitor.m_name + "' enters state '" + monitor.GetCurrentState() + "'.");
+    Trace(LogBuffer::RecordType::MonitorEnterState, monitor.m_name, monitor.m_currentState->m_name);
+    auto state = monitor.m_currentState;
+    m_scheduler->GetLivenessChecker().NotifyEnteredState(&monitor, state->m_name, state->m_isHot, state->m_isCold);
+    auto coverage = m_coverage.load();
+    if (coverage != nullptr)
+    {
+        coverage->AddState(typeid(monitor), state->m_name);
+
+        auto exited = m_exitedStates.find(&monitor);
+        if (exited != m_exitedStates.end())
+        {
+            coverage->AddTransition(typeid(monitor), *(exited->second), state->m_name);
+            m_exitedStates.erase(exited);
+        }
+    }
 }
 
 inline
 void BugFindingRuntime::NotifyExitedState(Machine& machine)
 {
-    Log("<StateLog> '" + machine.m_id->m_name + "' exits state '" + machine.GetCurrentState() + "'.");
+    Trace(LogBuffer::RecordType::ExitState, machine.m_id->m_name, machine.m_stateStack.back()->m_name);
+    auto coverage = m_coverage.load();
+    if (coverage != nullptr)
+    {
+        m_exitedStates[&machine] = &(machine.m_stateStack.back()->m_name);
+    }
 }
 
 inline
 void BugFindingRuntime::NotifyExitedState(Monitor& monitor)
 {
-    Log("<MonitorLog> '" + monitor.m_name + "' exits state '" + monitor.GetCurrentState() + "'.");
+    Trace(LogBuffer::RecordType::MonitorExitState, monitor.m_name, monitor.m_currentState->m_name);
+    auto coverage = m_coverage.load();
+    if (coverage != nullptr)
+    {
+        m_exitedStates[&monitor] = &(monitor.m_currentState->m_name);
+    }
 }
 
 inline
 void BugFindingRuntime::NotifyInvokedAction(Machine& machine)
 {
-    Log("<ActionLog> '" + machine.m_id->m_name + "' invoked an action.");
+    Trace(LogBuffer::RecordType::InvokeAction, machine.m_id->m_name);
 }
 
 inline
 void BugFindingRuntime::NotifyInvokedAction(Monitor& monitor)
 {
-    Log("<MonitorLog> '" + monitor.m_name + "' invoked an action.");
+    Trace(LogBuffer::RecordType::MonitorInvokeAction, monitor.m_name);
 }
 
 inline
 void BugFindingRuntime::NotifyRaisedEvent(Machine& machine, Event& event)
 {
-    Log("<RaiseLog> '" + machine.m_id->m_name + "' raised event '" + event.m_name + "'.");
+    Trace(LogBuffer::RecordType::RaiseEvent, machine.m_id->m_name, event.m_name);
 }
 
 inline
 void BugFindingRuntime::NotifyRaisedEvent(Monitor& monitor, Event& event)
 {
-    Log("<MonitorLog> '" + monitor.m_name + "' raised event '" + event.m_name + "'.");
+    Trace(LogBuffer::RecordType::MonitorRaiseEvent, monitor.m_name, event.m_name);
 }
 
 inline
 void BugFindingRuntime::NotifyPoppedState(Machine& machine)
 {
-    Log("<PopLog> '" + machine.m_id->m_name + "' popped state '" + machine.GetCurrentState() + "'.");
+    Trace(LogBuffer::RecordType::PopState, machine.m_id->m_name, machine.m_stateStack.back()->m_name);
+}
+
+void BugFindingRuntime::NotifyDequeuedEvent(Machine& machine, Event& event)
+{
+    auto coverage = m_coverage.load();
+    if (coverage != nullptr)
+    {
+        coverage->AddEvent(typeid(machine), machine.m_stateStack.back()->m_name, event.m_name);
+    }
+
+    ScheduleAtReceive();
+    ResetHandlerSteps(machine);
+}
+
+void BugFindingRuntime::NotifyDequeuedEvent(Actor& actor, Event& event)
+{
+    ScheduleAtReceive();
+    ResetHandlerSteps(actor);
+}
+
+inline
+void BugFindingRuntime::ResetHandlerSteps(Actor& actor)
+{
+    if (Config->EnableStateHashing)
+    {
+        m_handlerSteps[&actor] = 0;
+        m_changedActors.push_back(&actor);
+    }
+}
+
+inline
+void BugFindingRuntime::ScheduleAtReceive()
+{
+    // A process that was just scheduled has nothing to interleave with yet.
+    if (Config->ScheduleOnlyAtReceives && !Config->EnableSingleThreadMode && m_hasHandledEvent)
+    {
+        m_scheduler->Schedule();
+    }
+
+    m_hasHandledEvent = true;
+}
+
+void BugFindingRuntime::NotifyEnqueuedEvent(Actor& actor, Event& event)
+{
+    Trace(LogBuffer::RecordType::Enqueue, actor.m_id->m_name, event.m_name);
+    if (Config->EnableStateHashing)
+    {
+        m_changedActors.push_back(&actor);
+    }
+}
+
+void BugFindingRuntime::SetCoverage(CoverageInfo* coverage)
+{
+    m_coverage.store(coverage);
 }
 
 BugFindingScheduler* BugFindingRuntime::GetScheduler()
@@ -233,4 +977,24 @@ BugFindingScheduler* BugFindingRuntime::GetScheduler()
     return m_scheduler.get();
 }
 
+long long BugFindingRuntime::GetNumOfCreatedActors() const
+{
+    return m_numOfCreatedActors.load(std::memory_order_relaxed);
+}
+
+long long BugFindingRuntime::GetNumOfSentEvents() const
+{
+    return m_numOfSentEvents.load(std::memory_order_relaxed);
+}
+
+size_t BugFindingRuntime::GetNumOfWorkers()
+{
+    return m_workers.Size();
+}
+
+bool BugFindingRuntime::IsIdle()
+{
+    return m_workers.IsIdle();
+}
+
 BugFindingRuntime::~BugFindingRuntime() { }
@@ -15,14 +15,23 @@
 #ifndef MICROSOFT_P3_RUNTIME_BUGFINDINGRUNTIME_H
 #define MICROSOFT_P3_RUNTIME_BUGFINDINGRUNTIME_H
 
+#include "IterationArena.h"
+#include "LogBuffer.h"
+#include "WorkerPool.h"
+#include "../TestingServices/Coverage/StateFingerprint.h"
 #include "../TestingServices/Scheduling/BugFindingScheduler.h"
+#include "../TestingServices/Scheduling/VirtualClock.h"
 #include "../TestingServices/IExplorationStrategy.h"
 #include "P3/Configuration.h"
 #include "P3/Runtime.h"
-#include <future>
+#include <atomic>
+#include <functional>
 #include <memory>
-#include <set>
+#include <ostream>
 #include <sstream>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
 #include <unordered_map>
 #include <vector>
 
@@ -30,6 +39,11 @@ namespace Microsoft { namespace P3
 {
     class Event;
 
+    namespace TestingServices
+    {
+        class CoverageInfo;
+    }
+
     // Runtime for executing actors for testing.
     class BugFindingRuntime : public Runtime
     {
@@ -38,7 +52,18 @@ namespace Microsoft { namespace P3
         ~BugFindingRuntime();
         
         // Invokes the monitor with the specified name.
-        void InvokeMonitor(std::string name, std::unique_ptr<Event> event);
+        void InvokeMonitor(const std::string& name, std::unique_ptr<Event> event);
+
+        // Invokes every monitor that handles the event in any of its states.
+        void InvokeMonitors(std::unique_ptr<Event> event);
+
+        // Logs the specified message into the log buffer, and to the output
+        // if verbose.
+        void Log(const std::string& message);
+
+        // Logs the specified message into the log buffer, and to the output
+        // if verbose.
+        void Log(std::ostringstream& stream);
         
         // Checks if the assertion holds, and if not it throws an exception.
         void Assert(bool predicate, const std::string& message);
@@ -46,11 +71,38 @@ namespace Microsoft { namespace P3
         // Checks if the assertion holds, and if not it throws an exception.
         void Assert(bool predicate, std::ostringstream& stream);
 
+        // Runs the specified test, allocating its actors and events from
+        // the arena of the iteration.
+        void RunTest(const std::function<void(Runtime&)>& test);
+
         // Waits for the runtime to terminate execution.
         void Wait();
 
+        // Destroys all actors and monitors, and resets the runtime for a new
+        // iteration. Worker threads and allocated storage are kept.
+        void Reset();
+
         // Returns the bug-finding scheduler
         TestingServices::BugFindingScheduler* GetScheduler();
+
+        // Records activity coverage into the specified coverage info, or
+        // stops recording it if null.
+        void SetCoverage(TestingServices::CoverageInfo* coverage);
+
+        // Returns the number of actors created in this runtime.
+        long long GetNumOfCreatedActors() const;
+
+        // Returns the number of events sent in this runtime.
+        long long GetNumOfSentEvents() const;
+
+        // Returns the number of worker threads, which are kept across iterations.
+        size_t GetNumOfWorkers();
+
+        // Returns true if no process of this runtime is running.
+        bool IsIdle();
+
+        // Writes the log records that the current iteration kept in memory.
+        void WriteLog(std::ostream& stream) const;
         
     protected:
         // Initializes the specified actor.
@@ -62,9 +114,30 @@ namespace Microsoft { namespace P3
         // Initializes the specified monitor.
         void InitializeMonitor(Monitor* monitor, std::string name);
 
+        // Invokes the monitor of the specified type.
+        void InvokeMonitor(const std::type_info& type, std::unique_ptr<Event> event);
+
+        // Places the specified actor on a node of the simulated network.
+        void PlaceOnNode(Actor& actor, int node, ActorFactory factory);
+
         // Sends an asynchronous event to the specified machine.
         void SendEvent(const ActorId& target, std::unique_ptr<Event> event, const ActorId* sender);
 
+        // Returns a nondeterministic boolean choice for the specified actor.
+        bool GetNondeterministicBooleanChoice(Actor& actor, int maxValue);
+
+        // Returns a nondeterministic integer choice for the specified actor.
+        int GetNondeterministicIntegerChoice(Actor& actor, int maxValue);
+
+        // Returns the virtual time elapsed since the iteration started.
+        std::chrono::milliseconds GetTime();
+
+        // Starts a virtual timer, which fires when the scheduler chooses to.
+        long StartTimer(Actor& actor, std::chrono::milliseconds dueTime, std::unique_ptr<Event> event);
+
+        // Stops the timer with the specified id, if it has not fired yet.
+        void StopTimer(long timer);
+
         // Runs a new asynchronous event handler for the specified actor.
         void RunEventHandler(Actor& actor, std::unique_ptr<Event> event, bool isFresh);
 
@@ -95,19 +168,172 @@ namespace Microsoft { namespace P3
         // Notifies that a machine popped its state.
         void NotifyPoppedState(Machine& machine);
 
+        // Notifies that a machine dequeued an event.
+        void NotifyDequeuedEvent(Machine& machine, Event& event);
+
+        // Notifies that an actor, which is not a machine, dequeued an event.
+        void NotifyDequeuedEvent(Actor& actor, Event& event);
+
+        // Notifies that an actor enqueued an event into its inbox.
+        void NotifyEnqueuedEvent(Actor& actor, Event& event);
+
     private:
+        // Arena of the actors and events of the current iteration. It is
+        // declared first, so that it outlives the actors.
+        IterationArena m_arena;
+
+        // Workers that run the event handlers.
+        WorkerPool m_workers;
+
+        // Virtual clock of the iteration, whose timers deliver their events
+        // from the arena of the iteration.
+        TestingServices::VirtualClock m_clock;
+
+        // Latest log records of the current iteration.
+        LogBuffer m_log;
+
         // Map from unique ids to actors.
         std::unordered_map<long, std::unique_ptr<Actor>> m_actorMap;
 
-        // Set of registered monitors.
-        std::set<std::unique_ptr<Monitor>> m_monitors;
+        // Registered monitors, in registration order.
+        std::vector<std::unique_ptr<Monitor>> m_monitors;
+
+        // Map from names to registered monitors.
+        std::unordered_map<std::string, Monitor*> m_monitorsByName;
+
+        // Map from types to registered monitors. A type that is registered
+        // more than once maps to null, as its monitors can only be invoked
+        // by name.
+        std::unordered_map<std::type_index, Monitor*> m_monitorsByType;
 
-        // Spawned actor tasks.
-        std::vector<std::future<void>> m_actorTasks;
+        // Map from event names to the monitors that handle the event in some
+        // of their states, in registration order.
+        std::unordered_map<std::string, std::vector<Monitor*>> m_observers;
 
         // Bug-finding scheduler.
         std::unique_ptr<TestingServices::BugFindingScheduler> m_scheduler;
 
+        // Number of actors created in this runtime. The counters are read
+        // by the engine while a hung process may still update them.
+        std::atomic<long long> m_numOfCreatedActors;
+
+        // Number of events sent in this runtime.
+        std::atomic<long long> m_numOfSentEvents;
+
+        // Records activity coverage, if not null. The engine detaches it
+        // from a runtime whose process is hung.
+        std::atomic<TestingServices::CoverageInfo*> m_coverage;
+
+        // Last state exited by each machine and monitor, which is the source
+        // of the transition that enters the next state.
+        std::unordered_map<const void*, const std::string*> m_exitedStates;
+
+        // Node of the simulated network, and factory, of an actor.
+        struct Placement
+        {
+            long Id;
+            int Node;
+            ActorFactory Factory;
+        };
+
+        // Placements of the actors, in creation order.
+        std::vector<Placement> m_placements;
+
+        // Map from unique ids to the nodes of the actors.
+        std::unordered_map<long, int> m_nodes;
+
+        // Number of network faults injected during this iteration.
+        int m_numOfNetworkFaults;
+
+        // Fingerprint of the program state, if state hashing is enabled.
+        TestingServices::StateFingerprint m_fingerprint;
+
+        // Actors and monitors whose state may have changed since the program
+        // state was last fingerprinted.
+        std::vector<Actor*> m_changedActors;
+        std::vector<Monitor*> m_changedMonitors;
+
+        // Number of scheduling points that each actor reached since it started
+        // handling its current event, which tells apart the points of a handler
+        // that do not change the fields of the actor.
+        std::unordered_map<Actor*, size_t> m_handlerSteps;
+
+        // Id of the first actor of the iteration. Actors are told apart by
+        // their creation order, which, unlike their ids, does not depend on
+        // earlier iterations.
+        long m_firstActorId;
+
+        // Whether the scheduled process already handled an event, so that
+        // receiving the next one is a scheduling point.
+        bool m_hasHandledEvent;
+
+        // Actor of a process that runs on the testing thread in single-thread
+        // mode, and the event that starts it, if it has not started yet.
+        struct InlineProcess
+        {
+            Actor* Target;
+            std::unique_ptr<Event> StartEvent;
+            bool IsFresh;
+        };
+
+        // Processes that run on the testing thread in single-thread mode.
+        std::unordered_map<long, InlineProcess> m_inlineProcesses;
+
+        // Actors that crashed with their node. They are kept until the end of
+        // the iteration, as their processes are blocked in the scheduler.
+        std::vector<std::unique_ptr<Actor>> m_crashedActors;
+
+        // Runs the handlers on the calling thread in single-thread mode, one
+        // event at a time, in the order that the scheduler chooses, until the
+        // scheduler stops.
+        void RunInlineProcesses();
+
+        // Inserts a scheduling point before the scheduled process handles a
+        // received event, if only receives are scheduling points.
+        void ScheduleAtReceive();
+
+        // Records that the actor starts handling a new event, if state hashing
+        // is enabled.
+        void ResetHandlerSteps(Actor& actor);
+
+        // Delivers the event to the specified monitor.
+        void DeliverToMonitor(Monitor& monitor, std::unique_ptr<Event> event);
+
+        // Logs a record into the log buffer, and formats it to the output if verbose.
+        void Trace(LogBuffer::RecordType type, const std::string& actor, const std::string& name = std::string(),
+            const std::string& target = std::string(), long long value = 0, long long time = 0);
+
+        // Injects a network fault into the delivery of the specified event to
+        // a machine on the specified node, if the strategy chooses to. Returns
+        // true if the event must not be delivered now.
+        bool InjectNetworkFault(Actor& target, int node, std::unique_ptr<Event>& event);
+
+        // Crashes the specified node, and restarts its actors with the same
+        // ids, in their initial state.
+        void RestartNode(int node);
+
+        // Returns the fingerprint of the program state, rehashing the actors
+        // and monitors that changed since the last scheduling step.
+        uint64_t GetStateFingerprint();
+
+        // Returns the hash of the state of the specified actor.
+        uint64_t HashState(Actor& actor) const;
+
+        // Returns the hash of the state of the specified monitor.
+        uint64_t HashState(Monitor& monitor) const;
+
+        // Delivers the event of a fired timer to the specified actor.
+        void FireTimer(Actor& actor, std::unique_ptr<Event> event);
+
+        // Notifies the scheduler of an operation of the actor with the specified
+        // id, or of the program or a timer if negative, if a production trace
+        // is replayed.
+        void NotifyOperation(EventTraceRecorder::RecordType type, long actor, long target, const Event* event);
+
+        // Reports a deadlock if the completed schedule left actors that are
+        // not halted with pending events in their inbox.
+        void CheckForDeadlock();
+
         // Enqueues an asynchronous event to the target actor.
         void EnqueueEvent(Actor& target, std::unique_ptr<Event> event, bool& runNewHandler);
 
@@ -0,0 +1,167 @@
+//-----------------------------------------------------------------------
+// <copyright file="EventTraceRecorder.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "EventTraceRecorder.h"
+#include <algorithm>
+
+using namespace Microsoft::P3;
+
+// Header of the event trace format.
+static const char EventTraceMagic[4] = { 'P', '3', 'E', 'T' };
+static const uint8_t EventTraceVersion = 2;
+
+// Source of the unique ids of the recorders.
+static std::atomic<uint64_t> NextRecorderId(1);
+
+// Buffer that the calling thread last used, and the id of its recorder.
+static thread_local uint64_t CachedRecorderId = 0;
+static thread_local void* CachedBuffer = nullptr;
+
+// Writes a value in its binary format.
+template<typename T>
+static void WriteValue(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Reads a value in its binary format.
+template<typename T>
+static bool ReadValue(std::istream& stream, T& value)
+{
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+EventTraceRecorder::EventTraceRecorder(const std::string& path)
+    : m_id(NextRecorderId.fetch_add(1)),
+      m_sequence(0),
+      m_file(path, std::ios::binary | std::ios::trunc)
+{
+    m_file.write(EventTraceMagic, sizeof(EventTraceMagic));
+    m_file.put(static_cast<char>(EventTraceVersion));
+    m_file.flush();
+}
+
+void EventTraceRecorder::Add(RecordType type, long actor, long target, uint64_t value)
+{
+    auto sequence = m_sequence.fetch_add(1, std::memory_order_relaxed);
+    auto& buffer = GetBuffer();
+    std::lock_guard<std::mutex> lock(buffer.Lock);
+    buffer.Records.push_back({ sequence, type, static_cast<int32_t>(actor), static_cast<int32_t>(target), value });
+    if (buffer.Records.size() >= FlushThreshold)
+    {
+        WriteRecords(buffer.Records);
+    }
+}
+
+bool EventTraceRecorder::Flush()
+{
+    bool isWritten = true;
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (auto& buffer : m_buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->Lock);
+        isWritten = WriteRecords(buffer->Records) && isWritten;
+    }
+
+    return isWritten;
+}
+
+bool EventTraceRecorder::LoadFromFile(const std::string& path, std::vector<Record>& records)
+{
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(EventTraceMagic)];
+    if (!file || !file.read(magic, sizeof(magic)) ||
+        !std::equal(magic, magic + sizeof(magic), EventTraceMagic) ||
+        file.get() != EventTraceVersion)
+    {
+        return false;
+    }
+
+    // The buffers of the threads are written as they fill up, so the records
+    // are sorted into their global order.
+    records.clear();
+    for (;;)
+    {
+        uint8_t type;
+        Record record;
+        if (!ReadValue(file, record.Sequence) || !ReadValue(file, type) || !ReadValue(file, record.Actor) ||
+            !ReadValue(file, record.Target) || !ReadValue(file, record.Value))
+        {
+            break;
+        }
+
+        if (type > static_cast<uint8_t>(RecordType::IntegerChoice))
+        {
+            return false;
+        }
+
+        record.Type = static_cast<RecordType>(type);
+        records.push_back(record);
+    }
+
+    std::sort(records.begin(), records.end(), [](const Record& left, const Record& right)
+    {
+        return left.Sequence < right.Sequence;
+    });
+
+    return true;
+}
+
+uint64_t EventTraceRecorder::HashName(const std::string& name)
+{
+    // FNV-1a, as std::hash may differ between the recording and replaying builds.
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (auto c : name)
+    {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+EventTraceRecorder::Buffer& EventTraceRecorder::GetBuffer()
+{
+    if (CachedRecorderId != m_id)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_buffers.push_back(std::make_unique<Buffer>());
+        CachedRecorderId = m_id;
+        CachedBuffer = m_buffers.back().get();
+    }
+
+    return *static_cast<Buffer*>(CachedBuffer);
+}
+
+bool EventTraceRecorder::WriteRecords(std::vector<Record>& records)
+{
+    std::lock_guard<std::mutex> lock(m_fileLock);
+    for (auto& record : records)
+    {
+        WriteValue(m_file, record.Sequence);
+        WriteValue(m_file, static_cast<uint8_t>(record.Type));
+        WriteValue(m_file, record.Actor);
+        WriteValue(m_file, record.Target);
+        WriteValue(m_file, record.Value);
+    }
+
+    // The records reach the file even if the process dies before the next write.
+    records.clear();
+    m_file.flush();
+    return static_cast<bool>(m_file);
+}
+
+EventTraceRecorder::~EventTraceRecorder()
+{
+    Flush();
+}
@@ -0,0 +1,127 @@
+//-----------------------------------------------------------------------
+// <copyright file="EventTraceRecorder.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_RUNTIME_EVENTTRACERECORDER_H
+#define MICROSOFT_P3_RUNTIME_EVENTTRACERECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Microsoft { namespace P3
+{
+    // Recorder of the operations that actors perform in production: the
+    // actors they create, the events that enter inboxes, and the choices
+    // they take. Each thread appends fixed-size records to its own buffer,
+    // so that recording only takes an atomic increment for the global order
+    // of the records and an uncontended lock. A full buffer is appended to
+    // the trace file, so that memory stays bounded, and the trace is only
+    // sorted when it is read.
+    class EventTraceRecorder
+    {
+    public:
+        // Kinds of recorded operations.
+        enum class RecordType : uint8_t
+        {
+            CreateActor = 0,
+            SendEvent,
+            FireTimer,
+            BooleanChoice,
+            IntegerChoice
+        };
+
+        // A recorded operation. Actors are identified by the value of their id,
+        // and the program, or a timer, by -1.
+        struct Record
+        {
+            // Position of the record in the global order.
+            uint64_t Sequence;
+
+            RecordType Type;
+
+            // Actor that performed the operation.
+            int32_t Actor;
+
+            // Created actor, or actor whose inbox received the event.
+            int32_t Target;
+
+            // Hash of the event name, or the value of the choice.
+            uint64_t Value;
+        };
+
+        // Number of records that a thread buffers before it writes them.
+        static const size_t FlushThreshold = 4096;
+
+        // Creates a recorder that writes the trace to the file with the specified path.
+        EventTraceRecorder(const std::string& path);
+        ~EventTraceRecorder();
+
+        // Records an operation. Can be called concurrently from any thread.
+        void Add(RecordType type, long actor, long target, uint64_t value);
+
+        // Writes the buffered records of all threads to the trace file. Can be
+        // called concurrently with Add. Returns false if the file cannot be written.
+        bool Flush();
+
+        // Reads the records of the trace in the file with the specified path,
+        // in their global order. A record that the recording process did not
+        // finish writing is ignored.
+        static bool LoadFromFile(const std::string& path, std::vector<Record>& records);
+
+        // Returns the hash of an event name, which is the same across processes.
+        static uint64_t HashName(const std::string& name);
+
+    private:
+        // Records of a single thread, which a flush can take concurrently.
+        struct Buffer
+        {
+            std::mutex Lock;
+            std::vector<Record> Records;
+        };
+
+        // Unique id of the recorder, which tells apart the buffers that a
+        // thread keeps for different recorders.
+        uint64_t m_id;
+
+        // Sequence number of the next record.
+        std::atomic<uint64_t> m_sequence;
+
+        // Buffers of the threads that recorded operations.
+        std::vector<std::unique_ptr<Buffer>> m_buffers;
+
+        // Protects the list of buffers.
+        std::mutex m_lock;
+
+        // The trace file, and the lock that orders the writes to it. A buffer
+        // is locked before the file.
+        std::ofstream m_file;
+        std::mutex m_fileLock;
+
+        // Returns the buffer of the calling thread, adding it on first use.
+        Buffer& GetBuffer();
+
+        // Appends the records to the trace file, and clears them.
+        bool WriteRecords(std::vector<Record>& records);
+
+        // Copy is disabled.
+        EventTraceRecorder(const EventTraceRecorder& that) = delete;
+        EventTraceRecorder &operator=(EventTraceRecorder const &) = delete;
+    };
+} }
+
+#endif // MICROSOFT_P3_RUNTIME_EVENTTRACERECORDER_H
@@ -0,0 +1,129 @@
+//-----------------------------------------------------------------------
+// <copyright file="IterationArena.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "IterationArena.h"
+#include <cassert>
+#include <new>
+
+using namespace Microsoft::P3;
+
+// Size of an arena chunk.
+static const size_t ChunkSize = 64 * 1024;
+
+// Size of the header that precedes each object, which keeps the object aligned.
+// The header records the arena that the object was allocated from, or null.
+static const size_t HeaderSize = alignof(std::max_align_t);
+
+
+thread_local IterationArena* IterationArena::s_current = nullptr;
+
+IterationArena::Scope::Scope(IterationArena& arena)
+{
+    m_previous = s_current;
+    s_current = &arena;
+}
+
+IterationArena::Scope::~Scope()
+{
+    s_current = m_previous;
+}
+
+IterationArena::IterationArena()
+{
+    m_chunk = 0;
+    m_offset = 0;
+    m_numOfObjects = 0;
+}
+
+void* IterationArena::AllocateObject(size_t size)
+{
+    char* block;
+    if (s_current != nullptr)
+    {
+        block = static_cast<char*>(s_current->Allocate(size + HeaderSize));
+        s_current->m_numOfObjects.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        block = static_cast<char*>(::operator new(size + HeaderSize));
+    }
+
+    *reinterpret_cast<IterationArena**>(block) = s_current;
+    return block + HeaderSize;
+}
+
+void IterationArena::FreeObject(void* ptr)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    char* block = static_cast<char*>(ptr) - HeaderSize;
+    auto arena = *reinterpret_cast<IterationArena**>(block);
+    if (arena == nullptr)
+    {
+        ::operator delete(block);
+    }
+    else
+    {
+        arena->m_numOfObjects.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void IterationArena::Release()
+{
+    // An object that outlives the iteration would be overwritten by the next one.
+    assert(m_numOfObjects.load(std::memory_order_relaxed) == 0 && "Arena object outlives its iteration.");
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_largeBlocks.clear();
+    m_chunk = 0;
+    m_offset = 0;
+}
+
+size_t IterationArena::GetNumOfObjects() const
+{
+    return m_numOfObjects.load(std::memory_order_relaxed);
+}
+
+void* IterationArena::Allocate(size_t size)
+{
+    size = (size + HeaderSize - 1) & ~(HeaderSize - 1);
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (size > ChunkSize / 4)
+    {
+        m_largeBlocks.emplace_back(new char[size]);
+        return m_largeBlocks.back().get();
+    }
+
+    if (m_chunk < m_chunks.size() && m_offset + size > ChunkSize)
+    {
+        // Move to the next chunk, which may be left from a previous iteration.
+        m_chunk++;
+        m_offset = 0;
+    }
+
+    if (m_chunk == m_chunks.size())
+    {
+        m_chunks.emplace_back(new char[ChunkSize]);
+    }
+
+    void* ptr = m_chunks[m_chunk].get() + m_offset;
+    m_offset += size;
+    return ptr;
+}
+
+IterationArena::~IterationArena() { }
@@ -0,0 +1,98 @@
+//-----------------------------------------------------------------------
+// <copyright file="IterationArena.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_RUNTIME_ITERATIONARENA_H
+#define MICROSOFT_P3_RUNTIME_ITERATIONARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Microsoft { namespace P3
+{
+    // Bump allocator for the actors and events of a testing iteration. Objects
+    // are destroyed as usual, but their memory is only reclaimed, wholesale,
+    // when the arena is released at the end of the iteration. The chunks of
+    // the arena are kept, so that later iterations do not allocate.
+    class IterationArena
+    {
+    public:
+        // Sets the arena of the calling thread for the lifetime of the scope.
+        class Scope
+        {
+        public:
+            Scope(IterationArena& arena);
+            ~Scope();
+
+        private:
+            IterationArena* m_previous;
+
+            // Copy is disabled.
+            Scope(const Scope& that) = delete;
+            Scope &operator=(Scope const &) = delete;
+        };
+
+        IterationArena();
+        ~IterationArena();
+
+        // Allocates an object from the arena of the calling thread, or from
+        // the heap if the thread has no arena.
+        static void* AllocateObject(size_t size);
+
+        // Frees an object allocated with AllocateObject. Objects allocated
+        // from an arena are reclaimed when the arena is released.
+        static void FreeObject(void* ptr);
+
+        // Reclaims all allocations. Every object allocated from the arena
+        // must already be destroyed, which is asserted in debug builds.
+        void Release();
+
+        // Returns the number of objects allocated from the arena that are
+        // not freed yet.
+        size_t GetNumOfObjects() const;
+
+    private:
+        // The arena of the calling thread, if any.
+        static thread_local IterationArena* s_current;
+
+        // Chunks that allocations are carved from.
+        std::vector<std::unique_ptr<char[]>> m_chunks;
+
+        // Allocations that are too large for a chunk.
+        std::vector<std::unique_ptr<char[]>> m_largeBlocks;
+
+        // Index of the chunk that is currently being carved.
+        size_t m_chunk;
+
+        // Offset of the next allocation in the current chunk.
+        size_t m_offset;
+
+        // Number of objects allocated from the arena that are not freed yet.
+        std::atomic<size_t> m_numOfObjects;
+
+        // Serializes allocations, as canceled processes can unwind concurrently.
+        std::mutex m_lock;
+
+        // Allocates the specified number of bytes from the arena.
+        void* Allocate(size_t size);
+
+        // Copy is disabled.
+        IterationArena(const IterationArena& that) = delete;
+        IterationArena &operator=(IterationArena const &) = delete;
+    };
+} }
+
+#endif // MICROSOFT_P3_RUNTIME_ITERATIONARENA_H
@@ -0,0 +1,169 @@
+//-----------------------------------------------------------------------
+// <copyright file="LogBuffer.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "LogBuffer.h"
+
+using namespace Microsoft::P3;
+
+LogBuffer::LogBuffer(size_t capacity)
+    : m_records(capacity)
+{
+    m_count = 0;
+}
+
+size_t LogBuffer::Capacity() const
+{
+    return m_records.size();
+}
+
+size_t LogBuffer::Count() const
+{
+    return m_count;
+}
+
+void LogBuffer::Add(RecordType type, const std::string& actor, const std::string& name,
+    const std::string& target, long long value, long long time)
+{
+    if (m_records.empty())
+    {
+        return;
+    }
+
+    // Assigning to the strings of an overwritten record reuses their storage.
+    auto& record = m_records[m_count % m_records.size()];
+    record.Type = type;
+    record.Actor = actor;
+    record.Name = name;
+    record.Target = target;
+    record.Value = value;
+    record.Time = time;
+    m_count++;
+}
+
+void LogBuffer::Write(std::ostream& stream) const
+{
+    size_t first = 0;
+    if (m_count > m_records.size())
+    {
+        first = m_count - m_records.size();
+        stream << "<LogBuffer> " << first << " earlier records were overwritten." << std::endl;
+    }
+
+    for (size_t i = first; i < m_count; i++)
+    {
+        Format(m_records[i % m_records.size()], stream);
+        stream << std::endl;
+    }
+}
+
+void LogBuffer::Clear()
+{
+    m_count = 0;
+}
+
+void LogBuffer::Format(const Record& record, std::ostream& stream)
+{
+    switch (record.Type)
+    {
+    case RecordType::Message:
+        stream << record.Name;
+        break;
+    case RecordType::Error:
+        stream << "<ErrorLog> " << record.Name;
+        break;
+    case RecordType::CreateActor:
+        stream << "<CreateLog> Actor '" << record.Actor << "' is created.";
+        break;
+    case RecordType::CreateMachine:
+        stream << "<CreateLog> Machine '" << record.Actor << "' is created.";
+        break;
+    case RecordType::RegisterMonitor:
+        stream << "<MonitorLog> Monitor '" << record.Actor << "' is registered.";
+        break;
+    case RecordType::Send:
+        stream << "<SendLog> '" << record.Actor << "' sent event '" << record.Name << "' to '" <<
+            record.Target << "'.";
+        break;
+    case RecordType::SendExternal:
+        stream << "<SendLog> Event '" << record.Name << "' was sent to '" << record.Target << "'.";
+        break;
+    case RecordType::Enqueue:
+        stream << "<EnqueueLog> '" << record.Actor << "' enqueued event '" << record.Name << "'.";
+        break;
+    case RecordType::InvokeMonitor:
+        stream << "<MonitorLog> Monitor '" << record.Actor << "' invoked with event '" << record.Name << "'.";
+        break;
+    case RecordType::RandomBoolean:
+        stream << "<RandomLog> '" << record.Actor << "' nondeterministically chose '" <<
+            (record.Value != 0 ? "true" : "false") << "'.";
+        break;
+    case RecordType::RandomInteger:
+        stream << "<RandomLog> '" << record.Actor << "' nondeterministically chose '" << record.Value << "'.";
+        break;
+    case RecordType::StartTimer:
+        stream << "<TimerLog> '" << record.Actor << "' started timer " << record.Value << " for event '" <<
+            record.Name << "' due in " << record.Time << " ms.";
+        break;
+    case RecordType::FireTimer:
+        stream << "<TimerLog> A timer sent event '" << record.Name << "' to '" << record.Target << "' at " <<
+            record.Time << " ms.";
+        break;
+    case RecordType::NetworkDelay:
+        stream << "<NetworkLog> Event '" << record.Name << "' to '" << record.Target << "' is delayed by " <<
+            record.Time << " ms.";
+        break;
+    case RecordType::NetworkDrop:
+        stream << "<NetworkLog> Event '" << record.Name << "' to '" << record.Target << "' is dropped.";
+        break;
+    case RecordType::NetworkDuplicate:
+        stream << "<NetworkLog> Event '" << record.Name << "' to '" << record.Target << "' is duplicated.";
+        break;
+    case RecordType::NetworkCrash:
+        stream << "<NetworkLog> Node " << record.Value << " crashed before event '" << record.Name <<
+            "' reached '" << record.Target << "'.";
+        break;
+    case RecordType::NetworkRestart:
+        stream << "<NetworkLog> '" << record.Actor << "' restarts on node " << record.Value << ".";
+        break;
+    case RecordType::EnterState:
+        stream << "<StateLog> '" << record.Actor << "' enters state '" << record.Name << "'.";
+        break;
+    case RecordType::ExitState:
+        stream << "<StateLog> '" << record.Actor << "' exits state '" << record.Name << "'.";
+        break;
+    case RecordType::InvokeAction:
+        stream << "<ActionLog> '" << record.Actor << "' invoked an action.";
+        break;
+    case RecordType::RaiseEvent:
+        stream << "<RaiseLog> '" << record.Actor << "' raised event '" << record.Name << "'.";
+        break;
+    case RecordType::PopState:
+        stream << "<PopLog> '" << record.Actor << "' popped state '" << record.Name << "'.";
+        break;
+    case RecordType::MonitorEnterState:
+        stream << "<MonitorLog> '" << record.Actor << "' enters state '" << record.Name << "'.";
+        break;
+    case RecordType::MonitorExitState:
+        stream << "<MonitorLog> '" << record.Actor << "' exits state '" << record.Name << "'.";
+        break;
+    case RecordType::MonitorInvokeAction:
+        stream << "<MonitorLog> '" << record.Actor << "' invoked an action.";
+        break;
+    case RecordType::MonitorRaiseEvent:
+        stream << "<MonitorLog> '" << record.Actor << "' raised event '" << record.Name << "'.";
+        break;
+    }
+}
+
+LogBuffer::~LogBuffer() { }
@@ -0,0 +1,122 @@
+//-----------------------------------------------------------------------
+// <copyright file="LogBuffer.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_RUNTIME_LOGBUFFER_H
+#define MICROSOFT_P3_RUNTIME_LOGBUFFER_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Microsoft { namespace P3
+{
+    // Ring buffer of the log records of a testing iteration. Records keep the
+    // names and values of a log entry instead of its text, so that logging
+    // only copies a few strings into storage that later iterations reuse, and
+    // the text is only formatted if the buffer is written.
+    class LogBuffer
+    {
+    public:
+        // Kinds of log records, each with its own text.
+        enum class RecordType
+        {
+            Message = 0,
+            Error,
+            CreateActor,
+            CreateMachine,
+            RegisterMonitor,
+            Send,
+            SendExternal,
+            Enqueue,
+            InvokeMonitor,
+            RandomBoolean,
+            RandomInteger,
+            StartTimer,
+            FireTimer,
+            NetworkDelay,
+            NetworkDrop,
+            NetworkDuplicate,
+            NetworkCrash,
+            NetworkRestart,
+            EnterState,
+            ExitState,
+            InvokeAction,
+            RaiseEvent,
+            PopState,
+            MonitorEnterState,
+            MonitorExitState,
+            MonitorInvokeAction,
+            MonitorRaiseEvent
+        };
+
+        // A single log record. Unused fields are left empty.
+        struct Record
+        {
+            RecordType Type;
+
+            // Actor, or monitor, that the record is about.
+            std::string Actor;
+
+            // Event, state or message of the record.
+            std::string Name;
+
+            // Target actor of an event.
+            std::string Target;
+
+            // Choice, timer id or node of the record.
+            long long Value;
+
+            // Virtual time, or delay, in milliseconds.
+            long long Time;
+        };
+
+        // Creates a buffer that keeps the specified number of latest records.
+        LogBuffer(size_t capacity);
+        ~LogBuffer();
+
+        // Returns the number of records that the buffer keeps.
+        size_t Capacity() const;
+
+        // Returns the number of records that were added since the buffer was
+        // cleared, including the overwritten ones.
+        size_t Count() const;
+
+        // Adds a record, overwriting the oldest one if the buffer is full.
+        void Add(RecordType type, const std::string& actor, const std::string& name = std::string(),
+            const std::string& target = std::string(), long long value = 0, long long time = 0);
+
+        // Writes the text of the kept records, from oldest to newest.
+        void Write(std::ostream& stream) const;
+
+        // Removes all records. Their storage is kept.
+        void Clear();
+
+        // Writes the text of the specified record.
+        static void Format(const Record& record, std::ostream& stream);
+
+    private:
+        // Storage of the records, which is allocated once.
+        std::vector<Record> m_records;
+
+        // Number of records added since the buffer was cleared.
+        size_t m_count;
+
+        // Copy is disabled.
+        LogBuffer(const LogBuffer& that) = delete;
+        LogBuffer &operator=(LogBuffer const &) = delete;
+    };
+} }
+
+#endif // MICROSOFT_P3_RUNTIME_LOGBUFFER_H
@@ -111,6 +111,27 @@ void Runtime::NotifyPoppedState(Machine& machine)
     // Override to implement the notification.
 }
 
+void Runtime::PlaceOnNode(Actor& actor, int node, ActorFactory factory)
+{
+    // In production, every node runs its own runtime.
+}
+
+inline
+void Runtime::NotifyDequeuedEvent(Machine& machine, Event& event)
+{
+    // Override to implement the notification.
+}
+
+void Runtime::NotifyDequeuedEvent(Actor& actor, Event& event)
+{
+    // Override to implement the notification.
+}
+
+void Runtime::NotifyEnqueuedEvent(Actor& actor, Event& event)
+{
+    Log("<EnqueueLog> '" + actor.m_id->m_name + "' enqueued event '" + event.m_name + "'.");
+}
+
 void Runtime::Log(const std::string& message)
 {
     if (Config->Verbosity)
@@ -127,6 +148,11 @@ void Runtime::Log(std::ostringstream& stream)
     }
 }
 
+void Runtime::ResetIdCounter()
+{
+    m_idCounter = 0;
+}
+
 long Runtime::GetNextId()
 {
     long id = _InterlockedIncrement(&m_idCounter);
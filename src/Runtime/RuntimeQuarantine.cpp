@@ -0,0 +1,64 @@
+//-----------------------------------------------------------------------
+// <copyright file="RuntimeQuarantine.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "RuntimeQuarantine.h"
+#include "BugFindingRuntime.h"
+
+using namespace Microsoft::P3;
+
+RuntimeQuarantine::RuntimeQuarantine() { }
+
+void RuntimeQuarantine::Add(std::unique_ptr<BugFindingRuntime> runtime)
+{
+    // The coverage is shared with the next iteration, so the held runtime
+    // stops recording it.
+    runtime->SetCoverage(nullptr);
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_runtimes.push_back(move(runtime));
+}
+
+bool RuntimeQuarantine::IsFull()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    Reclaim();
+    return m_runtimes.size() >= Capacity;
+}
+
+void RuntimeQuarantine::Reclaim()
+{
+    for (size_t i = 0; i < m_runtimes.size();)
+    {
+        if (m_runtimes[i]->IsIdle())
+        {
+            m_runtimes.erase(m_runtimes.begin() + i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+RuntimeQuarantine::~RuntimeQuarantine()
+{
+    Reclaim();
+
+    // The workers of a process that is still blocked cannot be joined, so
+    // its runtime is intentionally leaked.
+    for (auto& runtime : m_runtimes)
+    {
+        runtime.release();
+    }
+}
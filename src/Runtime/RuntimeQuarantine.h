@@ -0,0 +1,62 @@
+//-----------------------------------------------------------------------
+// <copyright file="RuntimeQuarantine.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_RUNTIME_RUNTIMEQUARANTINE_H
+#define MICROSOFT_P3_RUNTIME_RUNTIMEQUARANTINE_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Microsoft { namespace P3
+{
+    class BugFindingRuntime;
+
+    // Holds the runtimes of hung iterations. The blocked process still uses
+    // its runtime, which is only destroyed once the process has returned its
+    // worker. A runtime whose process never returns cannot be destroyed, so
+    // the number of held runtimes is bounded, and the caller stops running
+    // iterations when the quarantine is full.
+    class RuntimeQuarantine
+    {
+    public:
+        // Maximum number of runtimes that are held at a time.
+        static const size_t Capacity = 8;
+
+        RuntimeQuarantine();
+        ~RuntimeQuarantine();
+
+        // Holds the specified runtime until its workers are idle.
+        void Add(std::unique_ptr<BugFindingRuntime> runtime);
+
+        // Destroys the runtimes whose processes have returned, and returns
+        // true if the remaining runtimes fill the quarantine.
+        bool IsFull();
+
+    private:
+        // The held runtimes.
+        std::vector<std::unique_ptr<BugFindingRuntime>> m_runtimes;
+
+        std::mutex m_lock;
+
+        // Destroys the runtimes whose workers are idle.
+        void Reclaim();
+
+        // Copy is disabled.
+        RuntimeQuarantine(const RuntimeQuarantine& that) = delete;
+        RuntimeQuarantine &operator=(RuntimeQuarantine const &) = delete;
+    };
+} }
+
+#endif // MICROSOFT_P3_RUNTIME_RUNTIMEQUARANTINE_H
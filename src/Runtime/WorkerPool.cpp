@@ -0,0 +1,109 @@
+//-----------------------------------------------------------------------
+// <copyright file="WorkerPool.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "WorkerPool.h"
+
+using namespace Microsoft::P3;
+
+WorkerPool::WorkerPool()
+{
+    m_numOfIdleWorkers = 0;
+    m_numOfPendingTasks = 0;
+    m_isDisposed = false;
+}
+
+void WorkerPool::Run(std::function<void()> task)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_tasks.push_back(move(task));
+    m_numOfPendingTasks++;
+
+    // Every queued task must be picked up, so grow the pool if there
+    // are not enough idle workers.
+    if (m_tasks.size() > m_numOfIdleWorkers)
+    {
+        m_workers.emplace_back(&WorkerPool::RunWorker, this);
+    }
+    else
+    {
+        m_taskAvailable.notify_one();
+    }
+}
+
+void WorkerPool::WaitForIdle()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_allTasksCompleted.wait(lock, [this] { return m_numOfPendingTasks == 0; });
+}
+
+bool WorkerPool::IsIdle()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_numOfPendingTasks == 0;
+}
+
+size_t WorkerPool::Size()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_workers.size();
+}
+
+void WorkerPool::RunWorker()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    while (true)
+    {
+        m_numOfIdleWorkers++;
+        m_taskAvailable.wait(lock, [this] { return !m_tasks.empty() || m_isDisposed; });
+        m_numOfIdleWorkers--;
+        if (m_tasks.empty())
+        {
+            return;
+        }
+
+        auto task = move(m_tasks.front());
+        m_tasks.pop_front();
+        lock.unlock();
+
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            // Tasks handle their own failures, so any escaping exception is ignored.
+        }
+
+        task = nullptr;
+        lock.lock();
+        if (--m_numOfPendingTasks == 0)
+        {
+            m_allTasksCompleted.notify_all();
+        }
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_isDisposed = true;
+        m_taskAvailable.notify_all();
+    }
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
@@ -0,0 +1,78 @@
+//-----------------------------------------------------------------------
+// <copyright file="WorkerPool.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_RUNTIME_WORKERPOOL_H
+#define MICROSOFT_P3_RUNTIME_WORKERPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Microsoft { namespace P3
+{
+    // Pool of worker threads that run the event handlers of a runtime. Handlers
+    // block while they are not scheduled, so each task gets its own worker, and
+    // the pool grows whenever all workers are busy. Workers are kept across
+    // testing iterations, so that an iteration does not spawn threads.
+    class WorkerPool
+    {
+    public:
+        WorkerPool();
+        ~WorkerPool();
+
+        // Runs the specified task on an idle worker.
+        void Run(std::function<void()> task);
+
+        // Blocks until all tasks have completed.
+        void WaitForIdle();
+
+        // Returns true if all tasks have completed.
+        bool IsIdle();
+
+        // Returns the number of workers.
+        size_t Size();
+
+    private:
+        // The worker threads.
+        std::vector<std::thread> m_workers;
+
+        // Tasks that are waiting for a worker.
+        std::deque<std::function<void()>> m_tasks;
+
+        // Number of workers that wait for a task.
+        size_t m_numOfIdleWorkers;
+
+        // Number of tasks that have not completed yet.
+        size_t m_numOfPendingTasks;
+
+        // Set when the pool is disposed.
+        bool m_isDisposed;
+
+        std::mutex m_lock;
+        std::condition_variable m_taskAvailable;
+        std::condition_variable m_allTasksCompleted;
+
+        // Runs tasks until the pool is disposed.
+        void RunWorker();
+
+        // Copy is disabled.
+        WorkerPool(const WorkerPool& that) = delete;
+        WorkerPool &operator=(WorkerPool const &) = delete;
+    };
+} }
+
+#endif // MICROSOFT_P3_RUNTIME_WORKERPOOL_H
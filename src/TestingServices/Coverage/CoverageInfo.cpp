@@ -0,0 +1,385 @@
+//-----------------------------------------------------------------------
+// <copyright file="CoverageInfo.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "CoverageInfo.h"
+#include <algorithm>
+#include <functional>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+// Kinds of covered items.
+static const int StateItem = 1;
+static const int TransitionItem = 2;
+static const int EventItem = 3;
+
+// Mixes the bits of the specified value using the SplitMix64 finalizer.
+static inline uint64_t Mix(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Writes a count or length.
+static void WriteCount(std::ostream& stream, size_t count)
+{
+    uint32_t value = static_cast<uint32_t>(count);
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Reads a count or length.
+static bool ReadCount(std::istream& stream, uint32_t& count)
+{
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&count), sizeof(count)));
+}
+
+// Writes a length-prefixed string.
+static void WriteString(std::ostream& stream, const std::string& value)
+{
+    WriteCount(stream, value.size());
+    stream.write(value.data(), value.size());
+}
+
+// Reads a length-prefixed string.
+static bool ReadString(std::istream& stream, std::string& value)
+{
+    uint32_t length;
+    if (!ReadCount(stream, length))
+    {
+        return false;
+    }
+
+    // The length is not trusted, so the string is read in chunks, and a
+    // truncated or corrupted stream fails before allocating its whole length.
+    const uint32_t chunkSize = 64 * 1024;
+    value.clear();
+    while (value.size() < length)
+    {
+        size_t offset = value.size();
+        size_t count = std::min<size_t>(chunkSize, length - offset);
+        value.resize(offset + count);
+        if (!stream.read(&value[offset], count))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Writes a set of strings.
+static void WriteSet(std::ostream& stream, const std::set<std::string>& values)
+{
+    WriteCount(stream, values.size());
+    for (auto& value : values)
+    {
+        WriteString(stream, value);
+    }
+}
+
+// Writes a set of string pairs.
+static void WriteSet(std::ostream& stream, const std::set<std::pair<std::string, std::string>>& values)
+{
+    WriteCount(stream, values.size());
+    for (auto& value : values)
+    {
+        WriteString(stream, value.first);
+        WriteString(stream, value.second);
+    }
+}
+
+// Reads a set of strings, adding them to the specified set.
+static bool ReadSet(std::istream& stream, std::set<std::string>& values)
+{
+    uint32_t count;
+    std::string value;
+    if (!ReadCount(stream, count))
+    {
+        return false;
+    }
+
+    for (; count > 0; count--)
+    {
+        if (!ReadString(stream, value))
+        {
+            return false;
+        }
+
+        values.insert(value);
+    }
+
+    return true;
+}
+
+// Reads a set of string pairs, adding them to the specified set.
+static bool ReadSet(std::istream& stream, std::set<std::pair<std::string, std::string>>& values)
+{
+    uint32_t count;
+    std::string first, second;
+    if (!ReadCount(stream, count))
+    {
+        return false;
+    }
+
+    for (; count > 0; count--)
+    {
+        if (!ReadString(stream, first) || !ReadString(stream, second))
+        {
+            return false;
+        }
+
+        values.insert(std::make_pair(first, second));
+    }
+
+    return true;
+}
+
+// Writes the percentage of covered items.
+static void WritePercentage(std::ostream& stream, size_t covered, size_t declared)
+{
+    stream << covered << "/" << declared;
+    if (declared > 0)
+    {
+        stream << " (" << (100 * covered / declared) << "%)";
+    }
+}
+
+TestingServices::CoverageInfo::CoverageInfo() { }
+
+bool TestingServices::CoverageInfo::IsDeclared(const std::type_info& type) const
+{
+    return m_declaredTypes.find(type.hash_code()) != m_declaredTypes.end();
+}
+
+void TestingServices::CoverageInfo::DeclareState(const std::type_info& type, bool isMonitor,
+    const std::string& state)
+{
+    m_declaredTypes.insert(type.hash_code());
+    auto& coverage = GetTypeCoverage(type);
+    coverage.IsMonitor = isMonitor;
+    coverage.DeclaredStates.insert(state);
+}
+
+void TestingServices::CoverageInfo::DeclareEvent(const std::type_info& type, const std::string& state,
+    const std::string& event)
+{
+    GetTypeCoverage(type).DeclaredEvents.insert(std::make_pair(state, event));
+}
+
+void TestingServices::CoverageInfo::AddState(const std::type_info& type, const std::string& state)
+{
+    if (m_coveredItems.insert(GetItemHash(type, StateItem, state, std::string())).second)
+    {
+        GetTypeCoverage(type).States.insert(state);
+    }
+}
+
+void TestingServices::CoverageInfo::AddTransition(const std::type_info& type, const std::string& from,
+    const std::string& to)
+{
+    if (m_coveredItems.insert(GetItemHash(type, TransitionItem, from, to)).second)
+    {
+        GetTypeCoverage(type).Transitions.insert(std::make_pair(from, to));
+    }
+}
+
+void TestingServices::CoverageInfo::AddEvent(const std::type_info& type, const std::string& state,
+    const std::string& event)
+{
+    if (m_coveredItems.insert(GetItemHash(type, EventItem, state, event)).second)
+    {
+        GetTypeCoverage(type).Events.insert(std::make_pair(state, event));
+    }
+}
+
+size_t TestingServices::CoverageInfo::GetNumOfCoveredItems() const
+{
+    // Counted from the per-type sets, which also hold merged coverage.
+    size_t count = 0;
+    for (auto& entry : m_types)
+    {
+        count += entry.second.States.size() + entry.second.Transitions.size() + entry.second.Events.size();
+    }
+
+    return count;
+}
+
+bool TestingServices::CoverageInfo::AddProgramState(uint64_t fingerprint)
+{
+    return m_programStates.insert(fingerprint).second;
+}
+
+size_t TestingServices::CoverageInfo::GetNumOfProgramStates() const
+{
+    return m_programStates.size();
+}
+
+void TestingServices::CoverageInfo::WriteReport(std::ostream& stream) const
+{
+    size_t numOfStates = 0, numOfDeclaredStates = 0;
+    size_t numOfEvents = 0, numOfDeclaredEvents = 0;
+    for (auto& entry : m_types)
+    {
+        auto& coverage = entry.second;
+        numOfStates += coverage.States.size();
+        numOfDeclaredStates += coverage.DeclaredStates.size();
+        numOfEvents += coverage.Events.size();
+        numOfDeclaredEvents += coverage.DeclaredEvents.size();
+    }
+
+    stream << "Total state coverage: ";
+    WritePercentage(stream, numOfStates, numOfDeclaredStates);
+    stream << std::endl << "Total event coverage: ";
+    WritePercentage(stream, numOfEvents, numOfDeclaredEvents);
+    stream << std::endl;
+    if (!m_programStates.empty())
+    {
+        stream << "Distinct program states: " << m_programStates.size() << std::endl;
+    }
+
+    for (auto& entry : m_types)
+    {
+        auto& coverage = entry.second;
+        stream << std::endl << (coverage.IsMonitor ? "Monitor: " : "Machine: ") << entry.first << std::endl;
+
+        stream << "  States: ";
+        WritePercentage(stream, coverage.States.size(), coverage.DeclaredStates.size());
+        stream << std::endl;
+        for (auto& state : coverage.DeclaredStates)
+        {
+            bool isCovered = coverage.States.find(state) != coverage.States.end();
+            stream << "    " << (isCovered ? "[x] " : "[ ] ") << state << std::endl;
+        }
+
+        stream << "  Events: ";
+        WritePercentage(stream, coverage.Events.size(), coverage.DeclaredEvents.size());
+        stream << std::endl;
+        for (auto& event : coverage.DeclaredEvents)
+        {
+            bool isCovered = coverage.Events.find(event) != coverage.Events.end();
+            stream << "    " << (isCovered ? "[x] " : "[ ] ") << event.first << ": " << event.second << std::endl;
+        }
+
+        stream << "  Transitions: " << coverage.Transitions.size() << std::endl;
+        for (auto& transition : coverage.Transitions)
+        {
+            stream << "    " << transition.first << " --> " << transition.second << std::endl;
+        }
+    }
+}
+
+void TestingServices::CoverageInfo::Merge(const CoverageInfo& that)
+{
+    for (auto& entry : that.m_types)
+    {
+        auto& from = entry.second;
+        auto& to = m_types[entry.first];
+        to.IsMonitor = from.IsMonitor;
+        to.DeclaredStates.insert(from.DeclaredStates.begin(), from.DeclaredStates.end());
+        to.DeclaredEvents.insert(from.DeclaredEvents.begin(), from.DeclaredEvents.end());
+        to.States.insert(from.States.begin(), from.States.end());
+        to.Transitions.insert(from.Transitions.begin(), from.Transitions.end());
+        to.Events.insert(from.Events.begin(), from.Events.end());
+    }
+
+    m_programStates.insert(that.m_programStates.begin(), that.m_programStates.end());
+}
+
+void TestingServices::CoverageInfo::Serialize(std::ostream& stream) const
+{
+    WriteCount(stream, m_types.size());
+    for (auto& entry : m_types)
+    {
+        auto& coverage = entry.second;
+        WriteString(stream, entry.first);
+        stream.put(coverage.IsMonitor ? 1 : 0);
+        WriteSet(stream, coverage.DeclaredStates);
+        WriteSet(stream, coverage.DeclaredEvents);
+        WriteSet(stream, coverage.States);
+        WriteSet(stream, coverage.Transitions);
+        WriteSet(stream, coverage.Events);
+    }
+
+    WriteCount(stream, m_programStates.size());
+    for (auto fingerprint : m_programStates)
+    {
+        stream.write(reinterpret_cast<const char*>(&fingerprint), sizeof(fingerprint));
+    }
+}
+
+bool TestingServices::CoverageInfo::Deserialize(std::istream& stream)
+{
+    m_types.clear();
+    m_declaredTypes.clear();
+    m_coveredItems.clear();
+    m_programStates.clear();
+
+    uint32_t count;
+    if (!ReadCount(stream, count))
+    {
+        return false;
+    }
+
+    std::string name;
+    for (; count > 0; count--)
+    {
+        if (!ReadString(stream, name))
+        {
+            return false;
+        }
+
+        auto& coverage = m_types[name];
+        coverage.IsMonitor = stream.get() == 1;
+        if (!ReadSet(stream, coverage.DeclaredStates) || !ReadSet(stream, coverage.DeclaredEvents) ||
+            !ReadSet(stream, coverage.States) || !ReadSet(stream, coverage.Transitions) ||
+            !ReadSet(stream, coverage.Events))
+        {
+            return false;
+        }
+    }
+
+    if (!ReadCount(stream, count))
+    {
+        return false;
+    }
+
+    for (uint64_t fingerprint; count > 0; count--)
+    {
+        if (!stream.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint)))
+        {
+            return false;
+        }
+
+        m_programStates.insert(fingerprint);
+    }
+
+    return true;
+}
+
+CoverageInfo::TypeCoverage& TestingServices::CoverageInfo::GetTypeCoverage(const std::type_info& type)
+{
+    return m_types[type.name()];
+}
+
+uint64_t TestingServices::CoverageInfo::GetItemHash(const std::type_info& type, int kind,
+    const std::string& first, const std::string& second)
+{
+    std::hash<std::string> hash;
+    uint64_t key = Mix(type.hash_code() ^ static_cast<uint64_t>(kind));
+    key = Mix(key ^ hash(first));
+    return Mix(key ^ hash(second));
+}
+
+TestingServices::CoverageInfo::~CoverageInfo() { }
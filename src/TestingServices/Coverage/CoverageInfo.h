@@ -0,0 +1,120 @@
+//-----------------------------------------------------------------------
+// <copyright file="CoverageInfo.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_COVERAGE_COVERAGEINFO_H
+#define MICROSOFT_P3_TESTINGSERVICES_COVERAGE_COVERAGEINFO_H
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <typeinfo>
+#include <unordered_set>
+#include <utility>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Activity coverage of a testing campaign: the states that machines and
+    // monitors entered, the transitions they took, and the events they handled
+    // in each state, grouped by type. Covered items are checked against a set
+    // of hashes first, so that recording an item that is already covered does
+    // not allocate.
+    class CoverageInfo
+    {
+    public:
+        CoverageInfo();
+        ~CoverageInfo();
+
+        // Checks if the states and events of the specified type are declared.
+        bool IsDeclared(const std::type_info& type) const;
+
+        // Declares a state of the specified type.
+        void DeclareState(const std::type_info& type, bool isMonitor, const std::string& state);
+
+        // Declares an event that the specified type handles in the specified state.
+        void DeclareEvent(const std::type_info& type, const std::string& state, const std::string& event);
+
+        // Records that an instance of the specified type entered a state.
+        void AddState(const std::type_info& type, const std::string& state);
+
+        // Records that an instance of the specified type transitioned between two states.
+        void AddTransition(const std::type_info& type, const std::string& from, const std::string& to);
+
+        // Records that an instance of the specified type handled an event in a state.
+        void AddEvent(const std::type_info& type, const std::string& state, const std::string& event);
+
+        // Returns the number of covered items, which only grows.
+        size_t GetNumOfCoveredItems() const;
+
+        // Records the fingerprint of a visited program state. Returns true if
+        // the state was not visited before.
+        bool AddProgramState(uint64_t fingerprint);
+
+        // Returns the number of distinct program states that were visited.
+        size_t GetNumOfProgramStates() const;
+
+        // Writes a human-readable coverage report.
+        void WriteReport(std::ostream& stream) const;
+
+        // Adds the declared and covered activities of the specified coverage.
+        void Merge(const CoverageInfo& that);
+
+        // Writes the declared and covered activities in a binary format, to
+        // pass them to another process.
+        void Serialize(std::ostream& stream) const;
+
+        // Reads activities in their binary format. Returns false if the
+        // stream does not contain valid coverage.
+        bool Deserialize(std::istream& stream);
+
+    private:
+        // Declared and covered activities of a machine or monitor type.
+        struct TypeCoverage
+        {
+            bool IsMonitor;
+            std::set<std::string> DeclaredStates;
+            std::set<std::pair<std::string, std::string>> DeclaredEvents;
+            std::set<std::string> States;
+            std::set<std::pair<std::string, std::string>> Transitions;
+            std::set<std::pair<std::string, std::string>> Events;
+        };
+
+        // Coverage per type name.
+        std::map<std::string, TypeCoverage> m_types;
+
+        // Hashes of the declared types.
+        std::unordered_set<size_t> m_declaredTypes;
+
+        // Hashes of the covered items.
+        std::unordered_set<uint64_t> m_coveredItems;
+
+        // Fingerprints of the visited program states.
+        std::unordered_set<uint64_t> m_programStates;
+
+        // Returns the coverage of the specified type.
+        TypeCoverage& GetTypeCoverage(const std::type_info& type);
+
+        // Returns the hash of a covered item.
+        static uint64_t GetItemHash(const std::type_info& type, int kind, const std::string& first,
+            const std::string& second);
+
+        // Copy is disabled.
+        CoverageInfo(const CoverageInfo& that) = delete;
+        CoverageInfo &operator=(CoverageInfo const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_COVERAGE_COVERAGEINFO_H
@@ -0,0 +1,77 @@
+//-----------------------------------------------------------------------
+// <copyright file="StateFingerprint.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "StateFingerprint.h"
+#include <functional>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+// Mixes the bits of the specified value using the SplitMix64 finalizer.
+static inline uint64_t Mix(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+TestingServices::StateFingerprint::StateFingerprint()
+{
+    m_value = 0;
+}
+
+uint64_t TestingServices::StateFingerprint::Get() const
+{
+    return m_value;
+}
+
+void TestingServices::StateFingerprint::Update(const void* component, uint64_t hash)
+{
+    auto entry = m_components.emplace(component, hash);
+    if (!entry.second)
+    {
+        m_value -= Mix(entry.first->second);
+        entry.first->second = hash;
+    }
+
+    m_value += Mix(hash);
+}
+
+void TestingServices::StateFingerprint::Remove(const void* component)
+{
+    auto entry = m_components.find(component);
+    if (entry != m_components.end())
+    {
+        m_value -= Mix(entry->second);
+        m_components.erase(entry);
+    }
+}
+
+void TestingServices::StateFingerprint::Clear()
+{
+    m_components.clear();
+    m_value = 0;
+}
+
+uint64_t TestingServices::StateFingerprint::Combine(uint64_t hash, uint64_t value)
+{
+    return Mix(hash ^ (value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2)));
+}
+
+uint64_t TestingServices::StateFingerprint::Hash(const std::string& value)
+{
+    return std::hash<std::string>()(value);
+}
+
+TestingServices::StateFingerprint::~StateFingerprint() { }
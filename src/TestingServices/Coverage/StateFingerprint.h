@@ -0,0 +1,65 @@
+//-----------------------------------------------------------------------
+// <copyright file="StateFingerprint.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_COVERAGE_STATEFINGERPRINT_H
+#define MICROSOFT_P3_TESTINGSERVICES_COVERAGE_STATEFINGERPRINT_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Incremental fingerprint of the program state of a testing iteration.
+    // The state consists of components, such as actors and monitors, whose
+    // hashes are summed after mixing, so that the fingerprint does not depend
+    // on their order, and a changed component is rehashed on its own.
+    class StateFingerprint
+    {
+    public:
+        StateFingerprint();
+        ~StateFingerprint();
+
+        // Returns the fingerprint of the program state.
+        uint64_t Get() const;
+
+        // Sets the hash of the specified component, adding it if needed.
+        void Update(const void* component, uint64_t hash);
+
+        // Removes the specified component from the program state.
+        void Remove(const void* component);
+
+        // Removes all components.
+        void Clear();
+
+        // Returns the combination of a hash with the specified value.
+        static uint64_t Combine(uint64_t hash, uint64_t value);
+
+        // Returns the hash of the specified string.
+        static uint64_t Hash(const std::string& value);
+
+    private:
+        // Hashes of the components.
+        std::unordered_map<const void*, uint64_t> m_components;
+
+        // Sum of the mixed hashes of the components.
+        uint64_t m_value;
+
+        // Copy is disabled.
+        StateFingerprint(const StateFingerprint& that) = delete;
+        StateFingerprint &operator=(StateFingerprint const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_COVERAGE_STATEFINGERPRINT_H
@@ -14,14 +14,94 @@
 
 #include "P3/TestingServices/BugFindingEngine.h"
 #include "P3/TestingServices/ExplorationStrategy.h"
+#include "../Coverage/CoverageInfo.h"
+#include "../ExplorationStrategies/CoverageGuidedStrategy.h"
+#include "../ExplorationStrategies/DFSStrategy.h"
+#include "../ExplorationStrategies/DelayBoundingStrategy.h"
+#include "../ExplorationStrategies/InputDrivenStrategy.h"
+#include "../ExplorationStrategies/PCTStrategy.h"
+#include "../ExplorationStrategies/ProductionReplayStrategy.h"
 #include "../ExplorationStrategies/RandomStrategy.h"
+#include "../ExplorationStrategies/ReplayStrategy.h"
+#include "../ExplorationStrategies/RoundRobinStrategy.h"
+#include "../ExplorationStrategies/StrategyPortfolio.h"
+#include "../Tracing/ScheduleTrace.h"
+#include "../Tracing/TraceMinimizer.h"
+#include "../../Exceptions/ExecutionCanceledException.h"
 #include "../../Runtime/BugFindingRuntime.h"
+#include "../../Runtime/RuntimeQuarantine.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 
+#ifdef __linux__
+#include <cerrno>
+#include <vector>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 using namespace Microsoft::P3;
 using namespace TestingServices;
 
+// Header of the campaign file format.
+static const char CampaignMagic[4] = { 'P', '3', 'C', 'P' };
+static const uint8_t CampaignVersion = 3;
+
+// Writes a value in its binary format.
+template<typename T>
+static void WriteValue(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Reads a value in its binary format.
+template<typename T>
+static bool ReadValue(std::istream& stream, T& value)
+{
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Writes a length-prefixed block of data.
+static void WriteBlock(std::ostream& stream, const std::string& data)
+{
+    WriteValue(stream, static_cast<uint32_t>(data.size()));
+    stream.write(data.data(), data.size());
+}
+
+// Reads a length-prefixed block of data.
+static bool ReadBlock(std::istream& stream, std::string& data)
+{
+    uint32_t size;
+    if (!ReadValue(stream, size))
+    {
+        return false;
+    }
+
+    // The size is not trusted, so the data is read in chunks, and a
+    // truncated or corrupted block fails before allocating its whole size.
+    const uint32_t chunkSize = 64 * 1024;
+    data.clear();
+    while (data.size() < size)
+    {
+        size_t offset = data.size();
+        size_t count = std::min<size_t>(chunkSize, size - offset);
+        data.resize(offset + count);
+        if (!stream.read(&data[offset], count))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 BugFindingEngine* TestingServices::BugFindingEngine::Create(std::unique_ptr<Configuration> configuration,
     TestAction action)
 {
@@ -34,60 +114,1217 @@ TestingServices::BugFindingEngine::BugFindingEngine(std::unique_ptr<Configuratio
     m_configuration = move(configuration);
     m_report = std::make_unique<TestReport>();
     m_testAction = action;
+    m_quarantine = std::make_unique<RuntimeQuarantine>();
+    m_hasDeadline = false;
+    m_firstIteration = 0;
+    m_numOfRewardedIterations = 0;
     Initialize();
 }
 
+std::unique_ptr<IExplorationStrategy> TestingServices::BugFindingEngine::CreateStrategy(ExplorationStrategy kind,
+    int bound)
+{
+    if (kind == ExplorationStrategy::Random)
+    {
+        // Use the random scheduling strategy.
+        std::unique_ptr<RandomStrategy> strategy(new RandomStrategy(m_configuration->RandomSchedulingSeed));
+        return move(strategy);
+    }
+    else if (kind == ExplorationStrategy::Replay)
+    {
+        ScheduleTrace trace;
+        if (!trace.LoadFromFile(m_configuration->ScheduleFile))
+        {
+            throw std::invalid_argument("Cannot read schedule trace '" + m_configuration->ScheduleFile + "'.");
+        }
+
+        // Replay the trace once, with logging enabled.
+        std::unique_ptr<ReplayStrategy> strategy(new ReplayStrategy(trace));
+        m_configuration->SchedulingIterations = 1;
+        m_configuration->Verbosity = true;
+        return move(strategy);
+    }
+    else if (kind == ExplorationStrategy::CoverageGuided)
+    {
+        // Use the random scheduling strategy, guided by activity coverage.
+        std::unique_ptr<CoverageGuidedStrategy> strategy(
+            new CoverageGuidedStrategy(m_configuration->RandomSchedulingSeed));
+        return move(strategy);
+    }
+    else if (kind == ExplorationStrategy::InputDriven)
+    {
+        // Use the strategy that follows the input given to RunInput.
+        std::unique_ptr<InputDrivenStrategy> strategy(new InputDrivenStrategy());
+        return move(strategy);
+    }
+    else if (kind == ExplorationStrategy::RoundRobin)
+    {
+        // Use the deterministic round-robin strategy.
+        std::unique_ptr<RoundRobinStrategy> strategy(new RoundRobinStrategy());
+        return move(strategy);
+    }
+    else if (kind == ExplorationStrategy::DelayBounding)
+    {
+        // Use the round-robin strategy with a bounded number of random delays.
+        std::unique_ptr<DelayBoundingStrategy> strategy(new DelayBoundingStrategy(
+            m_configuration->RandomSchedulingSeed, bound));
+        return move(strategy);
+    }
+    else if (kind == ExplorationStrategy::PCT)
+    {
+        // Use the probabilistic concurrency testing strategy.
+        std::unique_ptr<PCTStrategy> strategy(new PCTStrategy(
+            m_configuration->RandomSchedulingSeed, bound));
+        return move(strategy);
+    }
+    else if (kind == ExplorationStrategy::DFS)
+    {
+        // Use the systematic depth-first strategy.
+        std::unique_ptr<DFSStrategy> strategy(new DFSStrategy());
+        return move(strategy);
+    }
+    else if (kind == ExplorationStrategy::ProductionReplay)
+    {
+        std::vector<EventTraceRecorder::Record> records;
+        if (!EventTraceRecorder::LoadFromFile(m_configuration->EventTraceFile, records))
+        {
+            throw std::invalid_argument("Cannot read event trace '" + m_configuration->EventTraceFile + "'.");
+        }
+
+        // Replay the trace, and then explore the schedules around it.
+        std::unique_ptr<ProductionReplayStrategy> strategy(new ProductionReplayStrategy(records,
+            m_configuration->RandomSchedulingSeed, bound));
+        return move(strategy);
+    }
+
+    return nullptr;
+}
+
 // Initializes the engine.
 void TestingServices::BugFindingEngine::Initialize()
 {
-    if (m_configuration->Strategy == ExplorationStrategy::Random)
+    m_strategy = CreateStrategy(m_configuration->Strategy, m_configuration->StrategyBound);
+
+    // A resumed campaign initializes the engine again, and keeps its coverage.
+    if (m_coverage == nullptr && (m_configuration->ReportActivityCoverage ||
+        m_configuration->EnableStrategyPortfolio || m_configuration->EnableStateHashing ||
+        m_configuration->Strategy == ExplorationStrategy::CoverageGuided))
     {
-        // Use the random scheduling strategy.
-        std::unique_ptr<RandomStrategy> strategy(new RandomStrategy());
-        m_strategy = move(strategy);
+        m_coverage = std::make_unique<CoverageInfo>();
     }
 }
 
 void TestingServices::BugFindingEngine::Run()
 {
     Log(". Testing started");
+    if (!m_configuration->CampaignFile.empty() && m_configuration->Strategy != ExplorationStrategy::Replay)
+    {
+        LoadCampaign();
+    }
 
-    int maxIterations = m_configuration->SchedulingIterations;
-    for (int i = 0; i < maxIterations; i++)
+    if (m_configuration->Strategy == ExplorationStrategy::Random ||
+        m_configuration->Strategy == ExplorationStrategy::CoverageGuided ||
+        m_configuration->Strategy == ExplorationStrategy::DelayBounding ||
+        m_configuration->Strategy == ExplorationStrategy::PCT ||
+        m_configuration->Strategy == ExplorationStrategy::ProductionReplay)
     {
+        Log("... Random seed: " + std::to_string(m_configuration->RandomSchedulingSeed));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    m_hasDeadline = m_configuration->Timeout > 0;
+    m_deadline = start + std::chrono::seconds(m_configuration->Timeout);
+
+    if (m_configuration->ForkedProcesses > 0 && m_configuration->Strategy != ExplorationStrategy::Replay)
+    {
+        RunForkedProcesses();
+    }
+    else
+    {
+        RunIterations(m_firstIteration, 1, -1);
+    }
+
+    m_report->TestingTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (m_configuration->EnableStateHashing)
+    {
+        m_report->NumOfProgramStates = m_coverage->GetNumOfProgramStates();
+    }
+
+    Log("... Explored " + std::to_string(m_report->NumOfExploredSchedules) + " schedules in " +
+        std::to_string(m_report->TestingTime) + " sec (" +
+        std::to_string(m_report->GetSchedulesPerSecond()) + " schedules/sec)");
+    if (m_report->NumOfCutOffSchedules > 0)
+    {
+        Log("... Cut off " + std::to_string(m_report->NumOfCutOffSchedules) + " schedules");
+    }
+
+    if (m_report->NumOfDeadlocks > 0 || m_report->NumOfHangs > 0)
+    {
+        Log("... Found " + std::to_string(m_report->NumOfDeadlocks) + " deadlocks and " +
+            std::to_string(m_report->NumOfHangs) + " hangs");
+    }
+
+    Log("... Scheduling steps: " + std::to_string(m_report->MinExploredSteps) + " min, " +
+        std::to_string(m_report->GetAverageExploredSteps()) + " avg, " +
+        std::to_string(m_report->MaxExploredSteps) + " max");
+
+    switch (m_report->Termination)
+    {
+    case TestReport::TerminationReason::Timeout:
+        Log("... Stopped because the time budget was exhausted");
+        break;
+    case TestReport::TerminationReason::BugFound:
+        Log("... Stopped because a bug was found");
+        break;
+    case TestReport::TerminationReason::StrategyExhausted:
+        Log("... Stopped because there are no more schedules to explore");
+        break;
+    case TestReport::TerminationReason::HangLimit:
+        Log("... Stopped because too many hung iterations are still blocked");
+        break;
+    default:
+        Log("... Stopped because the iteration limit was reached");
+        break;
+    }
+
+    if (m_coverage != nullptr)
+    {
+        Log("... Covered " + std::to_string(m_coverage->GetNumOfCoveredItems()) +
+            " states, transitions and events");
+    }
+
+    if (m_configuration->EnableStateHashing)
+    {
+        Log("... Visited " + std::to_string(m_report->NumOfProgramStates) + " distinct program states");
+    }
+
+    if (!m_configuration->OutputFilePath.empty())
+    {
+        auto path = m_configuration->OutputFilePath + "/test_report.json";
+        std::ofstream file(path, std::ios::trunc);
+        file << m_report->ToJson() << std::endl;
+        Log(file ? "... Writing " + path : "... Failed to write " + path);
+
+        if (m_configuration->ReportActivityCoverage)
+        {
+            auto coveragePath = m_configuration->OutputFilePath + "/coverage_report.txt";
+            std::ofstream coverageFile(coveragePath, std::ios::trunc);
+            m_coverage->WriteReport(coverageFile);
+            Log(coverageFile ? "... Writing " + coveragePath : "... Failed to write " + coveragePath);
+        }
+    }
+
+    if (!m_configuration->CampaignFile.empty() && m_configuration->Strategy != ExplorationStrategy::Replay)
+    {
+        SaveCampaign();
+    }
+
+    Log(". Done");
+}
+
+bool TestingServices::BugFindingEngine::RunInput(const uint8_t* data, size_t size)
+{
+    if (m_configuration->Strategy != ExplorationStrategy::InputDriven)
+    {
+        throw std::logic_error("Running an input requires the input-driven strategy.");
+    }
+
+    auto strategy = static_cast<InputDrivenStrategy*>(m_strategy.get());
+    strategy->SetInput(data, size);
+
+    int iteration = m_report->NumOfExploredSchedules;
+    int numOfFoundBugs = m_report->NumOfFoundBugs;
+    strategy->PrepareForNextIteration(iteration);
+    RunNextIteration(iteration);
+    return m_report->NumOfFoundBugs > numOfFoundBugs;
+}
+
+void TestingServices::BugFindingEngine::RunIterations(int first, int stride, int end)
+{
+    // Without an iteration count, the timeout is the only stopping criterion.
+    int maxIterations = end >= 0 ? end : m_firstIteration + m_configuration->SchedulingIterations;
+    bool isUnbounded = end < 0 && m_configuration->SchedulingIterations <= 0 && m_hasDeadline;
+
+    m_report->Termination = TestReport::TerminationReason::IterationLimit;
+    for (int i = first; isUnbounded || i < maxIterations; i += stride)
+    {
+        if (m_hasDeadline && std::chrono::steady_clock::now() >= m_deadline)
+        {
+            m_report->Termination = TestReport::TerminationReason::Timeout;
+            break;
+        }
+
+        if (m_quarantine->IsFull())
+        {
+            m_report->Termination = TestReport::TerminationReason::HangLimit;
+            break;
+        }
+
+        if (!m_strategy->PrepareForNextIteration(i))
+        {
+            m_report->Termination = TestReport::TerminationReason::StrategyExhausted;
+            break;
+        }
+
         // Runs a new testing iteration.
         RunNextIteration(i);
 
         if (m_report->NumOfFoundBugs > 0)
         {
+            m_report->Termination = TestReport::TerminationReason::BugFound;
             break;
         }
     }
-    
-    Log(". Done");
+}
+
+void TestingServices::BugFindingEngine::RunForkedProcesses()
+{
+#ifdef __linux__
+    bool hasForked;
+    if (m_configuration->EnableStrategyPortfolio)
+    {
+        hasForked = RunStrategyPortfolio();
+    }
+    else
+    {
+        Log("... Exploring " + std::to_string(m_configuration->ForkedProcesses) +
+            " slices of the schedules in forked processes");
+        hasForked = RunForkedRound(m_firstIteration, -1, nullptr, std::vector<size_t>());
+    }
+
+    if (!hasForked)
+    {
+        Log("... Failed to fork processes");
+        RunIterations(m_firstIteration, 1, -1);
+    }
+#else
+    Log("... Forked processes are only supported on Linux");
+    RunIterations(m_firstIteration, 1, -1);
+#endif
+}
+
+#ifdef __linux__
+// The iterations of a round of forked processes. They are split in slices,
+// which each run every n-th iteration with a strategy of their own, one
+// iteration at a time, in a process forked for it.
+struct TestingServices::BugFindingEngine::ForkedRound
+{
+    // A slice of the iterations of the round.
+    struct Slice
+    {
+        // The iteration that runs, or that runs next.
+        int Iteration;
+
+        // The process that runs the iteration, or -1, the pipe that it writes
+        // its result to, and the part of the result read so far.
+        pid_t Process;
+        int Pipe;
+        std::string Result;
+
+        // The activities that the slice covered, if they are recorded.
+        std::unique_ptr<CoverageInfo> Coverage;
+
+        // Number of iterations of the slice, of those that were rewarded, and
+        // of the bugs that they found.
+        int NumOfIterations;
+        long long NumOfRewardedIterations;
+        int NumOfFoundBugs;
+
+        // Set once the slice runs no more iterations, and if its strategy has
+        // no more schedules to explore.
+        bool IsDone;
+        bool IsExhausted;
+    };
+
+    // A bug found by a slice.
+    struct FoundBug
+    {
+        ScheduleTrace Trace;
+        std::string Report;
+        int Bug;
+    };
+
+    // The end of the round, or -1 for the configured limit.
+    int End;
+
+    // The portfolio that assigned the strategies of the slices, if any, and
+    // the arm of each slice.
+    StrategyPortfolio* Portfolio;
+    const std::vector<size_t>* Arms;
+
+    // The slices of the round.
+    std::vector<Slice> Slices;
+
+    // Number of processes forked during the round, and whether forking failed.
+    int NumOfForkedProcesses;
+    bool HasFailed;
+
+    // The slice whose iteration this process runs, if it was forked, or -1,
+    // and the pipe that it writes its result to.
+    int ForkedSlice;
+    int Pipe;
+
+    // Number of steps of the trace that the iteration took before the fork,
+    // and the time and coverage of the iteration at the fork.
+    size_t NumOfPrefixSteps;
+    std::chrono::steady_clock::time_point Start;
+    size_t NumOfCoveredItems;
+
+    // The bugs found during the round. They are handled once the iteration
+    // that forked the processes stopped, as minimizing them runs the test.
+    std::vector<FoundBug> Bugs;
+};
+#endif
+
+bool TestingServices::BugFindingEngine::RunForkedRound(int first, int end, StrategyPortfolio* portfolio,
+    const std::vector<size_t>& arms)
+{
+#ifdef __linux__
+    // The testing process keeps the strategy of each slice, so that the slices
+    // explore disjoint schedules, and the campaign saves their progress. The
+    // slices of a portfolio get the strategies of their arms every round.
+    int numOfProcesses = m_configuration->ForkedProcesses;
+    if (portfolio != nullptr || m_slices.size() != static_cast<size_t>(numOfProcesses))
+    {
+        m_slices.clear();
+        for (int i = 0; i < numOfProcesses; i++)
+        {
+            auto strategy = portfolio != nullptr ?
+                CreateStrategy(portfolio->Get(arms[i]).Strategy, portfolio->Get(arms[i]).Bound) :
+                CreateStrategy(m_configuration->Strategy, m_configuration->StrategyBound);
+            strategy->SetSlice(i, numOfProcesses);
+            m_slices.push_back(move(strategy));
+        }
+    }
+
+    ForkedRound round;
+    round.End = end;
+    round.Portfolio = portfolio;
+    round.Arms = &arms;
+    round.NumOfForkedProcesses = 0;
+    round.HasFailed = false;
+    round.ForkedSlice = -1;
+    round.Pipe = -1;
+    round.NumOfPrefixSteps = 0;
+    round.NumOfCoveredItems = 0;
+    for (int i = 0; i < numOfProcesses; i++)
+    {
+        ForkedRound::Slice slice;
+        slice.Iteration = first + i;
+        slice.Process = -1;
+        slice.Pipe = -1;
+        if (m_coverage != nullptr)
+        {
+            slice.Coverage = std::make_unique<CoverageInfo>();
+            slice.Coverage->Merge(*m_coverage);
+        }
+
+        slice.NumOfIterations = 0;
+        slice.NumOfRewardedIterations = 0;
+        slice.NumOfFoundBugs = 0;
+        slice.IsDone = false;
+        slice.IsExhausted = false;
+        round.Slices.push_back(std::move(slice));
+    }
+
+    // The steps of an iteration before its first choice do not depend on the
+    // strategy. In single-thread mode, the testing process runs them without
+    // any other thread, so it runs them once, and forks every iteration from
+    // its first choice. A production trace is replayed from the first step.
+    bool isForked = false;
+    bool hasPrefix = false;
+    if (m_configuration->EnableSingleThreadMode && m_configuration->Strategy != ExplorationStrategy::ProductionReplay)
+    {
+        StartIteration();
+        m_strategy->PrepareForNextIteration(first);
+        auto scheduler = m_runtime->GetScheduler();
+        scheduler->SetPrefixHandler([this, &round, &isForked, &hasPrefix, scheduler]()
+        {
+            hasPrefix = true;
+            round.NumOfPrefixSteps = scheduler->GetTrace().Count();
+            isForked = RunSlices(round);
+            if (!isForked)
+            {
+                // The forked processes ran the rest of the iterations.
+                scheduler->Stop();
+            }
+
+            // The iteration continues from the fork, with the strategy and the
+            // coverage of its slice.
+            Log("... Iteration #" + std::to_string(round.Slices[round.ForkedSlice].Iteration + 1));
+            round.Start = std::chrono::steady_clock::now();
+            round.NumOfCoveredItems = m_coverage != nullptr ? m_coverage->GetNumOfCoveredItems() : 0;
+            SetIterationDeadline();
+        });
+
+        try
+        {
+            m_runtime->RunTest(m_testAction);
+        }
+        catch (const ExecutionCanceledException&)
+        {
+            // The first choice of the iteration can be in the test itself.
+        }
+
+        m_runtime->Wait();
+    }
+
+    // An iteration that is cut off, or that has no choice, forks from its start.
+    if (!hasPrefix)
+    {
+        isForked = RunSlices(round);
+    }
+
+    if (isForked)
+    {
+        auto iteration = round.Slices[round.ForkedSlice].Iteration;
+        if (hasPrefix)
+        {
+            CompleteIteration(iteration, round.Start, round.NumOfCoveredItems, round.NumOfPrefixSteps);
+        }
+        else
+        {
+            RunNextIteration(iteration);
+        }
+
+        ExitForkedProcess(round);
+    }
+
+    for (auto& bug : round.Bugs)
+    {
+        HandleBug(bug.Trace, bug.Report, bug.Bug);
+    }
+
+    for (size_t i = 0; portfolio != nullptr && i < round.Slices.size(); i++)
+    {
+        auto& slice = round.Slices[i];
+        portfolio->Update(arms[i], slice.NumOfIterations, slice.NumOfRewardedIterations, slice.NumOfFoundBugs);
+    }
+
+    if (round.HasFailed && round.NumOfForkedProcesses > 0)
+    {
+        Log("... Failed to fork some processes");
+    }
+
+    return round.NumOfForkedProcesses > 0 || !round.HasFailed;
+#else
+    return false;
+#endif
+}
+
+#ifdef __linux__
+bool TestingServices::BugFindingEngine::RunSlices(ForkedRound& round)
+{
+    // Without an iteration count, the timeout is the only stopping criterion.
+    int maxIterations = round.End >= 0 ? round.End : m_firstIteration + m_configuration->SchedulingIterations;
+    bool isUnbounded = round.End < 0 && m_configuration->SchedulingIterations <= 0 && m_hasDeadline;
+    int numOfSlices = static_cast<int>(round.Slices.size());
+    bool isTimedOut = false;
+    for (;;)
+    {
+        // Once a bug is found, or the budget runs out, the round ends when
+        // the running iterations complete.
+        if (!isTimedOut && m_hasDeadline && std::chrono::steady_clock::now() >= m_deadline)
+        {
+            isTimedOut = true;
+        }
+
+        bool isStopped = isTimedOut || m_report->NumOfFoundBugs > 0;
+        std::vector<pollfd> pipes;
+        std::vector<size_t> running;
+        for (size_t i = 0; i < round.Slices.size(); i++)
+        {
+            auto& slice = round.Slices[i];
+            if (slice.Process < 0 && !slice.IsDone)
+            {
+                if (isStopped || (!isUnbounded && slice.Iteration >= maxIterations))
+                {
+                    slice.IsDone = true;
+                    continue;
+                }
+
+                if (!m_slices[i]->PrepareForNextIteration(slice.Iteration))
+                {
+                    slice.IsDone = true;
+                    slice.IsExhausted = true;
+                    continue;
+                }
+
+                // The slice cannot continue without the progress of its iterations.
+                int fds[2];
+                if (pipe(fds) != 0)
+                {
+                    round.HasFailed = true;
+                    slice.IsDone = true;
+                    continue;
+                }
+
+                std::cout.flush();
+                pid_t pid = fork();
+                if (pid == 0)
+                {
+                    close(fds[0]);
+                    for (auto& other : round.Slices)
+                    {
+                        if (other.Process >= 0)
+                        {
+                            close(other.Pipe);
+                        }
+                    }
+
+                    round.ForkedSlice = static_cast<int>(i);
+                    round.Pipe = fds[1];
+
+                    // The testing process writes the traces of the found bugs,
+                    // and merges the report of the iteration into its own.
+                    m_configuration->OutputFilePath.clear();
+                    m_configuration->EnableScheduleMinimization = false;
+                    m_report = std::make_unique<TestReport>();
+                    m_numOfRewardedIterations = 0;
+                    if (round.Portfolio != nullptr)
+                    {
+                        auto& arm = round.Portfolio->Get((*round.Arms)[i]);
+                        m_configuration->Strategy = arm.Strategy;
+                        m_configuration->StrategyBound = arm.Bound;
+                    }
+
+                    // Only the forking thread exists in this process, so a
+                    // runtime whose handlers ran on other threads cannot be
+                    // used, or destroyed.
+                    if (!m_configuration->EnableSingleThreadMode)
+                    {
+                        m_runtime.release();
+                    }
+
+                    m_strategy = move(m_slices[i]);
+                    m_coverage = move(slice.Coverage);
+                    if (m_runtime != nullptr)
+                    {
+                        m_runtime->GetScheduler()->SetStrategy(m_strategy.get());
+                        m_runtime->SetCoverage(m_coverage.get());
+                    }
+
+                    return true;
+                }
+
+                close(fds[1]);
+                if (pid < 0)
+                {
+                    close(fds[0]);
+                    round.HasFailed = true;
+                    slice.IsDone = true;
+                    continue;
+                }
+
+                slice.Process = pid;
+                slice.Pipe = fds[0];
+                slice.Result.clear();
+                round.NumOfForkedProcesses++;
+            }
+
+            if (slice.Process >= 0)
+            {
+                pipes.push_back({ slice.Pipe, POLLIN, 0 });
+                running.push_back(i);
+            }
+        }
+
+        if (pipes.empty())
+        {
+            break;
+        }
+
+        if (poll(pipes.data(), pipes.size(), -1) < 0)
+        {
+            // Interrupted by a signal.
+            continue;
+        }
+
+        for (size_t j = 0; j < pipes.size(); j++)
+        {
+            if (pipes[j].revents == 0)
+            {
+                continue;
+            }
+
+            auto& slice = round.Slices[running[j]];
+            char buffer[64 * 1024];
+            auto count = read(slice.Pipe, buffer, sizeof(buffer));
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (count > 0)
+            {
+                slice.Result.append(buffer, static_cast<size_t>(count));
+                continue;
+            }
+
+            // The process closed its pipe when it exited.
+            close(slice.Pipe);
+            int status;
+            waitpid(slice.Process, &status, 0);
+            slice.Process = -1;
+            MergeSliceResult(round, running[j], status);
+            slice.Iteration += numOfSlices;
+        }
+    }
+
+    bool isExhausted = true;
+    for (auto& slice : round.Slices)
+    {
+        isExhausted = isExhausted && slice.IsExhausted;
+    }
+
+    if (m_report->NumOfFoundBugs > 0)
+    {
+        m_report->Termination = TestReport::TerminationReason::BugFound;
+    }
+    else if (isTimedOut)
+    {
+        m_report->Termination = TestReport::TerminationReason::Timeout;
+    }
+    else if (isExhausted)
+    {
+        m_report->Termination = TestReport::TerminationReason::StrategyExhausted;
+    }
+    else
+    {
+        m_report->Termination = TestReport::TerminationReason::IterationLimit;
+    }
+
+    return false;
+}
+
+void TestingServices::BugFindingEngine::MergeSliceResult(ForkedRound& round, size_t index, int status)
+{
+    auto& slice = round.Slices[index];
+    std::istringstream result(slice.Result);
+    TestReport report;
+    long long rewardedIterations;
+    uint8_t hasCoverage;
+    CoverageInfo coverage;
+    std::string progress;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || !report.Deserialize(result) ||
+        !ReadValue(result, rewardedIterations) || !ReadValue(result, hasCoverage) ||
+        (hasCoverage == 1 && !coverage.Deserialize(result)) || !ReadBlock(result, progress))
+    {
+        // The progress of the slice was lost with the process, so it stops.
+        Log("... Forked process of iteration #" + std::to_string(slice.Iteration + 1) + " terminated abnormally");
+        slice.IsDone = true;
+        return;
+    }
+
+    m_report->Merge(report);
+    slice.NumOfIterations += report.NumOfExploredSchedules;
+    slice.NumOfRewardedIterations += rewardedIterations;
+    slice.NumOfFoundBugs += report.NumOfFoundBugs;
+
+    // Each slice only builds on its own coverage, so that the reward of its
+    // strategy does not depend on the order in which the results are merged.
+    if (hasCoverage == 1 && m_coverage != nullptr)
+    {
+        slice.Coverage->Merge(coverage);
+        m_coverage->Merge(coverage);
+    }
+
+    std::istringstream progressStream(progress);
+    if (!m_slices[index]->LoadProgress(progressStream))
+    {
+        Log("... Forked process of iteration #" + std::to_string(slice.Iteration + 1) + " reported invalid progress");
+        slice.IsDone = true;
+    }
+
+    uint8_t hasBug;
+    ScheduleTrace trace;
+    if (ReadValue(result, hasBug) && hasBug == 1 && trace.Deserialize(result))
+    {
+        std::string bugReport((std::istreambuf_iterator<char>(result)), std::istreambuf_iterator<char>());
+        std::string process = "#" + std::to_string(index + 1);
+        if (round.Portfolio != nullptr)
+        {
+            process += " (" + round.Portfolio->GetName((*round.Arms)[index]) + ")";
+        }
+
+        Log("..... Slice " + process + " found a bug in iteration #" + std::to_string(trace.Iteration + 1));
+        round.Bugs.push_back({ std::move(trace), std::move(bugReport), m_report->NumOfFoundBugs });
+    }
+}
+
+void TestingServices::BugFindingEngine::ExitForkedProcess(ForkedRound& round)
+{
+    std::ostringstream result;
+    m_report->Serialize(result);
+    WriteValue(result, m_numOfRewardedIterations);
+    WriteValue(result, static_cast<uint8_t>(m_coverage != nullptr ? 1 : 0));
+    if (m_coverage != nullptr)
+    {
+        m_coverage->Serialize(result);
+    }
+
+    std::ostringstream progress;
+    m_strategy->SaveProgress(progress);
+    WriteBlock(result, progress.str());
+
+    WriteValue(result, static_cast<uint8_t>(m_report->NumOfFoundBugs > 0 ? 1 : 0));
+    if (m_report->NumOfFoundBugs > 0)
+    {
+        m_runtime->GetScheduler()->GetTrace().Serialize(result);
+        result << m_runtime->GetScheduler()->BugReport;
+    }
+
+    auto data = result.str();
+    for (size_t written = 0; written < data.size();)
+    {
+        auto count = write(round.Pipe, data.data() + written, data.size() - written);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (count <= 0)
+        {
+            break;
+        }
+
+        written += static_cast<size_t>(count);
+    }
+
+    close(round.Pipe);
+    std::cout.flush();
+    _exit(0);
+}
+#endif
+
+bool TestingServices::BugFindingEngine::RunStrategyPortfolio()
+{
+    int numOfProcesses = m_configuration->ForkedProcesses;
+    int numOfIterations = m_configuration->SchedulingIterations;
+    int maxIterations = m_firstIteration + numOfIterations;
+    bool isUnbounded = numOfIterations <= 0 && m_hasDeadline;
+
+    // Rounds are long enough to measure the strategies, and short enough
+    // to leave several chances to rebalance them.
+    int roundIterations = isUnbounded ? numOfProcesses * 64 : std::max(numOfProcesses, numOfIterations / 8);
+
+    // A resumed campaign keeps the statistics of the strategies.
+    if (m_portfolio == nullptr)
+    {
+        m_portfolio = std::make_unique<StrategyPortfolio>();
+    }
+
+    auto& portfolio = *m_portfolio;
+    Log("... Forking " + std::to_string(numOfProcesses) + " processes with a portfolio of " +
+        std::to_string(portfolio.Size()) + " strategies");
+
+    std::vector<size_t> arms;
+    for (int first = m_firstIteration; isUnbounded || first < maxIterations; first += roundIterations)
+    {
+        int end = isUnbounded ? first + roundIterations : std::min(first + roundIterations, maxIterations);
+        portfolio.Assign(numOfProcesses, (end - first) / numOfProcesses, arms);
+        if (!RunForkedRound(first, end, &portfolio, arms))
+        {
+            if (first == m_firstIteration)
+            {
+                return false;
+            }
+
+            Log("... Failed to fork processes");
+            break;
+        }
+
+        if (m_report->Termination != TestReport::TerminationReason::IterationLimit)
+        {
+            break;
+        }
+    }
+
+    for (size_t arm = 0; arm < portfolio.Size(); arm++)
+    {
+        auto& entry = portfolio.Get(arm);
+        Log("..... " + portfolio.GetName(arm) + ": " + std::to_string(entry.NumOfIterations) +
+            " iterations, " + std::to_string(entry.NumOfRewardedIterations) + " rewarded, " +
+            std::to_string(entry.NumOfFoundBugs) + " bugs");
+    }
+
+    // The slices of a portfolio round only live for that round, so the campaign keeps none.
+    m_slices.clear();
+    return true;
 }
 
 void TestingServices::BugFindingEngine::RunNextIteration(int iteration)
 {
     Log("... Iteration #" + std::to_string(iteration + 1));
-
-    // Copy the configuration to pass it to the runtime.
-    std::unique_ptr<Configuration> configuration(Configuration::CopyFrom(*(m_configuration.get())));
-    
-    // Creates a new instance of the bug-finding runtime.
-    std::unique_ptr<BugFindingRuntime> runtime(new BugFindingRuntime(move(configuration), m_strategy.get()));
+    auto start = std::chrono::steady_clock::now();
+    size_t numOfCoveredItems = StartIteration();
 
     // Run the test.
-    m_testAction(*(runtime.get()));
+    m_runtime->RunTest(m_testAction);
 
     // Wait for the runtime to terminate execution.
-    runtime->Wait();
+    m_runtime->Wait();
+
+    CompleteIteration(iteration, start, numOfCoveredItems, 0);
+}
+
+size_t TestingServices::BugFindingEngine::StartIteration()
+{
+    // The runtime is created once, and reset for each later iteration.
+    if (m_runtime == nullptr)
+    {
+        // Copy the configuration to pass it to the runtime.
+        std::unique_ptr<Configuration> configuration(Configuration::CopyFrom(*(m_configuration.get())));
+        m_runtime.reset(new BugFindingRuntime(move(configuration), m_strategy.get()));
+    }
+    else
+    {
+        m_runtime->Reset();
+    }
+
+    m_runtime->SetCoverage(m_coverage.get());
+    SetIterationDeadline();
+    return m_coverage != nullptr ? m_coverage->GetNumOfCoveredItems() : 0;
+}
+
+void TestingServices::BugFindingEngine::SetIterationDeadline()
+{
+    // Cut the iteration off when either its own or the campaign budget runs out.
+    if (m_configuration->IterationTimeout > 0)
+    {
+        auto deadline = std::chrono::steady_clock::now() +
+            std::chrono::milliseconds(m_configuration->IterationTimeout);
+        m_runtime->GetScheduler()->SetDeadline(m_hasDeadline ? std::min(deadline, m_deadline) : deadline);
+    }
+    else if (m_hasDeadline)
+    {
+        m_runtime->GetScheduler()->SetDeadline(m_deadline);
+    }
+}
+
+void TestingServices::BugFindingEngine::CompleteIteration(int iteration, std::chrono::steady_clock::time_point start,
+    size_t numOfCoveredItems, size_t numOfPrefixSteps)
+{
+    auto runtime = m_runtime.get();
+    m_report->RecordIteration(static_cast<int>(runtime->GetScheduler()->GetNumOfSchedulingSteps()),
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+        runtime->GetNumOfCreatedActors(), runtime->GetNumOfSentEvents());
+    if (runtime->GetScheduler()->IsCutOff && !runtime->GetScheduler()->BugFound)
+    {
+        m_report->NumOfCutOffSchedules++;
+    }
+
+    bool isCovering = m_coverage != nullptr && m_coverage->GetNumOfCoveredItems() > numOfCoveredItems;
+    if (isCovering || runtime->GetScheduler()->BugFound)
+    {
+        m_numOfRewardedIterations++;
+    }
+
+    if (m_configuration->Strategy == ExplorationStrategy::CoverageGuided)
+    {
+        auto strategy = static_cast<CoverageGuidedStrategy*>(m_strategy.get());
+        strategy->NotifyIterationCompleted(runtime->GetScheduler()->GetTrace(), numOfPrefixSteps, isCovering);
+    }
 
     if (runtime->GetScheduler()->BugFound)
     {
         m_report->NumOfFoundBugs++;
+        m_report->BugIterations.push_back(iteration);
         Log("..... Iteration #" + std::to_string(iteration + 1) + " triggered bug #" +
             std::to_string(m_report->NumOfFoundBugs));
+
+        // The log is only formatted now, before minimization reuses the runtime.
+        if (m_configuration->LogBufferSize > 0)
+        {
+            SaveLog("bug_" + std::to_string(m_report->NumOfFoundBugs));
+        }
+
+        auto& trace = runtime->GetScheduler()->GetTrace();
+        trace.Seed = m_configuration->RandomSchedulingSeed;
+        trace.Iteration = iteration;
+        HandleBug(trace, runtime->GetScheduler()->BugReport, m_report->NumOfFoundBugs);
+    }
+    else if (runtime->GetScheduler()->IsDeadlocked || runtime->GetScheduler()->IsHung)
+    {
+        // Deadlocks and hangs are reported, but the campaign continues.
+        bool isHung = runtime->GetScheduler()->IsHung;
+        int count = isHung ? ++m_report->NumOfHangs : ++m_report->NumOfDeadlocks;
+        Log("..... Iteration #" + std::to_string(iteration + 1) + (isHung ? " hung: " : " deadlocked: ") +
+            runtime->GetScheduler()->StuckReport);
+
+        auto& trace = runtime->GetScheduler()->GetTrace();
+        trace.Seed = m_configuration->RandomSchedulingSeed;
+        trace.Iteration = iteration;
+        if (!m_configuration->OutputFilePath.empty())
+        {
+            SaveTrace(trace, (isHung ? "hang_" : "deadlock_") + std::to_string(count));
+        }
+
+        if (isHung)
+        {
+            // The blocked process still uses the runtime, so it is quarantined,
+            // and the next iteration creates a new one.
+            m_quarantine->Add(move(m_runtime));
+        }
+    }
+    else if (m_configuration->Strategy == ExplorationStrategy::Replay)
+    {
+        auto strategy = static_cast<ReplayStrategy*>(m_strategy.get());
+        Log(strategy->HasDiverged() ? "..... Execution diverged from the replayed schedule" :
+            "..... Replayed schedule did not trigger a bug");
+    }
+    else if (m_configuration->Strategy == ExplorationStrategy::ProductionReplay && iteration == 0)
+    {
+        auto strategy = static_cast<ProductionReplayStrategy*>(m_strategy.get());
+        Log(strategy->HasDiverged() ? "..... Execution diverged from the production trace" :
+            "..... Production trace did not trigger a bug");
+    }
+}
+
+void TestingServices::BugFindingEngine::HandleBug(const ScheduleTrace& trace, const std::string& bugReport,
+    int bug)
+{
+    auto name = "bug_" + std::to_string(bug);
+    if (!m_configuration->OutputFilePath.empty())
+    {
+        SaveTrace(trace, name);
+    }
+
+    if (m_configuration->EnableScheduleMinimization)
+    {
+        MinimizeTrace(trace, bugReport, name);
+    }
+}
+
+void TestingServices::BugFindingEngine::MinimizeTrace(const ScheduleTrace& trace, const std::string& bugReport,
+    const std::string& name)
+{
+    Log("..... Minimizing the schedule of " + std::to_string(trace.Count()) + " choices");
+
+    TraceMinimizer minimizer(*(m_configuration.get()), m_testAction);
+    ScheduleTrace minimized;
+    if (!minimizer.Minimize(trace, bugReport, minimized))
+    {
+        Log("..... Failed to reproduce the bug during minimization");
+        return;
+    }
+
+    Log("..... Minimized the schedule to " + std::to_string(minimized.Count()) + " choices in " +
+        std::to_string(minimizer.GetNumOfRuns()) + " runs");
+    if (!m_configuration->OutputFilePath.empty())
+    {
+        SaveTrace(minimized, name + ".min");
+    }
+}
+
+void TestingServices::BugFindingEngine::SaveLog(const std::string& name)
+{
+    if (m_configuration->OutputFilePath.empty())
+    {
+        // A verbose runtime already wrote its log to the output.
+        if (m_configuration->ToolVerbosity && !m_configuration->Verbosity)
+        {
+            m_runtime->WriteLog(std::cout);
+        }
+
+        return;
+    }
+
+    auto path = m_configuration->OutputFilePath + "/" + name + ".log";
+    std::ofstream file(path);
+    m_runtime->WriteLog(file);
+    if (file.good())
+    {
+        Log("..... Writing " + path);
+    }
+    else
+    {
+        Log("..... Failed to write " + path);
+    }
+}
+
+void TestingServices::BugFindingEngine::LoadCampaign()
+{
+    auto& path = m_configuration->CampaignFile;
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        Log("... Starting campaign " + path);
+        return;
+    }
+
+    char magic[sizeof(CampaignMagic)];
+    uint8_t strategy, isPortfolio, hasCoverage, hasPortfolio;
+    int bound, nextIteration;
+    uint32_t numOfSlices;
+    unsigned int seed;
+    CoverageInfo coverage;
+    std::string strategyProgress, portfolioProgress;
+    if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), CampaignMagic) ||
+        file.get() != CampaignVersion || !ReadValue(file, strategy) || !ReadValue(file, bound) ||
+        !ReadValue(file, seed) || !ReadValue(file, isPortfolio) || !ReadValue(file, nextIteration) ||
+        !ReadValue(file, hasCoverage) || (hasCoverage == 1 && !coverage.Deserialize(file)) ||
+        !ReadBlock(file, strategyProgress) || !ReadValue(file, hasPortfolio) ||
+        (hasPortfolio == 1 && !ReadBlock(file, portfolioProgress)) || !ReadValue(file, numOfSlices) ||
+        nextIteration < 0)
+    {
+        Log("... Ignoring invalid campaign file " + path);
+        return;
+    }
+
+    std::vector<std::string> sliceProgress(numOfSlices);
+    for (auto& progress : sliceProgress)
+    {
+        if (!ReadBlock(file, progress))
+        {
+            Log("... Ignoring invalid campaign file " + path);
+            return;
+        }
+    }
+
+    // Progress of another strategy does not apply.
+    if (strategy != static_cast<uint8_t>(m_configuration->Strategy) || bound != m_configuration->StrategyBound ||
+        (isPortfolio == 1) != m_configuration->EnableStrategyPortfolio)
+    {
+        Log("... Starting campaign " + path + " over, as it was recorded with another strategy");
+        return;
+    }
+
+    // Slices do not map to the slices of another number of processes.
+#ifdef __linux__
+    bool hasSlices = m_configuration->ForkedProcesses > 0 && !m_configuration->EnableStrategyPortfolio;
+#else
+    bool hasSlices = false;
+#endif
+    if (numOfSlices != (hasSlices ? static_cast<uint32_t>(m_configuration->ForkedProcesses) : 0))
+    {
+        Log("... Starting campaign " + path + " over, as it was recorded with another number of processes");
+        return;
+    }
+
+    // Iterations derive their seed from the campaign seed and their index,
+    // so the resumed iterations only continue the campaign with its seed.
+    auto originalSeed = m_configuration->RandomSchedulingSeed;
+    m_configuration->RandomSchedulingSeed = seed;
+    Initialize();
+
+    // The testing process of forked processes keeps the progress of each
+    // slice instead of its own.
+    bool isValid = true;
+    if (!sliceProgress.empty())
+    {
+        int numOfSlices = static_cast<int>(sliceProgress.size());
+        for (int i = 0; i < numOfSlices && isValid; i++)
+        {
+            auto slice = CreateStrategy(m_configuration->Strategy, m_configuration->StrategyBound);
+            slice->SetSlice(i, numOfSlices);
+            std::istringstream sliceStream(sliceProgress[i]);
+            isValid = slice->LoadProgress(sliceStream);
+            m_slices.push_back(move(slice));
+        }
+    }
+    else
+    {
+        std::istringstream strategyStream(strategyProgress);
+        isValid = m_strategy->LoadProgress(strategyStream);
+    }
+
+    auto portfolio = std::make_unique<StrategyPortfolio>();
+    std::istringstream portfolioStream(portfolioProgress);
+    if (!isValid || (hasPortfolio == 1 && !portfolio->LoadProgress(portfolioStream)))
+    {
+        m_slices.clear();
+        m_configuration->RandomSchedulingSeed = originalSeed;
+        Initialize();
+        Log("... Ignoring invalid campaign file " + path);
+        return;
+    }
+
+    if (hasPortfolio == 1)
+    {
+        m_portfolio = move(portfolio);
+    }
+
+    if (hasCoverage == 1 && m_coverage != nullptr)
+    {
+        m_coverage->Merge(coverage);
+    }
+
+    m_firstIteration = nextIteration;
+    Log("... Resuming campaign " + path + " from iteration #" + std::to_string(nextIteration + 1));
+}
+
+void TestingServices::BugFindingEngine::SaveCampaign()
+{
+    // Forked processes may stop a few iterations apart, so the campaign
+    // resumes after as many iterations as were explored.
+    int nextIteration = m_firstIteration + m_report->NumOfExploredSchedules;
+
+    // Forked processes explore with the strategies of the slices, so the
+    // strategy of the testing process has no progress.
+    std::ostringstream strategyProgress;
+    if (m_slices.empty())
+    {
+        m_strategy->SaveProgress(strategyProgress);
+    }
+
+    // The file is replaced at once, so that an interrupted run keeps the
+    // progress of the previous one.
+    auto& path = m_configuration->CampaignFile;
+    auto temporaryPath = path + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    file.write(CampaignMagic, sizeof(CampaignMagic));
+    file.put(static_cast<char>(CampaignVersion));
+    WriteValue(file, static_cast<uint8_t>(m_configuration->Strategy));
+    WriteValue(file, m_configuration->StrategyBound);
+    WriteValue(file, m_configuration->RandomSchedulingSeed);
+    WriteValue(file, static_cast<uint8_t>(m_configuration->EnableStrategyPortfolio ? 1 : 0));
+    WriteValue(file, nextIteration);
+    WriteValue(file, static_cast<uint8_t>(m_coverage != nullptr ? 1 : 0));
+    if (m_coverage != nullptr)
+    {
+        m_coverage->Serialize(file);
+    }
+
+    WriteBlock(file, strategyProgress.str());
+    WriteValue(file, static_cast<uint8_t>(m_portfolio != nullptr ? 1 : 0));
+    if (m_portfolio != nullptr)
+    {
+        std::ostringstream portfolioProgress;
+        m_portfolio->SaveProgress(portfolioProgress);
+        WriteBlock(file, portfolioProgress.str());
+    }
+
+    WriteValue(file, static_cast<uint32_t>(m_slices.size()));
+    for (auto& slice : m_slices)
+    {
+        std::ostringstream sliceProgress;
+        slice->SaveProgress(sliceProgress);
+        WriteBlock(file, sliceProgress.str());
+    }
+
+    file.close();
+    if (file.good() && std::rename(temporaryPath.c_str(), path.c_str()) == 0)
+    {
+        Log("... Writing " + path);
+    }
+    else
+    {
+        std::remove(temporaryPath.c_str());
+        Log("... Failed to write " + path);
+    }
+}
+
+void TestingServices::BugFindingEngine::SaveTrace(const ScheduleTrace& trace, const std::string& name)
+{
+    auto path = m_configuration->OutputFilePath + "/" + name + ".schedule";
+    if (trace.SaveToFile(path))
+    {
+        Log("..... Writing " + path);
+    }
+    else
+    {
+        Log("..... Failed to write " + path);
     }
 }
 
@@ -96,6 +1333,11 @@ TestReport* TestingServices::BugFindingEngine::GetReport()
     return m_report.get();
 }
 
+const StrategyPortfolio* TestingServices::BugFindingEngine::GetPortfolio() const
+{
+    return m_portfolio.get();
+}
+
 void TestingServices::BugFindingEngine::Log(const std::string& message)
 {
     if (m_configuration->ToolVerbosity)
@@ -0,0 +1,210 @@
+//-----------------------------------------------------------------------
+// <copyright file="CoverageGuidedStrategy.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "CoverageGuidedStrategy.h"
+#include "RandomStrategy.h"
+#include <algorithm>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+// Maximum number of schedules kept in the corpus.
+static const size_t MaxCorpusSize = 64;
+
+TestingServices::CoverageGuidedStrategy::CoverageGuidedStrategy(unsigned int seed)
+{
+    m_campaignSeed = seed;
+    m_generator.seed(seed);
+    m_nextEvicted = 0;
+    m_prefix = nullptr;
+    m_prefixLength = 0;
+    m_position = 0;
+}
+
+bool TestingServices::CoverageGuidedStrategy::TryGetNext(ActorInfo*& next,
+    const EnabledSet& choices, ActorInfo& current)
+{
+    if (choices.EnabledCount() == 0)
+    {
+        return false;
+    }
+
+    auto step = GetNextPrefixStep(ScheduleTrace::StepType::SchedulingChoice);
+    if (step != nullptr && step->Value < choices.Size() && choices.IsEnabled(step->Value))
+    {
+        next = choices.Get(step->Value);
+        return true;
+    }
+
+    std::uniform_int_distribution<size_t> dis(0, choices.EnabledCount() - 1);
+    next = choices.GetEnabled(dis(m_generator));
+    return true;
+}
+
+bool TestingServices::CoverageGuidedStrategy::GetNextBooleanChoice(int maxValue, bool& next)
+{
+    auto step = GetNextPrefixStep(ScheduleTrace::StepType::BooleanChoice);
+    if (step != nullptr)
+    {
+        next = step->Value != 0;
+        return true;
+    }
+
+    next = GetRandomBooleanChoice(m_generator, maxValue);
+    return true;
+}
+
+bool TestingServices::CoverageGuidedStrategy::GetNextIntegerChoice(int maxValue, int& next)
+{
+    auto step = GetNextPrefixStep(ScheduleTrace::StepType::IntegerChoice);
+    if (step != nullptr && step->Value < static_cast<uint32_t>(maxValue))
+    {
+        next = static_cast<int>(step->Value);
+        return true;
+    }
+
+    next = GetRandomIntegerChoice(m_generator, maxValue);
+    return true;
+}
+
+bool TestingServices::CoverageGuidedStrategy::IsFair()
+{
+    return true;
+}
+
+bool TestingServices::CoverageGuidedStrategy::PrepareForNextIteration(int iteration)
+{
+    m_generator.seed(RandomStrategy::GetIterationSeed(m_campaignSeed, iteration));
+    m_prefix = nullptr;
+    m_prefixLength = 0;
+    m_position = 0;
+
+    // Follows a random prefix of a random schedule from the corpus half of the time.
+    if (!m_corpus.empty() && std::uniform_int_distribution<int>(0, 1)(m_generator) == 0)
+    {
+        std::uniform_int_distribution<size_t> entry(0, m_corpus.size() - 1);
+        m_prefix = &m_corpus[entry(m_generator)];
+        std::uniform_int_distribution<size_t> length(0, m_prefix->size());
+        m_prefixLength = length(m_generator);
+    }
+
+    return true;
+}
+
+void TestingServices::CoverageGuidedStrategy::NotifyIterationCompleted(const ScheduleTrace& trace,
+    size_t first, bool hasNewCoverage)
+{
+    if (!hasNewCoverage || trace.Count() <= first)
+    {
+        return;
+    }
+
+    // Once the corpus is full, the oldest schedules are replaced first.
+    size_t position = m_corpus.size();
+    if (position < MaxCorpusSize)
+    {
+        m_corpus.emplace_back();
+    }
+    else
+    {
+        position = m_nextEvicted;
+        m_nextEvicted = (m_nextEvicted + 1) % MaxCorpusSize;
+    }
+
+    auto& steps = m_corpus[position];
+    steps.clear();
+    for (size_t i = first; i < trace.Count(); i++)
+    {
+        steps.push_back(trace.Get(i));
+    }
+}
+
+size_t TestingServices::CoverageGuidedStrategy::GetCorpusSize() const
+{
+    return m_corpus.size();
+}
+
+const ScheduleTrace::Step* TestingServices::CoverageGuidedStrategy::GetNextPrefixStep(ScheduleTrace::StepType type)
+{
+    if (m_prefix == nullptr || m_position >= m_prefixLength)
+    {
+        return nullptr;
+    }
+
+    auto& step = (*m_prefix)[m_position];
+    if (step.Type != type)
+    {
+        // The execution diverged from the followed schedule.
+        m_prefix = nullptr;
+        return nullptr;
+    }
+
+    m_position++;
+    return &step;
+}
+
+void TestingServices::CoverageGuidedStrategy::SaveProgress(std::ostream& stream) const
+{
+    WriteProgress(stream, static_cast<uint32_t>(m_corpus.size()));
+    WriteProgress(stream, static_cast<uint32_t>(m_nextEvicted));
+    for (auto& steps : m_corpus)
+    {
+        WriteProgress(stream, static_cast<uint32_t>(steps.size()));
+        for (auto& step : steps)
+        {
+            WriteProgress(stream, static_cast<uint8_t>(step.Type));
+            WriteProgress(stream, step.Value);
+        }
+    }
+}
+
+bool TestingServices::CoverageGuidedStrategy::LoadProgress(std::istream& stream)
+{
+    uint32_t size, nextEvicted;
+    if (!ReadProgress(stream, size) || !ReadProgress(stream, nextEvicted) || size > MaxCorpusSize)
+    {
+        return false;
+    }
+
+    m_corpus.resize(size);
+    m_nextEvicted = size > 0 ? nextEvicted % size : 0;
+    for (auto& steps : m_corpus)
+    {
+        uint32_t length;
+        if (!ReadProgress(stream, length))
+        {
+            return false;
+        }
+
+        // The length is read from the file, so the steps grow as they are read.
+        steps.clear();
+        for (; length > 0; length--)
+        {
+            uint8_t type;
+            ScheduleTrace::Step step;
+            if (!ReadProgress(stream, type) || !ReadProgress(stream, step.Value) ||
+                type > static_cast<uint8_t>(ScheduleTrace::StepType::IntegerChoice))
+            {
+                return false;
+            }
+
+            step.Type = static_cast<ScheduleTrace::StepType>(type);
+            steps.push_back(step);
+        }
+    }
+
+    return true;
+}
+
+TestingServices::CoverageGuidedStrategy::~CoverageGuidedStrategy() { }
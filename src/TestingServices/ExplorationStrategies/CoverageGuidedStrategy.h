@@ -0,0 +1,95 @@
+//-----------------------------------------------------------------------
+// <copyright file="CoverageGuidedStrategy.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_COVERAGEGUIDEDSTRATEGY_H
+#define MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_COVERAGEGUIDEDSTRATEGY_H
+
+#include "../IExplorationStrategy.h"
+#include "../Tracing/ScheduleTrace.h"
+#include <random>
+#include <vector>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Random-walk strategy that keeps a corpus of the schedules that covered
+    // new activities. Half of the iterations replay a random prefix of a schedule
+    // from the corpus, and then continue with random choices, so that they
+    // explore the neighbourhood of the schedules that made progress.
+    class CoverageGuidedStrategy : public IExplorationStrategy
+    {
+    public:
+        CoverageGuidedStrategy(unsigned int seed);
+        ~CoverageGuidedStrategy();
+
+        // Returns the next process to schedule.
+        bool TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current);
+
+        // Returns the next boolean choice.
+        bool GetNextBooleanChoice(int maxValue, bool& next);
+
+        // Returns the next integer choice.
+        bool GetNextIntegerChoice(int maxValue, int& next);
+
+        // Checks if the strategy is fair.
+        bool IsFair();
+
+        // Prepares the strategy for the specified iteration.
+        bool PrepareForNextIteration(int iteration);
+
+        // Notifies the strategy that an iteration completed with the specified
+        // trace, whose steps the strategy took from the specified position,
+        // and whether it covered new activities.
+        void NotifyIterationCompleted(const ScheduleTrace& trace, size_t first, bool hasNewCoverage);
+
+        // Returns the number of schedules in the corpus.
+        size_t GetCorpusSize() const;
+
+        // Writes the progress of the campaign.
+        void SaveProgress(std::ostream& stream) const;
+
+        // Reads the progress of a campaign.
+        bool LoadProgress(std::istream& stream);
+
+    private:
+        // Seed of the testing campaign.
+        unsigned int m_campaignSeed;
+
+        // Random integer generator.
+        std::mt19937 m_generator;
+
+        // Schedules that covered new activities.
+        std::vector<std::vector<ScheduleTrace::Step>> m_corpus;
+
+        // Position in the corpus of the next schedule to replace, once it is full.
+        size_t m_nextEvicted;
+
+        // Schedule from the corpus followed during this iteration, if any.
+        const std::vector<ScheduleTrace::Step>* m_prefix;
+
+        // Number of choices of the schedule to follow.
+        size_t m_prefixLength;
+
+        // Position of the next choice to follow.
+        size_t m_position;
+
+        // Returns the next choice of the followed prefix, if it has the specified type.
+        const ScheduleTrace::Step* GetNextPrefixStep(ScheduleTrace::StepType type);
+
+        // Copy is disabled.
+        CoverageGuidedStrategy(const CoverageGuidedStrategy& that) = delete;
+        CoverageGuidedStrategy &operator=(CoverageGuidedStrategy const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_COVERAGEGUIDEDSTRATEGY_H
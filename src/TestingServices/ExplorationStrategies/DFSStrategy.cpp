@@ -0,0 +1,215 @@
+//-----------------------------------------------------------------------
+// <copyright file="DFSStrategy.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "DFSStrategy.h"
+#include <algorithm>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+TestingServices::DFSStrategy::DFSStrategy()
+{
+    m_position = 0;
+    m_numOfReplayedChoices = 0;
+    m_isStarted = false;
+    m_sliceIndex = 0;
+    m_numOfSlices = 1;
+    m_pathSlice = 0;
+    m_numOfPathSlices = 1;
+}
+
+bool TestingServices::DFSStrategy::TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current)
+{
+    if (choices.EnabledCount() == 0)
+    {
+        return false;
+    }
+
+    next = choices.GetEnabled(static_cast<size_t>(GetNextChoice(static_cast<int>(choices.EnabledCount()))));
+    return true;
+}
+
+bool TestingServices::DFSStrategy::GetNextBooleanChoice(int maxValue, bool& next)
+{
+    next = GetNextChoice(2) == 1;
+    return true;
+}
+
+bool TestingServices::DFSStrategy::GetNextIntegerChoice(int maxValue, int& next)
+{
+    next = GetNextChoice(maxValue);
+    return true;
+}
+
+bool TestingServices::DFSStrategy::IsFair()
+{
+    return false;
+}
+
+bool TestingServices::DFSStrategy::PrepareForNextIteration(int iteration)
+{
+    if (m_isStarted)
+    {
+        // Choices past the end of the last iteration belong to an older path.
+        m_path.resize(m_position);
+        while (!m_path.empty() && m_path.back().Value + m_path.back().Stride >= m_path.back().NumOfValues)
+        {
+            m_path.pop_back();
+        }
+
+        if (m_path.empty())
+        {
+            // Every path of the slice has been explored.
+            return false;
+        }
+
+        m_path.back().Value += m_path.back().Stride;
+    }
+
+    m_isStarted = true;
+    m_position = 0;
+    m_numOfReplayedChoices = m_path.size();
+    m_pathSlice = m_sliceIndex;
+    m_numOfPathSlices = m_numOfSlices;
+    return true;
+}
+
+bool TestingServices::DFSStrategy::NotifyVisitedState(uint64_t fingerprint)
+{
+    // States before the new choice were explored by the path that is replayed.
+    bool isNew = m_visitedStates.insert(fingerprint).second;
+    return isNew || m_position < m_numOfReplayedChoices;
+}
+
+void TestingServices::DFSStrategy::SetSlice(int index, int count)
+{
+    m_sliceIndex = index;
+    m_numOfSlices = count;
+}
+
+void TestingServices::DFSStrategy::SaveProgress(std::ostream& stream) const
+{
+    // The path ends at the last choice of the last iteration, so that the
+    // resumed campaign backtracks from it.
+    auto length = std::min(m_position, m_path.size());
+    WriteProgress(stream, static_cast<uint8_t>(m_isStarted ? 1 : 0));
+    WriteProgress(stream, static_cast<uint32_t>(length));
+    for (size_t i = 0; i < length; i++)
+    {
+        WriteProgress(stream, m_path[i].Value);
+        WriteProgress(stream, m_path[i].NumOfValues);
+        WriteProgress(stream, m_path[i].Stride);
+    }
+
+    WriteProgress(stream, static_cast<uint64_t>(m_visitedStates.size()));
+    for (auto fingerprint : m_visitedStates)
+    {
+        WriteProgress(stream, fingerprint);
+    }
+}
+
+bool TestingServices::DFSStrategy::LoadProgress(std::istream& stream)
+{
+    uint8_t isStarted;
+    uint32_t length;
+    if (!ReadProgress(stream, isStarted) || !ReadProgress(stream, length))
+    {
+        return false;
+    }
+
+    // The length is read from the file, so the path grows as its choices are read.
+    m_path.clear();
+    for (; length > 0; length--)
+    {
+        Choice choice;
+        if (!ReadProgress(stream, choice.Value) || !ReadProgress(stream, choice.NumOfValues) ||
+            !ReadProgress(stream, choice.Stride) || choice.Value < 0 || choice.Value >= choice.NumOfValues ||
+            choice.Stride < 1)
+        {
+            return false;
+        }
+
+        m_path.push_back(choice);
+    }
+
+    uint64_t count;
+    if (!ReadProgress(stream, count))
+    {
+        return false;
+    }
+
+    m_visitedStates.clear();
+    for (uint64_t fingerprint; count > 0; count--)
+    {
+        if (!ReadProgress(stream, fingerprint))
+        {
+            return false;
+        }
+
+        m_visitedStates.insert(fingerprint);
+    }
+
+    m_isStarted = isStarted == 1;
+    m_position = m_path.size();
+    return true;
+}
+
+int TestingServices::DFSStrategy::GetNextChoice(int numOfValues)
+{
+    if (numOfValues <= 1)
+    {
+        // There is nothing to explore.
+        return 0;
+    }
+
+    // The slices that share the path so far split the values of the choice.
+    // If there are fewer values than slices, each value goes to a group of
+    // them, which split the next choices. A path that ends before its group
+    // is split is explored by each slice of the group.
+    int first = 0;
+    int stride = 1;
+    if (m_numOfPathSlices > 1 && numOfValues >= m_numOfPathSlices)
+    {
+        first = m_pathSlice;
+        stride = m_numOfPathSlices;
+        m_pathSlice = 0;
+        m_numOfPathSlices = 1;
+    }
+    else if (m_numOfPathSlices > 1)
+    {
+        first = m_pathSlice % numOfValues;
+        stride = numOfValues;
+        m_numOfPathSlices = (m_numOfPathSlices - first + numOfValues - 1) / numOfValues;
+        m_pathSlice /= numOfValues;
+    }
+
+    if (m_position == m_path.size())
+    {
+        m_path.push_back({ first, numOfValues, stride });
+    }
+
+    auto& choice = m_path[m_position++];
+    if (choice.Value >= numOfValues || choice.Value < first || (choice.Value - first) % stride != 0)
+    {
+        // The program did not repeat its choices, so the rest of the path is new.
+        m_path.resize(m_position);
+        choice.Value = first;
+    }
+
+    choice.NumOfValues = numOfValues;
+    choice.Stride = stride;
+    return choice.Value;
+}
+
+TestingServices::DFSStrategy::~DFSStrategy() { }
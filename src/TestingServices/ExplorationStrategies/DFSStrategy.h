@@ -0,0 +1,111 @@
+//-----------------------------------------------------------------------
+// <copyright file="DFSStrategy.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_DFSSTRATEGY_H
+#define MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_DFSSTRATEGY_H
+
+#include "../IExplorationStrategy.h"
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Systematic strategy that explores the tree of scheduling and
+    // nondeterministic choices depth-first. Each iteration replays the choices
+    // of the previous one up to the deepest choice with an unexplored value,
+    // which it takes instead, and then takes the first value of every new
+    // choice. If state hashing is enabled, an iteration is pruned once it
+    // reaches a program state that an earlier one already explored. A slice
+    // of the strategy only takes its share of the values of the first choices,
+    // so that the slices explore disjoint subtrees.
+    class DFSStrategy : public IExplorationStrategy
+    {
+    public:
+        DFSStrategy();
+        ~DFSStrategy();
+
+        // Returns the next process to schedule.
+        bool TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current);
+
+        // Returns the next boolean choice.
+        bool GetNextBooleanChoice(int maxValue, bool& next);
+
+        // Returns the next integer choice.
+        bool GetNextIntegerChoice(int maxValue, int& next);
+
+        // Checks if the strategy is fair.
+        bool IsFair();
+
+        // Prepares the strategy for the specified iteration.
+        bool PrepareForNextIteration(int iteration);
+
+        // Prunes the iteration if it reached an explored state.
+        bool NotifyVisitedState(uint64_t fingerprint);
+
+        // Restricts the strategy to a slice of the tree of choices.
+        void SetSlice(int index, int count);
+
+        // Writes the progress of the campaign.
+        void SaveProgress(std::ostream& stream) const;
+
+        // Reads the progress of a campaign.
+        bool LoadProgress(std::istream& stream);
+
+    private:
+        // A choice on the explored path, its number of values, and the step
+        // between the values that the slice takes.
+        struct Choice
+        {
+            int Value;
+            int NumOfValues;
+            int Stride;
+        };
+
+        // Choices of the explored path.
+        std::vector<Choice> m_path;
+
+        // Position of the next choice on the path.
+        size_t m_position;
+
+        // Number of choices of the path that the iteration replays, the last
+        // of which takes a new value.
+        size_t m_numOfReplayedChoices;
+
+        // Fingerprints of the explored program states.
+        std::unordered_set<uint64_t> m_visitedStates;
+
+        // Set once an iteration was prepared, or progress was loaded, so
+        // that the next iteration backtracks from the explored path.
+        bool m_isStarted;
+
+        // The slice of the strategy, and the number of slices.
+        int m_sliceIndex;
+        int m_numOfSlices;
+
+        // The slice of the rest of the path, and the number of slices that
+        // share the path so far.
+        int m_pathSlice;
+        int m_numOfPathSlices;
+
+        // Returns the value of the next choice, out of the specified number.
+        int GetNextChoice(int numOfValues);
+
+        // Copy is disabled.
+        DFSStrategy(const DFSStrategy& that) = delete;
+        DFSStrategy &operator=(DFSStrategy const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_DFSSTRATEGY_H
@@ -0,0 +1,106 @@
+//-----------------------------------------------------------------------
+// <copyright file="DelayBoundingStrategy.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "DelayBoundingStrategy.h"
+#include "RandomStrategy.h"
+#include <algorithm>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+TestingServices::DelayBoundingStrategy::DelayBoundingStrategy(unsigned int seed, int maxDelays)
+{
+    m_campaignSeed = seed;
+    m_generator.seed(seed);
+    m_maxDelays = maxDelays > 0 ? maxDelays : 0;
+    m_nextDelay = 0;
+    m_step = 0;
+    m_maxSteps = 0;
+}
+
+bool TestingServices::DelayBoundingStrategy::TryGetNext(ActorInfo*& next,
+    const EnabledSet& choices, ActorInfo& current)
+{
+    if (choices.EnabledCount() == 0)
+    {
+        return false;
+    }
+
+    next = current.IsEnabled ? &current : choices.GetNextEnabled(current.Index);
+    for (; m_nextDelay < m_delays.size() && m_delays[m_nextDelay] == m_step; m_nextDelay++)
+    {
+        next = choices.GetNextEnabled(next->Index);
+    }
+
+    m_step++;
+    return true;
+}
+
+bool TestingServices::DelayBoundingStrategy::GetNextBooleanChoice(int maxValue, bool& next)
+{
+    next = GetRandomBooleanChoice(m_generator, maxValue);
+    return true;
+}
+
+bool TestingServices::DelayBoundingStrategy::GetNextIntegerChoice(int maxValue, int& next)
+{
+    next = GetRandomIntegerChoice(m_generator, maxValue);
+    return true;
+}
+
+bool TestingServices::DelayBoundingStrategy::IsFair()
+{
+    return false;
+}
+
+bool TestingServices::DelayBoundingStrategy::PrepareForNextIteration(int iteration)
+{
+    m_maxSteps = std::max(m_maxSteps, m_step);
+    m_step = 0;
+    m_nextDelay = 0;
+    m_generator.seed(RandomStrategy::GetIterationSeed(m_campaignSeed, iteration));
+
+    m_delays.clear();
+    if (m_maxSteps > 0)
+    {
+        std::uniform_int_distribution<size_t> dis(0, m_maxSteps - 1);
+        for (int i = 0; i < m_maxDelays; i++)
+        {
+            m_delays.push_back(dis(m_generator));
+        }
+
+        std::sort(m_delays.begin(), m_delays.end());
+    }
+
+    return true;
+}
+
+void TestingServices::DelayBoundingStrategy::SaveProgress(std::ostream& stream) const
+{
+    WriteProgress(stream, static_cast<uint64_t>(std::max(m_maxSteps, m_step)));
+}
+
+bool TestingServices::DelayBoundingStrategy::LoadProgress(std::istream& stream)
+{
+    uint64_t maxSteps;
+    if (!ReadProgress(stream, maxSteps))
+    {
+        return false;
+    }
+
+    m_maxSteps = static_cast<size_t>(maxSteps);
+    return true;
+}
+
+TestingServices::DelayBoundingStrategy::~DelayBoundingStrategy() { }
@@ -0,0 +1,83 @@
+//-----------------------------------------------------------------------
+// <copyright file="DelayBoundingStrategy.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_DELAYBOUNDINGSTRATEGY_H
+#define MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_DELAYBOUNDINGSTRATEGY_H
+
+#include "../IExplorationStrategy.h"
+#include <random>
+#include <vector>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Strategy that follows the round-robin order, but delays the process it
+    // would schedule at a bounded number of random steps of each iteration,
+    // scheduling the next enabled process in creation order instead. The steps
+    // are chosen among the longest iteration explored so far.
+    class DelayBoundingStrategy : public IExplorationStrategy
+    {
+    public:
+        DelayBoundingStrategy(unsigned int seed, int maxDelays);
+        ~DelayBoundingStrategy();
+
+        // Returns the next process to schedule.
+        bool TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current);
+
+        // Returns the next boolean choice.
+        bool GetNextBooleanChoice(int maxValue, bool& next);
+
+        // Returns the next integer choice.
+        bool GetNextIntegerChoice(int maxValue, int& next);
+
+        // Checks if the strategy is fair.
+        bool IsFair();
+
+        // Prepares the strategy for the specified iteration.
+        bool PrepareForNextIteration(int iteration);
+
+        // Writes the progress of the campaign.
+        void SaveProgress(std::ostream& stream) const;
+
+        // Reads the progress of a campaign.
+        bool LoadProgress(std::istream& stream);
+
+    private:
+        // Seed of the testing campaign.
+        unsigned int m_campaignSeed;
+
+        // Random integer generator.
+        std::mt19937 m_generator;
+
+        // Maximum number of delays per iteration.
+        int m_maxDelays;
+
+        // Steps of this iteration at which a delay is inserted, in ascending order.
+        std::vector<size_t> m_delays;
+
+        // Position of the next delay.
+        size_t m_nextDelay;
+
+        // Number of scheduling steps taken during this iteration.
+        size_t m_step;
+
+        // Maximum number of scheduling steps of an explored iteration.
+        size_t m_maxSteps;
+
+        // Copy is disabled.
+        DelayBoundingStrategy(const DelayBoundingStrategy& that) = delete;
+        DelayBoundingStrategy &operator=(DelayBoundingStrategy const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_DELAYBOUNDINGSTRATEGY_H
@@ -0,0 +1,100 @@
+//-----------------------------------------------------------------------
+// <copyright file="GuidedReplayStrategy.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "GuidedReplayStrategy.h"
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+TestingServices::GuidedReplayStrategy::GuidedReplayStrategy(const std::vector<ScheduleTrace::Step>& steps,
+    size_t maxChoices)
+    : m_steps(steps)
+{
+    m_position = 0;
+    m_numOfChoices = 0;
+    m_maxChoices = maxChoices;
+}
+
+bool TestingServices::GuidedReplayStrategy::TryGetNext(ActorInfo*& next,
+    const EnabledSet& choices, ActorInfo& current)
+{
+    if (choices.EnabledCount() == 0 || m_numOfChoices++ >= m_maxChoices)
+    {
+        return false;
+    }
+
+    // Drops recorded choices that do not apply at this scheduling point.
+    while (m_position < m_steps.size())
+    {
+        auto& step = m_steps[m_position++];
+        if (step.Type == ScheduleTrace::StepType::SchedulingChoice &&
+            step.Value < choices.Size() && choices.IsEnabled(step.Value))
+        {
+            next = choices.Get(step.Value);
+            return true;
+        }
+    }
+
+    next = current.IsEnabled ? &current : choices.GetEnabled(0);
+    return true;
+}
+
+bool TestingServices::GuidedReplayStrategy::GetNextBooleanChoice(int maxValue, bool& next)
+{
+    if (m_numOfChoices++ >= m_maxChoices)
+    {
+        return false;
+    }
+
+    next = false;
+    if (m_position < m_steps.size() &&
+        m_steps[m_position].Type == ScheduleTrace::StepType::BooleanChoice)
+    {
+        next = m_steps[m_position++].Value != 0;
+    }
+
+    return true;
+}
+
+bool TestingServices::GuidedReplayStrategy::GetNextIntegerChoice(int maxValue, int& next)
+{
+    if (m_numOfChoices++ >= m_maxChoices)
+    {
+        return false;
+    }
+
+    next = 0;
+    if (m_position < m_steps.size() &&
+        m_steps[m_position].Type == ScheduleTrace::StepType::IntegerChoice)
+    {
+        auto value = m_steps[m_position++].Value;
+        next = value < static_cast<uint32_t>(maxValue) ? static_cast<int>(value) : 0;
+    }
+
+    return true;
+}
+
+bool TestingServices::GuidedReplayStrategy::IsFair()
+{
+    return false;
+}
+
+bool TestingServices::GuidedReplayStrategy::PrepareForNextIteration(int iteration)
+{
+    m_position = 0;
+    m_numOfChoices = 0;
+    return true;
+}
+
+TestingServices::GuidedReplayStrategy::~GuidedReplayStrategy() { }
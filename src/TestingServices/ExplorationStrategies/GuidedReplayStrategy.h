@@ -0,0 +1,71 @@
+//-----------------------------------------------------------------------
+// <copyright file="GuidedReplayStrategy.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_GUIDEDREPLAYSTRATEGY_H
+#define MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_GUIDEDREPLAYSTRATEGY_H
+
+#include "../IExplorationStrategy.h"
+#include "../Tracing/ScheduleTrace.h"
+#include <vector>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Strategy that follows a (possibly partial) sequence of recorded choices.
+    // A recorded scheduling choice is taken if the process it names is enabled,
+    // and dropped otherwise. When no recorded choice applies, the strategy
+    // keeps running the current process if possible (or else the first enabled
+    // one), and answers boolean choices with false and integer choices with
+    // zero. Every iteration performs at
+    // most the specified number of choices.
+    class GuidedReplayStrategy : public IExplorationStrategy
+    {
+    public:
+        GuidedReplayStrategy(const std::vector<ScheduleTrace::Step>& steps, size_t maxChoices);
+        ~GuidedReplayStrategy();
+
+        // Returns the next process to schedule.
+        bool TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current);
+
+        // Returns the next boolean choice.
+        bool GetNextBooleanChoice(int maxValue, bool& next);
+
+        // Returns the next integer choice.
+        bool GetNextIntegerChoice(int maxValue, int& next);
+
+        // Checks if the strategy is fair.
+        bool IsFair();
+
+        // Prepares the strategy for the specified iteration.
+        bool PrepareForNextIteration(int iteration);
+
+    private:
+        // The recorded choices to follow.
+        const std::vector<ScheduleTrace::Step>& m_steps;
+
+        // Position of the next recorded choice.
+        size_t m_position;
+
+        // Number of choices taken during this iteration.
+        size_t m_numOfChoices;
+
+        // Maximum number of choices per iteration.
+        size_t m_maxChoices;
+
+        // Copy is disabled.
+        GuidedReplayStrategy(const GuidedReplayStrategy& that) = delete;
+        GuidedReplayStrategy &operator=(GuidedReplayStrategy const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_GUIDEDREPLAYSTRATEGY_H
@@ -0,0 +1,105 @@
+//-----------------------------------------------------------------------
+// <copyright file="InputDrivenStrategy.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "InputDrivenStrategy.h"
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+TestingServices::InputDrivenStrategy::InputDrivenStrategy()
+{
+    m_data = nullptr;
+    m_size = 0;
+    m_position = 0;
+}
+
+void TestingServices::InputDrivenStrategy::SetInput(const uint8_t* data, size_t size)
+{
+    m_data = data;
+    m_size = size;
+    m_position = 0;
+}
+
+bool TestingServices::InputDrivenStrategy::TryGetNext(ActorInfo*& next,
+    const EnabledSet& choices, ActorInfo& current)
+{
+    if (choices.EnabledCount() == 0)
+    {
+        return false;
+    }
+
+    size_t value;
+    if (ReadValue(choices.EnabledCount(), value))
+    {
+        next = choices.GetEnabled(value);
+    }
+    else
+    {
+        next = current.IsEnabled ? &current : choices.GetEnabled(0);
+    }
+
+    return true;
+}
+
+bool TestingServices::InputDrivenStrategy::GetNextBooleanChoice(int maxValue, bool& next)
+{
+    size_t value;
+    next = ReadValue(2, value) && value == 1;
+    return true;
+}
+
+bool TestingServices::InputDrivenStrategy::GetNextIntegerChoice(int maxValue, int& next)
+{
+    size_t value;
+    next = maxValue > 0 && ReadValue(static_cast<size_t>(maxValue), value) ? static_cast<int>(value) : 0;
+    return true;
+}
+
+bool TestingServices::InputDrivenStrategy::IsFair()
+{
+    return false;
+}
+
+bool TestingServices::InputDrivenStrategy::PrepareForNextIteration(int iteration)
+{
+    m_position = 0;
+    return true;
+}
+
+bool TestingServices::InputDrivenStrategy::ReadValue(size_t bound, size_t& value)
+{
+    value = 0;
+    if (bound <= 1)
+    {
+        return true;
+    }
+
+    // Reads the bytes needed to represent the bound, in little-endian order.
+    size_t raw = 0;
+    int shift = 0;
+    for (size_t range = bound - 1; range > 0; range >>= 8, shift += 8)
+    {
+        if (m_position >= m_size)
+        {
+            return false;
+        }
+
+        raw |= static_cast<size_t>(m_data[m_position++]) << shift;
+    }
+
+    value = raw % bound;
+    return true;
+}
+
+TestingServices::InputDrivenStrategy::~InputDrivenStrategy() { }
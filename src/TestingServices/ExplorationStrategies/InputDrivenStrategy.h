@@ -0,0 +1,72 @@
+//-----------------------------------------------------------------------
+// <copyright file="InputDrivenStrategy.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_INPUTDRIVENSTRATEGY_H
+#define MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_INPUTDRIVENSTRATEGY_H
+
+#include "../IExplorationStrategy.h"
+#include <cstdint>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Strategy that derives every choice from an input byte buffer, so that a
+    // fuzzer can mutate schedules. A choice between n > 1 options consumes as
+    // many bytes as are needed to represent n, and a choice with a single
+    // option consumes none. Once the input is exhausted, the strategy keeps
+    // running the current process if possible (or else the first enabled
+    // one), and answers boolean choices with false and integer choices with
+    // zero. The same input always produces the same schedule.
+    class InputDrivenStrategy : public IExplorationStrategy
+    {
+    public:
+        InputDrivenStrategy();
+        ~InputDrivenStrategy();
+
+        // Sets the input of the next iteration. The buffer must outlive the iteration.
+        void SetInput(const uint8_t* data, size_t size);
+
+        // Returns the next process to schedule.
+        bool TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current);
+
+        // Returns the next boolean choice.
+        bool GetNextBooleanChoice(int maxValue, bool& next);
+
+        // Returns the next integer choice.
+        bool GetNextIntegerChoice(int maxValue, int& next);
+
+        // Checks if the strategy is fair.
+        bool IsFair();
+
+        // Prepares the strategy for the specified iteration.
+        bool PrepareForNextIteration(int iteration);
+
+    private:
+        // The input of the current iteration.
+        const uint8_t* m_data;
+        size_t m_size;
+
+        // Position of the next unread byte.
+        size_t m_position;
+
+        // Reads a value in [0, bound) from the input. Returns false if the
+        // input is exhausted.
+        bool ReadValue(size_t bound, size_t& value);
+
+        // Copy is disabled.
+        InputDrivenStrategy(const InputDrivenStrategy& that) = delete;
+        InputDrivenStrategy &operator=(InputDrivenStrategy const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_INPUTDRIVENSTRATEGY_H
@@ -0,0 +1,131 @@
+//-----------------------------------------------------------------------
+// <copyright file="PCTStrategy.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "PCTStrategy.h"
+#include "RandomStrategy.h"
+#include <algorithm>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+TestingServices::PCTStrategy::PCTStrategy(unsigned int seed, int depth)
+{
+    m_campaignSeed = seed;
+    m_generator.seed(seed);
+    m_numOfChangePoints = depth > 1 ? depth - 1 : 0;
+    m_nextChangePoint = 0;
+    m_step = 0;
+    m_maxSteps = 0;
+}
+
+bool TestingServices::PCTStrategy::TryGetNext(ActorInfo*& next,
+    const EnabledSet& choices, ActorInfo& current)
+{
+    if (choices.EnabledCount() == 0)
+    {
+        return false;
+    }
+
+    // Inserts the processes created since the last step at random priorities.
+    for (size_t index = m_priorities.size(); index < choices.Size(); index++)
+    {
+        std::uniform_int_distribution<size_t> dis(0, m_priorities.size());
+        m_priorities.insert(m_priorities.begin() + dis(m_generator), index);
+    }
+
+    for (; m_nextChangePoint < m_changePoints.size() && m_changePoints[m_nextChangePoint] == m_step;
+        m_nextChangePoint++)
+    {
+        auto position = GetHighestEnabled(choices);
+        auto index = m_priorities[position];
+        m_priorities.erase(m_priorities.begin() + position);
+        m_priorities.push_back(index);
+    }
+
+    next = choices.Get(m_priorities[GetHighestEnabled(choices)]);
+    m_step++;
+    return true;
+}
+
+bool TestingServices::PCTStrategy::GetNextBooleanChoice(int maxValue, bool& next)
+{
+    next = GetRandomBooleanChoice(m_generator, maxValue);
+    return true;
+}
+
+bool TestingServices::PCTStrategy::GetNextIntegerChoice(int maxValue, int& next)
+{
+    next = GetRandomIntegerChoice(m_generator, maxValue);
+    return true;
+}
+
+bool TestingServices::PCTStrategy::IsFair()
+{
+    return false;
+}
+
+bool TestingServices::PCTStrategy::PrepareForNextIteration(int iteration)
+{
+    m_maxSteps = std::max(m_maxSteps, m_step);
+    m_step = 0;
+    m_nextChangePoint = 0;
+    m_priorities.clear();
+    m_generator.seed(RandomStrategy::GetIterationSeed(m_campaignSeed, iteration));
+
+    m_changePoints.clear();
+    if (m_maxSteps > 0)
+    {
+        std::uniform_int_distribution<size_t> dis(0, m_maxSteps - 1);
+        for (int i = 0; i < m_numOfChangePoints; i++)
+        {
+            m_changePoints.push_back(dis(m_generator));
+        }
+
+        std::sort(m_changePoints.begin(), m_changePoints.end());
+    }
+
+    return true;
+}
+
+size_t TestingServices::PCTStrategy::GetHighestEnabled(const EnabledSet& choices) const
+{
+    for (size_t position = 0; position < m_priorities.size(); position++)
+    {
+        if (choices.IsEnabled(m_priorities[position]))
+        {
+            return position;
+        }
+    }
+
+    return 0;
+}
+
+void TestingServices::PCTStrategy::SaveProgress(std::ostream& stream) const
+{
+    WriteProgress(stream, static_cast<uint64_t>(std::max(m_maxSteps, m_step)));
+}
+
+bool TestingServices::PCTStrategy::LoadProgress(std::istream& stream)
+{
+    uint64_t maxSteps;
+    if (!ReadProgress(stream, maxSteps))
+    {
+        return false;
+    }
+
+    m_maxSteps = static_cast<size_t>(maxSteps);
+    return true;
+}
+
+TestingServices::PCTStrategy::~PCTStrategy() { }
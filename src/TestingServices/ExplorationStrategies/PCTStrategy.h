@@ -0,0 +1,91 @@
+//-----------------------------------------------------------------------
+// <copyright file="PCTStrategy.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_PCTSTRATEGY_H
+#define MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_PCTSTRATEGY_H
+
+#include "../IExplorationStrategy.h"
+#include <random>
+#include <vector>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Probabilistic concurrency testing strategy. Each process gets a random
+    // priority when it is created, and the enabled process with the highest
+    // priority is scheduled. At depth - 1 random steps of each iteration, the
+    // scheduled process is demoted to the lowest priority. The steps are chosen
+    // among the longest iteration explored so far.
+    class PCTStrategy : public IExplorationStrategy
+    {
+    public:
+        PCTStrategy(unsigned int seed, int depth);
+        ~PCTStrategy();
+
+        // Returns the next process to schedule.
+        bool TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current);
+
+        // Returns the next boolean choice.
+        bool GetNextBooleanChoice(int maxValue, bool& next);
+
+        // Returns the next integer choice.
+        bool GetNextIntegerChoice(int maxValue, int& next);
+
+        // Checks if the strategy is fair.
+        bool IsFair();
+
+        // Prepares the strategy for the specified iteration.
+        bool PrepareForNextIteration(int iteration);
+
+        // Writes the progress of the campaign.
+        void SaveProgress(std::ostream& stream) const;
+
+        // Reads the progress of a campaign.
+        bool LoadProgress(std::istream& stream);
+
+    private:
+        // Seed of the testing campaign.
+        unsigned int m_campaignSeed;
+
+        // Random integer generator.
+        std::mt19937 m_generator;
+
+        // Number of priority change points per iteration.
+        int m_numOfChangePoints;
+
+        // Indexes of the known processes, from the highest to the lowest priority.
+        std::vector<size_t> m_priorities;
+
+        // Steps of this iteration at which priorities change, in ascending order.
+        std::vector<size_t> m_changePoints;
+
+        // Position of the next priority change point.
+        size_t m_nextChangePoint;
+
+        // Number of scheduling steps taken during this iteration.
+        size_t m_step;
+
+        // Maximum number of scheduling steps of an explored iteration.
+        size_t m_maxSteps;
+
+        // Returns the position in the priority list of the enabled process
+        // with the highest priority.
+        size_t GetHighestEnabled(const EnabledSet& choices) const;
+
+        // Copy is disabled.
+        PCTStrategy(const PCTStrategy& that) = delete;
+        PCTStrategy &operator=(PCTStrategy const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_PCTSTRATEGY_H
@@ -0,0 +1,291 @@
+//-----------------------------------------------------------------------
+// <copyright file="ProductionReplayStrategy.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "ProductionReplayStrategy.h"
+#include "RandomStrategy.h"
+#include <algorithm>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+// Key of the operations of the program, which performs them outside of any actor.
+static const long ProgramActor = -1;
+
+// Key of the operations of the timers.
+static const long TimerActor = -2;
+
+// Number of pending operations of an actor that a performed operation is matched
+// against, so that an operation that did not happen does not stall the replay.
+static const size_t MaxLookahead = 16;
+
+TestingServices::ProductionReplayStrategy::ProductionReplayStrategy(
+    const std::vector<EventTraceRecorder::Record>& records, unsigned int seed, int maxDeviations)
+{
+    for (auto& record : records)
+    {
+        if (record.Type == EventTraceRecorder::RecordType::BooleanChoice ||
+            record.Type == EventTraceRecorder::RecordType::IntegerChoice)
+        {
+            m_actors[record.Actor].Choices.push_back({ record.Type, record.Value });
+        }
+        else
+        {
+            long actor = record.Type == EventTraceRecorder::RecordType::FireTimer ? TimerActor : record.Actor;
+            m_actors[actor].Operations.push_back(m_operations.size());
+            m_operations.push_back({ record.Type, record.Target, record.Value, false });
+        }
+    }
+
+    m_current = 0;
+    m_hasDiverged = false;
+    m_campaignSeed = seed;
+    m_generator.seed(seed);
+    m_maxDeviations = maxDeviations > 0 ? maxDeviations : 0;
+    m_nextDeviation = 0;
+    m_step = 0;
+    m_maxSteps = 0;
+}
+
+bool TestingServices::ProductionReplayStrategy::TryGetNext(ActorInfo*& next,
+    const EnabledSet& choices, ActorInfo& current)
+{
+    if (choices.EnabledCount() == 0)
+    {
+        return false;
+    }
+
+    next = nullptr;
+    if (m_nextDeviation < m_deviations.size() && m_deviations[m_nextDeviation] == m_step)
+    {
+        while (m_nextDeviation < m_deviations.size() && m_deviations[m_nextDeviation] == m_step)
+        {
+            m_nextDeviation++;
+        }
+
+        std::uniform_int_distribution<size_t> dis(0, choices.EnabledCount() - 1);
+        next = choices.GetEnabled(dis(m_generator));
+    }
+    else
+    {
+        size_t first = m_operations.size();
+        for (size_t index = 0; index < choices.Size(); index++)
+        {
+            if (choices.IsEnabled(index))
+            {
+                auto position = GetNextOperation(GetProductionActor(static_cast<long>(index)));
+                if (position < first)
+                {
+                    first = position;
+                    next = choices.Get(index);
+                }
+            }
+        }
+
+        // Processes without recorded operations left run in round-robin order.
+        if (next == nullptr)
+        {
+            next = current.IsEnabled ? &current : choices.GetNextEnabled(current.Index);
+        }
+    }
+
+    m_current = next->Index;
+    m_step++;
+    return true;
+}
+
+bool TestingServices::ProductionReplayStrategy::GetNextBooleanChoice(int maxValue, bool& next)
+{
+    auto choice = GetNextChoice(EventTraceRecorder::RecordType::BooleanChoice);
+    if (choice != nullptr)
+    {
+        next = choice->Value != 0;
+        return true;
+    }
+
+    m_hasDiverged = true;
+    next = GetRandomBooleanChoice(m_generator, maxValue);
+    return true;
+}
+
+bool TestingServices::ProductionReplayStrategy::GetNextIntegerChoice(int maxValue, int& next)
+{
+    auto choice = GetNextChoice(EventTraceRecorder::RecordType::IntegerChoice);
+    if (choice != nullptr && choice->Value < static_cast<uint64_t>(std::max(maxValue, 1)))
+    {
+        next = static_cast<int>(choice->Value);
+        return true;
+    }
+
+    m_hasDiverged = true;
+    next = GetRandomIntegerChoice(m_generator, maxValue);
+    return true;
+}
+
+bool TestingServices::ProductionReplayStrategy::GetNextTimerChoice(bool& next)
+{
+    size_t first = m_operations.size();
+    for (auto& entry : m_actors)
+    {
+        if (entry.first != TimerActor && entry.first != ProgramActor)
+        {
+            first = std::min(first, GetNextOperation(entry.first));
+        }
+    }
+
+    next = GetNextOperation(TimerActor) < first;
+    return true;
+}
+
+bool TestingServices::ProductionReplayStrategy::IsFair()
+{
+    return false;
+}
+
+bool TestingServices::ProductionReplayStrategy::PrepareForNextIteration(int iteration)
+{
+    for (auto& operation : m_operations)
+    {
+        operation.IsPerformed = false;
+    }
+
+    for (auto& entry : m_actors)
+    {
+        entry.second.NextOperation = 0;
+        entry.second.NextChoice = 0;
+    }
+
+    m_productionActors.clear();
+    m_current = 0;
+    m_hasDiverged = false;
+    m_maxSteps = std::max(m_maxSteps, m_step);
+    m_step = 0;
+    m_nextDeviation = 0;
+    m_generator.seed(RandomStrategy::GetIterationSeed(m_campaignSeed, iteration));
+
+    // The first iteration follows the trace.
+    m_deviations.clear();
+    if (iteration > 0 && m_maxSteps > 0)
+    {
+        std::uniform_int_distribution<size_t> dis(0, m_maxSteps - 1);
+        for (int i = 0; i < m_maxDeviations; i++)
+        {
+            m_deviations.push_back(dis(m_generator));
+        }
+
+        std::sort(m_deviations.begin(), m_deviations.end());
+    }
+
+    return true;
+}
+
+void TestingServices::ProductionReplayStrategy::NotifyOperation(EventTraceRecorder::RecordType type,
+    long process, long target, uint64_t value)
+{
+    // The production actor of a created process is only known once its
+    // creation is matched with the trace.
+    bool isCreation = type == EventTraceRecorder::RecordType::CreateActor;
+    long actor = type == EventTraceRecorder::RecordType::FireTimer ? TimerActor : GetProductionActor(process);
+    size_t position;
+    if (!TryPerform(actor, type, isCreation ? -1 : GetProductionActor(target), value, position))
+    {
+        m_hasDiverged = true;
+        return;
+    }
+
+    if (isCreation)
+    {
+        if (static_cast<size_t>(target) >= m_productionActors.size())
+        {
+            m_productionActors.resize(static_cast<size_t>(target) + 1, -1);
+        }
+
+        m_productionActors[static_cast<size_t>(target)] = m_operations[position].Target;
+    }
+}
+
+bool TestingServices::ProductionReplayStrategy::HasDiverged() const
+{
+    return m_hasDiverged;
+}
+
+long TestingServices::ProductionReplayStrategy::GetProductionActor(long process) const
+{
+    if (process < 0)
+    {
+        return ProgramActor;
+    }
+
+    auto index = static_cast<size_t>(process);
+    return index < m_productionActors.size() && m_productionActors[index] >= 0 ?
+        m_productionActors[index] : process;
+}
+
+size_t TestingServices::ProductionReplayStrategy::GetNextOperation(long actor) const
+{
+    auto entry = m_actors.find(actor);
+    if (entry == m_actors.end() || entry->second.NextOperation == entry->second.Operations.size())
+    {
+        return m_operations.size();
+    }
+
+    return entry->second.Operations[entry->second.NextOperation];
+}
+
+bool TestingServices::ProductionReplayStrategy::TryPerform(long actor, EventTraceRecorder::RecordType type,
+    long target, uint64_t value, size_t& position)
+{
+    auto entry = m_actors.find(actor);
+    if (entry == m_actors.end())
+    {
+        return false;
+    }
+
+    auto& trace = entry->second;
+    auto end = std::min(trace.Operations.size(), trace.NextOperation + MaxLookahead);
+    for (auto next = trace.NextOperation; next < end; next++)
+    {
+        auto& operation = m_operations[trace.Operations[next]];
+        if (!operation.IsPerformed && operation.Type == type &&
+            (type == EventTraceRecorder::RecordType::CreateActor ||
+            (operation.Target == target && operation.Value == value)))
+        {
+            operation.IsPerformed = true;
+            position = trace.Operations[next];
+            while (trace.NextOperation < trace.Operations.size() &&
+                m_operations[trace.Operations[trace.NextOperation]].IsPerformed)
+            {
+                trace.NextOperation++;
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const ProductionReplayStrategy::Choice* TestingServices::ProductionReplayStrategy::GetNextChoice(
+    EventTraceRecorder::RecordType type)
+{
+    auto entry = m_actors.find(GetProductionActor(static_cast<long>(m_current)));
+    if (entry == m_actors.end() || entry->second.NextChoice == entry->second.Choices.size() ||
+        entry->second.Choices[entry->second.NextChoice].Type != type)
+    {
+        return nullptr;
+    }
+
+    return &entry->second.Choices[entry->second.NextChoice++];
+}
+
+TestingServices::ProductionReplayStrategy::~ProductionReplayStrategy() { }
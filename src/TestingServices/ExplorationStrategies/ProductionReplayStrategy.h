@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------
+// <copyright file="ProductionReplayStrategy.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_PRODUCTIONREPLAYSTRATEGY_H
+#define MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_PRODUCTIONREPLAYSTRATEGY_H
+
+#include "../IExplorationStrategy.h"
+#include "../../Runtime/EventTraceRecorder.h"
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Strategy that replays an event trace recorded in production. It schedules
+    // the enabled process whose next recorded operation comes first, so that
+    // actors are created, and events enter inboxes, in the recorded order, and
+    // takes the recorded choices of each actor. The first iteration follows the
+    // trace, and later ones schedule a random process instead at a bounded
+    // number of random steps, to explore the schedules around it.
+    class ProductionReplayStrategy : public IExplorationStrategy
+    {
+    public:
+        ProductionReplayStrategy(const std::vector<EventTraceRecorder::Record>& records, unsigned int seed,
+            int maxDeviations);
+        ~ProductionReplayStrategy();
+
+        // Returns the next process to schedule.
+        bool TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current);
+
+        // Returns the next boolean choice.
+        bool GetNextBooleanChoice(int maxValue, bool& next);
+
+        // Returns the next integer choice.
+        bool GetNextIntegerChoice(int maxValue, int& next);
+
+        // Fires the next timer if the trace records its event next.
+        bool GetNextTimerChoice(bool& next);
+
+        // Checks if the strategy is fair.
+        bool IsFair();
+
+        // Prepares the strategy for the specified iteration.
+        bool PrepareForNextIteration(int iteration);
+
+        // Matches a performed operation with the trace.
+        void NotifyOperation(EventTraceRecorder::RecordType type, long process, long target, uint64_t value);
+
+        // Checks if the last iteration performed an operation, or took a
+        // choice, that the trace does not record.
+        bool HasDiverged() const;
+
+    private:
+        // A recorded operation, which is performed at most once per iteration.
+        struct Operation
+        {
+            EventTraceRecorder::RecordType Type;
+            long Target;
+            uint64_t Value;
+            bool IsPerformed;
+        };
+
+        // A recorded choice.
+        struct Choice
+        {
+            EventTraceRecorder::RecordType Type;
+            uint64_t Value;
+        };
+
+        // Operations and choices of a production actor, in recorded order.
+        struct ActorTrace
+        {
+            // Positions of the operations in the trace.
+            std::vector<size_t> Operations;
+
+            // Position in the operations of the first one to perform.
+            size_t NextOperation;
+
+            std::vector<Choice> Choices;
+
+            // Position of the next choice to take.
+            size_t NextChoice;
+        };
+
+        // Recorded operations, in their global order.
+        std::vector<Operation> m_operations;
+
+        // Traces of the production actors, of the program, and of the timers.
+        std::unordered_map<long, ActorTrace> m_actors;
+
+        // Production actor of each process, by creation index, or -1 if the
+        // creation of the process was not recorded.
+        std::vector<long> m_productionActors;
+
+        // Index of the process that was scheduled last.
+        size_t m_current;
+
+        // Set if the iteration diverged from the trace.
+        bool m_hasDiverged;
+
+        // Seed of the testing campaign.
+        unsigned int m_campaignSeed;
+
+        // Random integer generator.
+        std::mt19937 m_generator;
+
+        // Maximum number of deviations per iteration.
+        int m_maxDeviations;
+
+        // Steps of this iteration at which a random process is scheduled, in
+        // ascending order.
+        std::vector<size_t> m_deviations;
+
+        // Position of the next deviation.
+        size_t m_nextDeviation;
+
+        // Number of scheduling steps taken during this iteration.
+        size_t m_step;
+
+        // Maximum number of scheduling steps of an explored iteration.
+        size_t m_maxSteps;
+
+        // Returns the production actor of the specified process, or -1 if negative.
+        long GetProductionActor(long process) const;
+
+        // Returns the position in the trace of the next operation of the
+        // specified production actor, or the length of the trace if none.
+        size_t GetNextOperation(long actor) const;
+
+        // Marks the first pending operation of the specified production actor
+        // that matches as performed, and returns its position. Returns false
+        // if no operation matches.
+        bool TryPerform(long actor, EventTraceRecorder::RecordType type, long target, uint64_t value,
+            size_t& position);
+
+        // Returns the next recorded choice of the scheduled process, if it has
+        // the specified type, or null.
+        const Choice* GetNextChoice(EventTraceRecorder::RecordType type);
+
+        // Copy is disabled.
+        ProductionReplayStrategy(const ProductionReplayStrategy& that) = delete;
+        ProductionReplayStrategy &operator=(ProductionReplayStrategy const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_PRODUCTIONREPLAYSTRATEGY_H
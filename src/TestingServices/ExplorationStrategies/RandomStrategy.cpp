@@ -13,45 +13,66 @@
 //-----------------------------------------------------------------------
 
 #include "RandomStrategy.h"
+#include <algorithm>
+#include <cstdint>
 
 using namespace Microsoft::P3;
 using namespace TestingServices;
 
-TestingServices::RandomStrategy::RandomStrategy()
+TestingServices::RandomStrategy::RandomStrategy(unsigned int seed)
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<size_t> dis(std::mt19937::min(), std::mt19937::max());
-    m_seed = dis(gen);
-    m_generator.seed((unsigned int)m_seed);
+    m_campaignSeed = seed;
+    m_seed = seed;
+    m_generator.seed(m_seed);
 }
 
 bool TestingServices::RandomStrategy::TryGetNext(ActorInfo*& next,
-    std::vector<ActorInfo*> choices, ActorInfo& current)
+    const EnabledSet& choices, ActorInfo& current)
 {
-    std::vector<ActorInfo*> enabled;
-    for (auto& p : choices)
-    {
-        if (p->IsEnabled)
-        {
-            enabled.push_back(p);
-        }
-    }
-
-    if (enabled.empty())
+    if (choices.EnabledCount() == 0)
     {
         return false;
     }
 
-    std::uniform_int_distribution<size_t> dis(0, enabled.size() - 1);
-    next = enabled[dis(m_generator)];
+    std::uniform_int_distribution<size_t> dis(0, choices.EnabledCount() - 1);
+    next = choices.GetEnabled(dis(m_generator));
 
     return true;
 }
 
 bool TestingServices::RandomStrategy::GetNextBooleanChoice(int maxValue, bool& next)
 {
-    return false;
+    next = GetRandomBooleanChoice(m_generator, maxValue);
+    return true;
+}
+
+bool TestingServices::RandomStrategy::GetNextIntegerChoice(int maxValue, int& next)
+{
+    next = GetRandomIntegerChoice(m_generator, maxValue);
+    return true;
+}
+
+bool TestingServices::RandomStrategy::IsFair()
+{
+    return true;
+}
+
+bool TestingServices::RandomStrategy::PrepareForNextIteration(int iteration)
+{
+    // Each iteration uses its own seed, so that it can be reproduced
+    // without running the iterations that preceded it.
+    m_seed = GetIterationSeed(m_campaignSeed, iteration);
+    m_generator.seed(m_seed);
+    return true;
+}
+
+unsigned int TestingServices::RandomStrategy::GetIterationSeed(unsigned int seed, int iteration)
+{
+    // Mixes the seed with the iteration using the SplitMix64 finalizer.
+    uint64_t z = (static_cast<uint64_t>(seed) << 32) + static_cast<uint64_t>(iteration) + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return static_cast<unsigned int>(z ^ (z >> 31));
 }
 
 TestingServices::RandomStrategy::~RandomStrategy() { }
@@ -18,7 +18,6 @@
 #include "../IExplorationStrategy.h"
 #include <memory>
 #include <random>
-#include <vector>
 
 namespace Microsoft { namespace P3 { namespace TestingServices
 {
@@ -26,18 +25,33 @@ namespace Microsoft { namespace P3 { namespace TestingServices
     class RandomStrategy : public IExplorationStrategy
     {
     public:
-        RandomStrategy();
+        RandomStrategy(unsigned int seed);
         ~RandomStrategy();
 
         // Returns the next process to schedule.
-        bool TryGetNext(ActorInfo*& next, std::vector<ActorInfo*> choices, ActorInfo& current);
+        bool TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current);
 
         // Returns the next boolean choice.
         bool GetNextBooleanChoice(int maxValue, bool& next);
+
+        // Returns the next integer choice.
+        bool GetNextIntegerChoice(int maxValue, int& next);
+
+        // Checks if the strategy is fair.
+        bool IsFair();
+
+        // Prepares the strategy for the specified iteration.
+        bool PrepareForNextIteration(int iteration);
+
+        // Returns the seed derived from the campaign seed for the specified iteration.
+        static unsigned int GetIterationSeed(unsigned int seed, int iteration);
             
     private:
+        // Seed of the testing campaign.
+        unsigned int m_campaignSeed;
+
         // Seed used during this iteration.
-        size_t m_seed;
+        unsigned int m_seed;
 
         // Random integer generator.
         std::mt19937 m_generator;
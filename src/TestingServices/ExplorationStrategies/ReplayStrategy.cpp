@@ -0,0 +1,110 @@
+//-----------------------------------------------------------------------
+// <copyright file="ReplayStrategy.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "ReplayStrategy.h"
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+TestingServices::ReplayStrategy::ReplayStrategy(const ScheduleTrace& trace)
+    : m_trace(trace)
+{
+    m_position = 0;
+    m_isStarted = false;
+    m_hasDiverged = false;
+}
+
+bool TestingServices::ReplayStrategy::TryGetNext(ActorInfo*& next,
+    const EnabledSet& choices, ActorInfo& current)
+{
+    if (m_position >= m_trace.Count())
+    {
+        return false;
+    }
+
+    auto& step = m_trace.Get(m_position);
+    if (step.Type != ScheduleTrace::StepType::SchedulingChoice ||
+        step.Value >= choices.Size() || !choices.IsEnabled(step.Value))
+    {
+        m_hasDiverged = true;
+        return false;
+    }
+
+    next = choices.Get(step.Value);
+    m_position++;
+    return true;
+}
+
+bool TestingServices::ReplayStrategy::GetNextBooleanChoice(int maxValue, bool& next)
+{
+    if (m_position >= m_trace.Count())
+    {
+        return false;
+    }
+
+    auto& step = m_trace.Get(m_position);
+    if (step.Type != ScheduleTrace::StepType::BooleanChoice)
+    {
+        m_hasDiverged = true;
+        return false;
+    }
+
+    next = step.Value != 0;
+    m_position++;
+    return true;
+}
+
+bool TestingServices::ReplayStrategy::GetNextIntegerChoice(int maxValue, int& next)
+{
+    if (m_position >= m_trace.Count())
+    {
+        return false;
+    }
+
+    auto& step = m_trace.Get(m_position);
+    if (step.Type != ScheduleTrace::StepType::IntegerChoice || step.Value >= static_cast<uint32_t>(maxValue))
+    {
+        m_hasDiverged = true;
+        return false;
+    }
+
+    next = static_cast<int>(step.Value);
+    m_position++;
+    return true;
+}
+
+bool TestingServices::ReplayStrategy::IsFair()
+{
+    return false;
+}
+
+bool TestingServices::ReplayStrategy::PrepareForNextIteration(int iteration)
+{
+    // A trace is replayed only once.
+    if (m_isStarted)
+    {
+        return false;
+    }
+
+    m_isStarted = true;
+    m_position = 0;
+    return true;
+}
+
+bool TestingServices::ReplayStrategy::HasDiverged() const
+{
+    return m_hasDiverged;
+}
+
+TestingServices::ReplayStrategy::~ReplayStrategy() { }
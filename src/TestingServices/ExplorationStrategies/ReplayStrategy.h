@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------
+// <copyright file="ReplayStrategy.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_REPLAYSTRATEGY_H
+#define MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_REPLAYSTRATEGY_H
+
+#include "../IExplorationStrategy.h"
+#include "../Tracing/ScheduleTrace.h"
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Strategy that replays the choices of a recorded schedule trace.
+    class ReplayStrategy : public IExplorationStrategy
+    {
+    public:
+        ReplayStrategy(const ScheduleTrace& trace);
+        ~ReplayStrategy();
+
+        // Returns the next process to schedule.
+        bool TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current);
+
+        // Returns the next boolean choice.
+        bool GetNextBooleanChoice(int maxValue, bool& next);
+
+        // Returns the next integer choice.
+        bool GetNextIntegerChoice(int maxValue, int& next);
+
+        // Checks if the strategy is fair.
+        bool IsFair();
+
+        // Prepares the strategy for the specified iteration.
+        bool PrepareForNextIteration(int iteration);
+
+        // Checks if the execution diverged from the replayed trace.
+        bool HasDiverged() const;
+
+    private:
+        // The trace to replay.
+        ScheduleTrace m_trace;
+
+        // Position of the next choice to replay.
+        size_t m_position;
+
+        // True if the replay started.
+        bool m_isStarted;
+
+        // True if the execution diverged from the trace.
+        bool m_hasDiverged;
+
+        // Copy is disabled.
+        ReplayStrategy(const ReplayStrategy& that) = delete;
+        ReplayStrategy &operator=(ReplayStrategy const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_REPLAYSTRATEGY_H
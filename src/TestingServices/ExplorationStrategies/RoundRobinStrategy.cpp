@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------
+// <copyright file="RoundRobinStrategy.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "RoundRobinStrategy.h"
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+TestingServices::RoundRobinStrategy::RoundRobinStrategy()
+{
+    m_isExplored = false;
+}
+
+bool TestingServices::RoundRobinStrategy::TryGetNext(ActorInfo*& next,
+    const EnabledSet& choices, ActorInfo& current)
+{
+    if (choices.EnabledCount() == 0)
+    {
+        return false;
+    }
+
+    next = current.IsEnabled ? &current : choices.GetNextEnabled(current.Index);
+    return true;
+}
+
+bool TestingServices::RoundRobinStrategy::GetNextBooleanChoice(int maxValue, bool& next)
+{
+    next = false;
+    return true;
+}
+
+bool TestingServices::RoundRobinStrategy::GetNextIntegerChoice(int maxValue, int& next)
+{
+    next = 0;
+    return true;
+}
+
+bool TestingServices::RoundRobinStrategy::IsFair()
+{
+    return false;
+}
+
+bool TestingServices::RoundRobinStrategy::PrepareForNextIteration(int iteration)
+{
+    // Every iteration would explore the same schedule.
+    bool isExplored = m_isExplored;
+    m_isExplored = true;
+    return !isExplored;
+}
+
+void TestingServices::RoundRobinStrategy::SetSlice(int index, int count)
+{
+    m_isExplored = index > 0;
+}
+
+void TestingServices::RoundRobinStrategy::SaveProgress(std::ostream& stream) const
+{
+    WriteProgress(stream, static_cast<uint8_t>(m_isExplored ? 1 : 0));
+}
+
+bool TestingServices::RoundRobinStrategy::LoadProgress(std::istream& stream)
+{
+    uint8_t isExplored;
+    if (!ReadProgress(stream, isExplored))
+    {
+        return false;
+    }
+
+    m_isExplored = isExplored == 1;
+    return true;
+}
+
+TestingServices::RoundRobinStrategy::~RoundRobinStrategy() { }
@@ -0,0 +1,66 @@
+//-----------------------------------------------------------------------
+// <copyright file="RoundRobinStrategy.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_ROUNDROBINSTRATEGY_H
+#define MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_ROUNDROBINSTRATEGY_H
+
+#include "../IExplorationStrategy.h"
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Deterministic strategy that keeps running the current process while it
+    // is enabled, and then moves to the next enabled process in creation order.
+    // Boolean choices are false and integer choices are zero, so the strategy
+    // explores a single schedule.
+    class RoundRobinStrategy : public IExplorationStrategy
+    {
+    public:
+        RoundRobinStrategy();
+        ~RoundRobinStrategy();
+
+        // Returns the next process to schedule.
+        bool TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current);
+
+        // Returns the next boolean choice.
+        bool GetNextBooleanChoice(int maxValue, bool& next);
+
+        // Returns the next integer choice.
+        bool GetNextIntegerChoice(int maxValue, int& next);
+
+        // Checks if the strategy is fair.
+        bool IsFair();
+
+        // Prepares the strategy for the specified iteration.
+        bool PrepareForNextIteration(int iteration);
+
+        // Only the first slice explores the schedule.
+        void SetSlice(int index, int count);
+
+        // Writes whether the schedule was explored.
+        void SaveProgress(std::ostream& stream) const;
+
+        // Reads whether the schedule was explored.
+        bool LoadProgress(std::istream& stream);
+
+    private:
+        // Set once the schedule was explored.
+        bool m_isExplored;
+
+        // Copy is disabled.
+        RoundRobinStrategy(const RoundRobinStrategy& that) = delete;
+        RoundRobinStrategy &operator=(RoundRobinStrategy const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_ROUNDROBINSTRATEGY_H
@@ -0,0 +1,145 @@
+//-----------------------------------------------------------------------
+// <copyright file="StrategyPortfolio.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "StrategyPortfolio.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+TestingServices::StrategyPortfolio::StrategyPortfolio()
+{
+    m_arms.push_back({ ExplorationStrategy::Random, 0, 0, 0, 0 });
+    m_arms.push_back({ ExplorationStrategy::PCT, 2, 0, 0, 0 });
+    m_arms.push_back({ ExplorationStrategy::DelayBounding, 1, 0, 0, 0 });
+    m_arms.push_back({ ExplorationStrategy::CoverageGuided, 0, 0, 0, 0 });
+    m_arms.push_back({ ExplorationStrategy::PCT, 5, 0, 0, 0 });
+    m_arms.push_back({ ExplorationStrategy::DelayBounding, 3, 0, 0, 0 });
+}
+
+size_t TestingServices::StrategyPortfolio::Size() const
+{
+    return m_arms.size();
+}
+
+const StrategyPortfolio::Arm& TestingServices::StrategyPortfolio::Get(size_t arm) const
+{
+    return m_arms[arm];
+}
+
+std::string TestingServices::StrategyPortfolio::GetName(size_t arm) const
+{
+    auto& entry = m_arms[arm];
+    switch (entry.Strategy)
+    {
+    case ExplorationStrategy::PCT:
+        return "PCT(" + std::to_string(entry.Bound) + ")";
+    case ExplorationStrategy::DelayBounding:
+        return "DelayBounding(" + std::to_string(entry.Bound) + ")";
+    case ExplorationStrategy::CoverageGuided:
+        return "CoverageGuided";
+    default:
+        return "Random";
+    }
+}
+
+void TestingServices::StrategyPortfolio::Assign(size_t numOfWorkers, int iterationsPerWorker,
+    std::vector<size_t>& arms) const
+{
+    // Each assignment counts as pulls of the arm without reward, so that
+    // the workers of a round spread over the best arms.
+    std::vector<long long> iterations;
+    long long total = 0;
+    for (auto& arm : m_arms)
+    {
+        iterations.push_back(arm.NumOfIterations);
+        total += arm.NumOfIterations;
+    }
+
+    arms.clear();
+    for (size_t worker = 0; worker < numOfWorkers; worker++)
+    {
+        size_t best = 0;
+        double bestScore = -1;
+        for (size_t arm = 0; arm < m_arms.size(); arm++)
+        {
+            double score = std::numeric_limits<double>::infinity();
+            if (iterations[arm] > 0)
+            {
+                // Each iteration is rewarded with 0 or 1, so the mean reward is
+                // in [0, 1], as the exploration term of UCB1 assumes.
+                double reward = static_cast<double>(m_arms[arm].NumOfRewardedIterations);
+                score = reward / iterations[arm] +
+                    std::sqrt(2 * std::log(static_cast<double>(total + 1)) / iterations[arm]);
+            }
+
+            if (score > bestScore)
+            {
+                best = arm;
+                bestScore = score;
+            }
+        }
+
+        arms.push_back(best);
+        iterations[best] += iterationsPerWorker;
+        total += iterationsPerWorker;
+    }
+}
+
+void TestingServices::StrategyPortfolio::Update(size_t arm, int iterations, long long rewardedIterations, int bugs)
+{
+    m_arms[arm].NumOfIterations += iterations;
+    m_arms[arm].NumOfRewardedIterations += rewardedIterations;
+    m_arms[arm].NumOfFoundBugs += bugs;
+}
+
+void TestingServices::StrategyPortfolio::SaveProgress(std::ostream& stream) const
+{
+    uint32_t size = static_cast<uint32_t>(m_arms.size());
+    stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    for (auto& arm : m_arms)
+    {
+        stream.write(reinterpret_cast<const char*>(&arm.NumOfIterations), sizeof(arm.NumOfIterations));
+        stream.write(reinterpret_cast<const char*>(&arm.NumOfRewardedIterations), sizeof(arm.NumOfRewardedIterations));
+        stream.write(reinterpret_cast<const char*>(&arm.NumOfFoundBugs), sizeof(arm.NumOfFoundBugs));
+    }
+}
+
+bool TestingServices::StrategyPortfolio::LoadProgress(std::istream& stream)
+{
+    // Statistics of another set of strategies do not apply.
+    uint32_t size;
+    if (!stream.read(reinterpret_cast<char*>(&size), sizeof(size)) || size != m_arms.size())
+    {
+        return false;
+    }
+
+    std::vector<Arm> arms(m_arms);
+    for (auto& arm : arms)
+    {
+        if (!stream.read(reinterpret_cast<char*>(&arm.NumOfIterations), sizeof(arm.NumOfIterations)) ||
+            !stream.read(reinterpret_cast<char*>(&arm.NumOfRewardedIterations), sizeof(arm.NumOfRewardedIterations)) ||
+            !stream.read(reinterpret_cast<char*>(&arm.NumOfFoundBugs), sizeof(arm.NumOfFoundBugs)))
+        {
+            return false;
+        }
+    }
+
+    m_arms = arms;
+    return true;
+}
+
+TestingServices::StrategyPortfolio::~StrategyPortfolio() { }
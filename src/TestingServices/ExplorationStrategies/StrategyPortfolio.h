@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------
+// <copyright file="StrategyPortfolio.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_STRATEGYPORTFOLIO_H
+#define MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_STRATEGYPORTFOLIO_H
+
+#include "P3/TestingServices/ExplorationStrategy.h"
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Portfolio of exploration strategies that parallel workers are assigned
+    // to. It tracks how productive each strategy is, as the fraction of its
+    // iterations that were rewarded for covering activities or finding bugs,
+    // and assigns workers with the UCB1 bandit rule, so that iterations move
+    // toward productive strategies while the others are still tried from
+    // time to time.
+    class StrategyPortfolio
+    {
+    public:
+        // A strategy of the portfolio, and its statistics.
+        struct Arm
+        {
+            ExplorationStrategy Strategy;
+            int Bound;
+            long long NumOfIterations;
+            long long NumOfRewardedIterations;
+            int NumOfFoundBugs;
+        };
+
+        StrategyPortfolio();
+        ~StrategyPortfolio();
+
+        // Returns the number of strategies.
+        size_t Size() const;
+
+        // Returns the strategy at the specified position.
+        const Arm& Get(size_t arm) const;
+
+        // Returns the name of the strategy at the specified position.
+        std::string GetName(size_t arm) const;
+
+        // Assigns a strategy to each of the specified workers, which will
+        // run the specified number of iterations each.
+        void Assign(size_t numOfWorkers, int iterationsPerWorker, std::vector<size_t>& arms) const;
+
+        // Records the results of a worker that used the specified strategy: its
+        // iterations, those that covered activities that the worker had not
+        // covered before or found a bug, and its bugs.
+        void Update(size_t arm, int iterations, long long rewardedIterations, int bugs);
+
+        // Writes the statistics of the strategies, so that a resumed campaign
+        // keeps assigning workers from them.
+        void SaveProgress(std::ostream& stream) const;
+
+        // Reads the statistics written by SaveProgress. Returns false if the
+        // stream does not contain valid statistics.
+        bool LoadProgress(std::istream& stream);
+
+    private:
+        // The strategies.
+        std::vector<Arm> m_arms;
+
+        // Copy is disabled.
+        StrategyPortfolio(const StrategyPortfolio& that) = delete;
+        StrategyPortfolio &operator=(StrategyPortfolio const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_EXPLORATIONSTRATEGIES_STRATEGYPORTFOLIO_H
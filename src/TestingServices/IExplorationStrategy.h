@@ -16,8 +16,14 @@
 #define MICROSOFT_P3_TESTINGSERVICES_IEXPLORATIONSTRATEGY_H
 
 #include "Scheduling/ActorInfo.h"
+#include "Scheduling/EnabledSet.h"
+#include "../Runtime/EventTraceRecorder.h"
+#include <algorithm>
+#include <cstdint>
+#include <istream>
 #include <memory>
-#include <vector>
+#include <ostream>
+#include <random>
 
 namespace Microsoft { namespace P3 { namespace TestingServices
 {
@@ -28,12 +34,86 @@ namespace Microsoft { namespace P3 { namespace TestingServices
         IExplorationStrategy() { }
         virtual ~IExplorationStrategy() = 0 { }
 
-        // Returns the next process to schedule.
-        virtual bool TryGetNext(ActorInfo*& next, std::vector<ActorInfo*> choices, ActorInfo& current) = 0;
+        // Returns the next process to schedule from the enabled processes in the
+        // specified set. The set is owned by the scheduler and must not be kept.
+        virtual bool TryGetNext(ActorInfo*& next, const EnabledSet& choices, ActorInfo& current) = 0;
 
         // Returns the next boolean choice.
         virtual bool GetNextBooleanChoice(int maxValue, bool& next) = 0;
 
+        // Returns the next integer choice, in [0, maxValue).
+        virtual bool GetNextIntegerChoice(int maxValue, int& next) = 0;
+
+        // Returns whether the next pending timer fires before the next process
+        // is scheduled. By default, it is the next boolean choice.
+        virtual bool GetNextTimerChoice(bool& next) { return GetNextBooleanChoice(2, next); }
+
+        // Checks if the strategy is fair, so that a bounded iteration that ends
+        // with a monitor in a hot state can be reported as a liveness bug.
+        virtual bool IsFair() = 0;
+
+        // Prepares the strategy for the specified iteration. Returns false
+        // if the strategy has no more schedules to explore.
+        virtual bool PrepareForNextIteration(int iteration) = 0;
+
+        // Notifies the fingerprint of the program state before the next choice,
+        // if state hashing is enabled. Returns false to prune the rest of the
+        // iteration, as it starts from an explored state. By default, no state
+        // is pruned.
+        virtual bool NotifyVisitedState(uint64_t fingerprint) { return true; }
+
+        // Notifies an operation that the process with the specified index, or
+        // the program or a timer if negative, performed, as an event trace
+        // records it. The runtime only notifies operations when it replays a
+        // production trace.
+        virtual void NotifyOperation(EventTraceRecorder::RecordType type, long process, long target,
+            uint64_t value) { }
+
+        // Restricts the strategy to the specified slice, out of the specified
+        // number of disjoint slices of its schedules, which forked processes
+        // explore concurrently. Each slice runs every count-th iteration, so
+        // by default, the slices differ by the iterations that they run.
+        virtual void SetSlice(int index, int count) { }
+
+        // Writes the exploration progress that a resumed campaign continues
+        // from, and that a forked process reports back after each iteration.
+        // By default, the strategy keeps no progress across iterations.
+        virtual void SaveProgress(std::ostream& stream) const { }
+
+        // Reads the progress written by SaveProgress. Returns false if the
+        // stream does not contain valid progress.
+        virtual bool LoadProgress(std::istream& stream) { return true; }
+
+    protected:
+        // Returns a random boolean choice, which is true with probability
+        // 1/maxValue, and at most 1/2.
+        static bool GetRandomBooleanChoice(std::mt19937& generator, int maxValue)
+        {
+            std::uniform_int_distribution<int> dis(0, std::max(maxValue, 2) - 1);
+            return dis(generator) == 0;
+        }
+
+        // Returns a random integer choice, in [0, maxValue).
+        static int GetRandomIntegerChoice(std::mt19937& generator, int maxValue)
+        {
+            std::uniform_int_distribution<int> dis(0, std::max(maxValue, 1) - 1);
+            return dis(generator);
+        }
+
+        // Writes a value of the progress in its binary format.
+        template<typename T>
+        static void WriteProgress(std::ostream& stream, const T& value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        // Reads a value of the progress in its binary format.
+        template<typename T>
+        static bool ReadProgress(std::istream& stream, T& value)
+        {
+            return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+
     private:
         // Copy is disabled.
         IExplorationStrategy(const IExplorationStrategy& that) = delete;
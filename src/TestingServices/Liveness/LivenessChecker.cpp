@@ -0,0 +1,121 @@
+//-----------------------------------------------------------------------
+// <copyright file="LivenessChecker.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "LivenessChecker.h"
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+TestingServices::LivenessChecker::LivenessChecker()
+{
+    m_numOfHotMonitors = 0;
+    m_numOfEnteredStates = 0;
+}
+
+void TestingServices::LivenessChecker::RegisterMonitor(const Monitor* monitor, const std::string& name)
+{
+    m_monitors.push_back({ monitor, name, "", false, 0, 0 });
+}
+
+void TestingServices::LivenessChecker::NotifyEnteredState(const Monitor* monitor, const std::string& state,
+    bool isHot, bool isCold)
+{
+    m_numOfEnteredStates++;
+    for (auto& info : m_monitors)
+    {
+        if (info.Instance != monitor)
+        {
+            continue;
+        }
+
+        if (info.IsHot != isHot)
+        {
+            m_numOfHotMonitors += isHot ? 1 : -1;
+            info.HotSince = m_numOfEnteredStates;
+        }
+
+        info.State = state;
+        info.IsHot = isHot;
+        if (isCold)
+        {
+            info.Temperature = 0;
+        }
+
+        return;
+    }
+}
+
+bool TestingServices::LivenessChecker::HasHotMonitors() const
+{
+    return m_numOfHotMonitors > 0;
+}
+
+bool TestingServices::LivenessChecker::CheckTemperature(int threshold, std::string& report)
+{
+    for (auto& info : m_monitors)
+    {
+        if (info.IsHot && ++info.Temperature > threshold)
+        {
+            report = "Monitor '" + info.Name + "' detected potential liveness bug in hot state '" +
+                info.State + "'.";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TestingServices::LivenessChecker::CheckAtEndOfExecution(std::string& report) const
+{
+    for (auto& info : m_monitors)
+    {
+        if (info.IsHot)
+        {
+            report = "Monitor '" + info.Name + "' detected liveness bug in hot state '" +
+                info.State + "' at the end of execution.";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t TestingServices::LivenessChecker::GetNumOfEnteredStates() const
+{
+    return m_numOfEnteredStates;
+}
+
+bool TestingServices::LivenessChecker::CheckCycle(size_t numOfEnteredStates, std::string& report) const
+{
+    for (auto& info : m_monitors)
+    {
+        if (info.IsHot && info.HotSince <= numOfEnteredStates)
+        {
+            report = "Monitor '" + info.Name + "' detected liveness bug in hot state '" +
+                info.State + "' that a fair cycle of the execution can keep forever.";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void TestingServices::LivenessChecker::Clear()
+{
+    m_monitors.clear();
+    m_numOfHotMonitors = 0;
+    m_numOfEnteredStates = 0;
+}
+
+TestingServices::LivenessChecker::~LivenessChecker() { }
@@ -0,0 +1,95 @@
+//-----------------------------------------------------------------------
+// <copyright file="LivenessChecker.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_LIVENESS_LIVENESSCHECKER_H
+#define MICROSOFT_P3_TESTINGSERVICES_LIVENESS_LIVENESSCHECKER_H
+
+#include <string>
+#include <vector>
+
+namespace Microsoft { namespace P3
+{
+    class Monitor;
+} }
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Tracks the hot and cold states of the registered monitors. The temperature
+    // of a monitor increases at every scheduling step that it spends in a hot
+    // state, and is reset when it enters a cold state. A monitor that is too hot,
+    // or that is still hot when execution ends, indicates a liveness bug.
+    class LivenessChecker
+    {
+    public:
+        LivenessChecker();
+        ~LivenessChecker();
+
+        // Registers the specified monitor.
+        void RegisterMonitor(const Monitor* monitor, const std::string& name);
+
+        // Notifies that the specified monitor entered a state.
+        void NotifyEnteredState(const Monitor* monitor, const std::string& state, bool isHot, bool isCold);
+
+        // Checks if any monitor is in a hot state.
+        bool HasHotMonitors() const;
+
+        // Increases the temperature of the monitors in a hot state. Returns false,
+        // with a bug report, if a monitor exceeds the specified temperature.
+        bool CheckTemperature(int threshold, std::string& report);
+
+        // Checks that no monitor is in a hot state at the end of execution. Returns
+        // false, with a bug report, if a monitor is.
+        bool CheckAtEndOfExecution(std::string& report) const;
+
+        // Returns the number of states that monitors entered so far.
+        size_t GetNumOfEnteredStates() const;
+
+        // Checks that no monitor stayed hot since the specified number of entered
+        // states, when the execution reached a fair cycle that started then, and
+        // could repeat forever. Returns false, with a bug report, if one did.
+        bool CheckCycle(size_t numOfEnteredStates, std::string& report) const;
+
+        // Removes all monitors.
+        void Clear();
+
+    private:
+        // Liveness information of a registered monitor.
+        struct MonitorInfo
+        {
+            const Monitor* Instance;
+            std::string Name;
+            std::string State;
+            bool IsHot;
+            int Temperature;
+
+            // Number of entered states when the monitor last became hot.
+            size_t HotSince;
+        };
+
+        // The registered monitors.
+        std::vector<MonitorInfo> m_monitors;
+
+        // Number of monitors in a hot state.
+        size_t m_numOfHotMonitors;
+
+        // Number of states that monitors entered.
+        size_t m_numOfEnteredStates;
+
+        // Copy is disabled.
+        LivenessChecker(const LivenessChecker& that) = delete;
+        LivenessChecker &operator=(LivenessChecker const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_LIVENESS_LIVENESSCHECKER_H
@@ -14,11 +14,26 @@
 
 #include "ActorInfo.h"
 #include <iostream>
+#ifdef P3_USE_FUTEX_HANDOFF
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 using namespace Microsoft::P3;
 using namespace TestingServices;
 
-TestingServices::ActorInfo::ActorInfo(long id)
+TestingServices::ActorInfo::ActorInfo(long id, size_t index)
+{
+    Index = index;
+#ifdef P3_USE_FUTEX_HANDOFF
+    m_handoffs = 0;
+#endif
+    Reset(id);
+}
+
+void TestingServices::ActorInfo::Reset(long id)
 {
     Id = id;
     IsEnabled = true;
@@ -27,4 +42,72 @@ TestingServices::ActorInfo::ActorInfo(long id)
     IsHalted = false;
 }
 
+void TestingServices::ActorInfo::Activate()
+{
+    Signal(IsActive);
+}
+
+void TestingServices::ActorInfo::NotifyStarted()
+{
+    Signal(HasStarted);
+}
+
+void TestingServices::ActorInfo::WaitUntilActive()
+{
+    WaitFor(IsActive);
+}
+
+void TestingServices::ActorInfo::WaitUntilStarted()
+{
+    WaitFor(HasStarted);
+}
+
+#ifdef P3_USE_FUTEX_HANDOFF
+void TestingServices::ActorInfo::Signal(std::atomic<bool>& flag)
+{
+    static_assert(sizeof(m_handoffs) == sizeof(int), "A futex word must be an int.");
+
+    // The release store publishes the writes before it to the thread that
+    // observes the flag, and the increment wakes that thread up.
+    flag.store(true, std::memory_order_release);
+    m_handoffs.fetch_add(1, std::memory_order_release);
+
+    // Normally a single thread waits on a process: its own thread for being
+    // scheduled, or its creator for the process to start. Waking all of them
+    // also releases a thread of a canceled iteration that still waits on a
+    // reused process.
+    syscall(SYS_futex, reinterpret_cast<int*>(&m_handoffs), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+void TestingServices::ActorInfo::WaitFor(const std::atomic<bool>& flag)
+{
+    for (;;)
+    {
+        // The wait returns at once if the word changed after it was read,
+        // so a flag set in between is never missed.
+        uint32_t handoffs = m_handoffs.load(std::memory_order_acquire);
+        if (flag.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        syscall(SYS_futex, reinterpret_cast<int*>(&m_handoffs), FUTEX_WAIT_PRIVATE,
+            static_cast<int>(handoffs), nullptr, nullptr, 0);
+    }
+}
+#else
+void TestingServices::ActorInfo::Signal(std::atomic<bool>& flag)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    flag.store(true, std::memory_order_relaxed);
+    m_cv.notify_all();
+}
+
+void TestingServices::ActorInfo::WaitFor(const std::atomic<bool>& flag)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_cv.wait(lock, [&flag] { return flag.load(std::memory_order_relaxed); });
+}
+#endif
+
 TestingServices::ActorInfo::~ActorInfo() { }
@@ -15,8 +15,14 @@
 #ifndef MICROSOFT_P3_TESTINGSERVICES_SCHEDULING_PROCESSINFO_H
 #define MICROSOFT_P3_TESTINGSERVICES_SCHEDULING_PROCESSINFO_H
 
+#include <atomic>
+#include <cstddef>
+#ifdef P3_USE_FUTEX_HANDOFF
+#include <cstdint>
+#else
 #include <condition_variable>
 #include <mutex>
+#endif
 
 namespace Microsoft { namespace P3 { namespace TestingServices
 {
@@ -30,17 +36,52 @@ namespace Microsoft { namespace P3 { namespace TestingServices
     public:
         // Unique id.
         long Id;
+
+        // Dense index of the process in the enabled set of the scheduler.
+        size_t Index;
+
         bool IsEnabled;
-        bool IsActive;
-        bool HasStarted;
         bool IsHalted;
 
-        ActorInfo(long id);
+        // Handoff flags, which one thread sets while another waits for them.
+        std::atomic<bool> IsActive;
+        std::atomic<bool> HasStarted;
+
+        ActorInfo(long id, size_t index);
         ~ActorInfo();
 
+        // Resets the info, so that it can be reused for a new process
+        // with the same index.
+        void Reset(long id);
+
+        // Marks the process as scheduled, and wakes up its thread.
+        void Activate();
+
+        // Marks the process as started, and wakes up its creator.
+        void NotifyStarted();
+
+        // Blocks the calling thread until the process is scheduled.
+        void WaitUntilActive();
+
+        // Blocks the calling thread until the process has started.
+        void WaitUntilStarted();
+
     private:
+#ifdef P3_USE_FUTEX_HANDOFF
+        // Number of times a flag of the process was set. Waiters block on this
+        // word, so a handoff between two processes is a single futex wake and
+        // a single futex wait.
+        std::atomic<uint32_t> m_handoffs;
+#else
         std::mutex m_lock;
         std::condition_variable m_cv;
+#endif
+
+        // Sets the specified flag, and wakes up the thread that waits for it.
+        void Signal(std::atomic<bool>& flag);
+
+        // Blocks the calling thread until the specified flag is set.
+        void WaitFor(const std::atomic<bool>& flag);
 
         // Copy is disabled.
         ActorInfo(const ActorInfo& that) = delete;
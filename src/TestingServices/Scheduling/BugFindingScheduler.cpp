@@ -23,91 +23,239 @@ using namespace Microsoft::P3;
 using namespace TestingServices;
 
 // Creates a new runtime.
-TestingServices::BugFindingScheduler::BugFindingScheduler(Configuration* config, IExplorationStrategy* strategy)
+TestingServices::BugFindingScheduler::BugFindingScheduler(Configuration* config, IExplorationStrategy* strategy,
+    VirtualClock* clock, StateHasher hasher)
 {
     m_config = config;
     m_strategy = strategy;
+    m_clock = clock;
+    m_stateHasher = hasher;
+    m_scheduledProcessInfo = nullptr;
     IsSchedulerRunning = true;
     HasFullyExploredSchedule = false;
     BugFound = false;
+    IsCutOff = false;
+    IsDeadlocked = false;
+    IsHung = false;
+    m_schedulingSteps = 0;
+    m_progress = 0;
+    m_watchdogTimeout = std::chrono::milliseconds(config->WatchdogTimeout > 0 ? config->WatchdogTimeout : 0);
+    m_maxSchedulingSteps = config->MaxSchedulingSteps > 0 ? config->MaxSchedulingSteps : 0;
+    m_numOfFiredTimers = 0;
+    m_maxTimerFirings = config->MaxTimerFirings > 0 ? config->MaxTimerFirings : 0;
+    m_hasStopped = false;
+    m_hasDeadline = false;
+
+    // By default, a monitor can stay hot for half of the bounded iteration.
+    m_livenessTemperatureThreshold = config->LivenessTemperatureThreshold > 0 ?
+        config->LivenessTemperatureThreshold : config->MaxSchedulingSteps / 2;
+    if (m_livenessTemperatureThreshold < 0)
+    {
+        m_livenessTemperatureThreshold = 0;
+    }
 }
 
-void TestingServices::BugFindingScheduler::Schedule()
+TestingServices::ActorInfo* TestingServices::BugFindingScheduler::ScheduleNext()
 {
-    // std::cout << "================" << std::endl;
-    // std::cout << "scheduling point" << std::endl;
-    // std::cout << "================" << std::endl;
     if (m_actorMap.empty())
     {
         // If this is the first scheduling point, then return.
-        return;
+        return nullptr;
     }
 
+    m_progress.fetch_add(1, std::memory_order_release);
+    CancelIfStopped();
+
     if (!IsSchedulerRunning)
     {
         Stop();
-        return;
+        return nullptr;
+    }
+
+    if (m_maxSchedulingSteps > 0 && m_schedulingSteps.load(std::memory_order_relaxed) >= m_maxSchedulingSteps)
+    {
+        if (m_config->Verbosity)
+        {
+            std::cout << "<ScheduleLog> Reached the max scheduling steps bound." << std::endl;
+        }
+
+        // A fair strategy would have let a hot monitor cool down by now.
+        if (m_strategy->IsFair())
+        {
+            CheckLivenessAtEndOfExecution();
+        }
+
+        IsCutOff = true;
+        Stop();
+        return nullptr;
+    }
+
+    if (m_hasDeadline && std::chrono::steady_clock::now() >= m_deadline)
+    {
+        if (m_config->Verbosity)
+        {
+            std::cout << "<ScheduleLog> Iteration timed out." << std::endl;
+        }
+
+        IsCutOff = true;
+        Stop();
+        return nullptr;
+    }
+
+    if (m_livenessTemperatureThreshold > 0 && m_livenessChecker.HasHotMonitors())
+    {
+        std::string report;
+        if (!m_livenessChecker.CheckTemperature(m_livenessTemperatureThreshold, report))
+        {
+            NotifyLivenessFailure(report);
+        }
+    }
+
+    // A pending timer fires when the strategy chooses to, so that timeouts
+    // race with the other events, and time advances to the next timer once
+    // no process is enabled. Once the timer bound is reached, no timer fires,
+    // and the iteration ends when only timers remain.
+    if (CanFireTimer() && m_enabledSet.EnabledCount() > 0)
+    {
+        NotifyEndOfPrefix();
+        bool isFired = false;
+        if (!m_strategy->GetNextTimerChoice(isFired))
+        {
+            if (m_config->Verbosity)
+            {
+                std::cout << "<ScheduleLog> Schedule explored." << std::endl;
+            }
+
+            HasFullyExploredSchedule = true;
+            Stop();
+        }
+
+        m_trace.AddBooleanChoice(isFired);
+        if (isFired)
+        {
+            FireNextTimer();
+        }
+    }
+
+    while (m_enabledSet.EnabledCount() == 0 && CanFireTimer())
+    {
+        FireNextTimer();
+    }
+
+    if (m_config->Verbosity && m_enabledSet.EnabledCount() == 0 && m_clock->HasPendingTimers())
+    {
+        std::cout << "<ScheduleLog> Reached the max timer firings bound." << std::endl;
+    }
+
+    if (m_enabledSet.EnabledCount() != 1)
+    {
+        NotifyEndOfPrefix();
+    }
+
+    if (m_stateHasher)
+    {
+        CheckVisitedState(m_stateHasher());
     }
 
     auto current = m_scheduledProcessInfo;
     ActorInfo* next = nullptr;
-    if (!m_strategy->TryGetNext(next, GetProcessInfos(), *current))
+    if (!m_strategy->TryGetNext(next, m_enabledSet, *current))
     {
         if (m_config->Verbosity)
         {
             std::cout << "<ScheduleLog> Schedule explored." << std::endl;
         }
-        
+
+        CheckLivenessAtEndOfExecution();
         HasFullyExploredSchedule = true;
         Stop();
-        return;
+        return nullptr;
     }
     
     m_scheduledProcessInfo = next;
+    m_schedulingSteps.fetch_add(1, std::memory_order_relaxed);
+    m_trace.AddSchedulingChoice(next->Index);
+    return next;
+}
 
-    // std::cout << "previous: " << current->Id << " :: " << std::this_thread::get_id() << std::endl;
-    // std::cout << "scheduling: " << next->Id << " :: " << std::this_thread::get_id() << std::endl;
+void TestingServices::BugFindingScheduler::Schedule()
+{
+    auto current = m_scheduledProcessInfo;
+    auto next = ScheduleNext();
 
     // Only a single process should be running at a time during
     // testing. For this reason we serialize the execution.
-    if (current->Id != next->Id)
+    if (next != nullptr && current->Id != next->Id)
     {
-        current->IsActive = false;
-
-        {
-            // Wakes up the next scheduled process.
-            std::lock_guard<std::mutex> nextLock(next->m_lock);
-            next->IsActive = true;
-            // std::cout << "unlocking: " << next->Id << " :: " << std::this_thread::get_id() << std::endl;
-            next->m_cv.notify_all();
-            // std::cout << "unlocked: " << next->Id << " :: " << std::this_thread::get_id() << std::endl;
-        }
+        current->IsActive.store(false, std::memory_order_relaxed);
 
-        {
-            // Waits to be scheduled again.
-            std::unique_lock<std::mutex> currentLock(current->m_lock);
-            // std::cout << "sleeping: " << current->Id << " :: " << std::this_thread::get_id() << std::endl;
-            current->m_cv.wait(currentLock, [current]{ return current->IsActive; });
-            // std::cout << "woke up: " << current->Id << " :: " << std::this_thread::get_id() << std::endl;
-        }
+        // Wakes up the next scheduled process, and waits to be scheduled again.
+        next->Activate();
+        current->WaitUntilActive();
 
-        if (!current->IsEnabled)
+        if (m_hasStopped.load() || !current->IsEnabled)
         {
             throw ExecutionCanceledException();
         }
     }
 }
 
+long TestingServices::BugFindingScheduler::ScheduleNextHandler()
+{
+    if (m_actorMap.empty())
+    {
+        // The test created no actor.
+        HasFullyExploredSchedule = true;
+        Stop();
+    }
+
+    return ScheduleNext()->Id;
+}
+
 bool TestingServices::BugFindingScheduler::GetNextNondeterministicBooleanChoice(int maxValue)
 {
+    CancelIfStopped();
+    m_progress.fetch_add(1, std::memory_order_release);
+    NotifyEndOfPrefix();
+
     bool choice = false;
     if (!m_strategy->GetNextBooleanChoice(maxValue, choice))
     {
-        std::cout << "<ScheduleDebug> Schedule explored." << std::endl;
+        if (m_config->Verbosity)
+        {
+            std::cout << "<ScheduleLog> Schedule explored." << std::endl;
+        }
+
+        HasFullyExploredSchedule = true;
+        Stop();
+    }
+
+    m_trace.AddBooleanChoice(choice);
+    return choice;
+}
+
+int TestingServices::BugFindingScheduler::GetNextNondeterministicIntegerChoice(int maxValue)
+{
+    CancelIfStopped();
+    m_progress.fetch_add(1, std::memory_order_release);
+    if (maxValue > 1)
+    {
+        NotifyEndOfPrefix();
+    }
+
+    int choice = 0;
+    if (!m_strategy->GetNextIntegerChoice(maxValue, choice))
+    {
+        if (m_config->Verbosity)
+        {
+            std::cout << "<ScheduleLog> Schedule explored." << std::endl;
+        }
+
         HasFullyExploredSchedule = true;
         Stop();
     }
 
+    m_trace.AddIntegerChoice(choice);
     return choice;
 }
 
@@ -116,29 +264,53 @@ void TestingServices::BugFindingScheduler::NotifyAssertionFailure(std::string te
     if (!BugFound)
     {
         BugFound = true;
+        BugReport = text;
     }
     
     Stop();
 }
 
+void TestingServices::BugFindingScheduler::NotifyDeadlock(const std::string& report)
+{
+    if (m_config->Verbosity)
+    {
+        std::cout << "<ErrorLog> " << report << std::endl;
+    }
+
+    IsDeadlocked = true;
+    StuckReport = report;
+}
+
 void TestingServices::BugFindingScheduler::NotifyProcessCreated(long id)
 {
     // Check if process has already been created.
     if (m_actorMap.find(id) != m_actorMap.end())
     {
-        auto process = m_actorMap[id].get();
+        auto process = m_actorMap[id];
 
         // std::cout << "=======================" << std::endl;
         // std::cout << "process found: " << id  << " :: " << std::this_thread::get_id() << std::endl;
         // std::cout << "=======================" << std::endl;
         
-        process->IsEnabled = true;
+        SetEnabled(*process, true);
         process->IsHalted = false;
+        process->HasStarted.store(false, std::memory_order_relaxed);
     }
     else
     {
-        // Create a new process and insert it in the map.
-        auto info = std::make_unique<ActorInfo>(id);
+        // Create a new process and insert it in the map and the enabled set,
+        // reusing the info of a process from a previous iteration if possible.
+        size_t index = m_enabledSet.Size();
+        if (index == m_actorInfos.size())
+        {
+            m_actorInfos.push_back(std::make_unique<ActorInfo>(id, index));
+        }
+        else
+        {
+            m_actorInfos[index]->Reset(id);
+        }
+
+        auto info = m_actorInfos[index].get();
 
         // std::cout << "=======================" << std::endl;
         // std::cout << "process created: " << id  << " :: " << std::this_thread::get_id() << std::endl;
@@ -147,41 +319,24 @@ void TestingServices::BugFindingScheduler::NotifyProcessCreated(long id)
         if (m_actorMap.empty())
         {
             // If this is the first process, then schedule it.
-            m_scheduledProcessInfo = info.get();
+            m_scheduledProcessInfo = info;
         }
 
-        m_actorMap.insert(std::make_pair(id, move(info)));
+        m_actorMap.insert(std::make_pair(id, info));
+        m_enabledSet.Add(info);
     }
 }
 
 void TestingServices::BugFindingScheduler::NotifyProcessStarted(long id)
 {
-    auto process = m_actorMap[id].get();
-
-    {
-        // Wakes up the creator process (which is the currently scheduled process).
-        std::lock_guard<std::mutex> lock(process->m_lock);
-
-        // std::cout << "====================" << std::endl;
-        // std::cout << "process started: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
-        // std::cout << "====================" << std::endl;
+    auto process = m_actorMap[id];
 
-        // std::cout << "NotifyProcessStarted: unlocking: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
-        process->HasStarted = true;
-        process->m_cv.notify_all();
-        // std::cout << "NotifyProcessStarted: unlocked: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
-    }
+    // Wakes up the creator process (which is the currently scheduled process),
+    // and waits to be scheduled again.
+    process->NotifyStarted();
+    process->WaitUntilActive();
 
-    {
-        // Waits to be scheduled again.
-        std::unique_lock<std::mutex> lock(process->m_lock);
-
-        // std::cout << "NotifyProcessStarted: wait: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
-        process->m_cv.wait(lock, [process] { return process->IsActive; });
-        // std::cout << "NotifyProcessStarted: done: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
-    }
-
-    if (!process->IsEnabled)
+    if (m_hasStopped.load() || !process->IsEnabled)
     {
         throw ExecutionCanceledException();
     }
@@ -194,73 +349,304 @@ void TestingServices::BugFindingScheduler::NotifyProcessPaused(long id)
 
 void TestingServices::BugFindingScheduler::NotifyProcessHalted(long id)
 {
+    // The processes of a stopped scheduler, including a hung process that
+    // returned, have already been disabled.
+    CancelIfStopped();
     auto process = m_scheduledProcessInfo;
 
     // std::cout << "=================================" << std::endl;
     // std::cout << "process halted: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
     // std::cout << "=================================" << std::endl;
 
-    process->IsEnabled = false;
+    SetEnabled(*process, false);
     process->IsHalted = true;
-    Schedule();
+
+    // In single-thread mode, the caller schedules the next handler itself.
+    if (m_config->EnableSingleThreadMode)
+    {
+        return;
+    }
+
+    // The thread of the halted process ends, so it hands off without waiting
+    // to be scheduled again. A timer that fires at this scheduling point can
+    // start a new handler of the same actor, which must wait until the next
+    // process is chosen.
+    process->IsActive.store(false, std::memory_order_relaxed);
+    auto next = ScheduleNext();
+    if (next != nullptr)
+    {
+        next->Activate();
+    }
+}
+
+void TestingServices::BugFindingScheduler::NotifyProcessCrashed(long id)
+{
+    auto it = m_actorMap.find(id);
+    if (it != m_actorMap.end())
+    {
+        SetEnabled(*(it->second), false);
+        it->second->IsHalted = true;
+        m_actorMap.erase(it);
+    }
+}
+
+void TestingServices::BugFindingScheduler::NotifyOperation(EventTraceRecorder::RecordType type, long process,
+    long target, uint64_t value)
+{
+    CancelIfStopped();
+    m_strategy->NotifyOperation(type, process, target, value);
+}
+
+long TestingServices::BugFindingScheduler::GetScheduledProcessId() const
+{
+    return m_scheduledProcessInfo != nullptr ? m_scheduledProcessInfo->Id : -1;
 }
 
 void TestingServices::BugFindingScheduler::WaitForProcessToStart(long id)
 {
-    auto process = m_actorMap[id].get();
+    auto process = m_actorMap[id];
     if (m_actorMap.size() == 1)
     {
         // Wakes up the recently created process.
-        std::lock_guard<std::mutex> lock(process->m_lock);
-
-        // std::cout << "=================================" << std::endl;
-        // std::cout << "waiting for process to start: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
-        // std::cout << "=================================" << std::endl;
-
-        // std::cout << "WaitForProcessToStart: unlocking: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
-        process->IsActive = true;
-        process->m_cv.notify_all();
-        // std::cout << "WaitForProcessToStart: unlocked: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
+        process->Activate();
     }
     else
     {
         // Waits until the recently created process has started.
-        std::unique_lock<std::mutex> lock(process->m_lock);
-
-        // std::cout << "=================================" << std::endl;
-        // std::cout << "waiting for process to start: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
-        // std::cout << "=================================" << std::endl;
-
-        // std::cout << "WaitForProcessToStart: wait: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
-        process->m_cv.wait(lock, [process] { return process->HasStarted; });
-        // std::cout << "WaitForProcessToStart: done: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
+        process->WaitUntilStarted();
     }
 }
 
 void TestingServices::BugFindingScheduler::Wait()
 {
-    m_completionSource.get_future().wait();
-    // std::cout << "DONE WAITING"  << " :: " << std::this_thread::get_id() << std::endl;
+    auto future = m_completionSource.get_future();
+    if (m_watchdogTimeout.count() == 0)
+    {
+        future.wait();
+        return;
+    }
+
+    // The iteration is hung if it makes no progress during a whole timeout.
+    size_t progress = m_progress.load(std::memory_order_acquire);
+    while (future.wait_for(m_watchdogTimeout) != std::future_status::ready)
+    {
+        size_t current = m_progress.load(std::memory_order_acquire);
+        if (current == progress)
+        {
+            // Unless a process stopped the scheduler meanwhile.
+            if (m_hasStopped.exchange(true))
+            {
+                future.wait();
+            }
+            else
+            {
+                NotifyHang();
+            }
+
+            return;
+        }
+
+        progress = current;
+    }
 }
 
 void TestingServices::BugFindingScheduler::Stop()
 {
-    IsSchedulerRunning = false;
-    KillRemainingProcesses();
-    m_completionSource.set_value();
+    // Every process that observes the stopped scheduler ends up here, but
+    // only the first one cancels the remaining processes.
+    if (!m_hasStopped.exchange(true))
+    {
+        IsSchedulerRunning = false;
+        KillRemainingProcesses();
+        m_completionSource.set_value();
+    }
+
     throw ExecutionCanceledException();
 }
 
-std::vector<ActorInfo*> TestingServices::BugFindingScheduler::GetProcessInfos()
+void TestingServices::BugFindingScheduler::CancelIfStopped() const
+{
+    if (m_hasStopped.load())
+    {
+        throw ExecutionCanceledException();
+    }
+}
+
+bool TestingServices::BugFindingScheduler::CanFireTimer() const
+{
+    return m_clock->HasPendingTimers() &&
+        (m_maxTimerFirings == 0 || m_numOfFiredTimers < m_maxTimerFirings);
+}
+
+void TestingServices::BugFindingScheduler::FireNextTimer()
+{
+    m_numOfFiredTimers++;
+    m_clock->FireNextTimer();
+}
+
+void TestingServices::BugFindingScheduler::Reset()
+{
+    IsSchedulerRunning = true;
+    HasFullyExploredSchedule = false;
+    BugFound = false;
+    BugReport.clear();
+    IsCutOff = false;
+    IsDeadlocked = false;
+    IsHung = false;
+    StuckReport.clear();
+    m_actorMap.clear();
+    m_enabledSet.Clear();
+    m_scheduledProcessInfo = nullptr;
+    m_schedulingSteps = 0;
+    m_numOfFiredTimers = 0;
+    m_progress = 0;
+    m_hasStopped = false;
+    m_hasDeadline = false;
+    m_prefixHandler = nullptr;
+    m_trace.Clear();
+    m_stateVisits.clear();
+    m_livenessChecker.Clear();
+    m_completionSource = std::promise<void>();
+}
+
+LivenessChecker& TestingServices::BugFindingScheduler::GetLivenessChecker()
+{
+    return m_livenessChecker;
+}
+
+void TestingServices::BugFindingScheduler::CheckLivenessAtEndOfExecution()
+{
+    std::string report;
+    if (m_livenessChecker.HasHotMonitors() && !m_livenessChecker.CheckAtEndOfExecution(report))
+    {
+        NotifyLivenessFailure(report);
+    }
+}
+
+void TestingServices::BugFindingScheduler::CheckVisitedState(uint64_t fingerprint)
+{
+    StateVisit visit = { m_trace.Count(), m_livenessChecker.GetNumOfEnteredStates() };
+    auto entry = m_stateVisits.emplace(fingerprint, visit);
+    if (!entry.second && m_livenessChecker.HasHotMonitors() && IsFairCycle(entry.first->second.TracePosition))
+    {
+        std::string report;
+        if (!m_livenessChecker.CheckCycle(entry.first->second.NumOfEnteredStates, report))
+        {
+            NotifyLivenessFailure(report);
+        }
+    }
+
+    if (!m_strategy->NotifyVisitedState(fingerprint))
+    {
+        if (m_config->Verbosity)
+        {
+            std::cout << "<ScheduleLog> Reached an explored state." << std::endl;
+        }
+
+        Stop();
+    }
+}
+
+bool TestingServices::BugFindingScheduler::IsFairCycle(size_t position)
+{
+    if (position == m_trace.Count())
+    {
+        return false;
+    }
+
+    m_cycleProcesses.assign(m_enabledSet.Size(), false);
+    for (size_t i = position; i < m_trace.Count(); i++)
+    {
+        auto& step = m_trace.Get(i);
+        if (step.Type == ScheduleTrace::StepType::SchedulingChoice && step.Value < m_cycleProcesses.size())
+        {
+            m_cycleProcesses[step.Value] = true;
+        }
+    }
+
+    for (size_t index = 0; index < m_enabledSet.Size(); index++)
+    {
+        if (m_enabledSet.IsEnabled(index) && !m_cycleProcesses[index])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void TestingServices::BugFindingScheduler::NotifyLivenessFailure(const std::string& report)
+{
+    if (m_config->Verbosity)
+    {
+        std::cout << "<ErrorLog> " << report << std::endl;
+    }
+
+    NotifyAssertionFailure(report);
+}
+
+void TestingServices::BugFindingScheduler::NotifyHang()
+{
+    IsHung = true;
+    StuckReport = "No scheduling point was reached for " + std::to_string(m_watchdogTimeout.count()) +
+        " ms, so the scheduled process is blocked outside of the scheduler.";
+    if (m_config->Verbosity)
+    {
+        std::cout << "<ErrorLog> " << StuckReport << std::endl;
+    }
+
+    // The blocked process cannot be canceled, but the processes that wait to
+    // be scheduled are woken up, so that they observe the stopped scheduler
+    // and terminate. Their state is left as is, as the blocked process may
+    // still read it.
+    IsSchedulerRunning = false;
+    for (size_t index = 0; index < m_enabledSet.Size(); index++)
+    {
+        m_actorInfos[index]->Activate();
+    }
+}
+
+size_t TestingServices::BugFindingScheduler::GetNumOfSchedulingSteps() const
+{
+    return m_schedulingSteps.load(std::memory_order_relaxed);
+}
+
+ScheduleTrace& TestingServices::BugFindingScheduler::GetTrace()
 {
-    // TODO: Make this ordered.
-    std::vector<ActorInfo*> processInfos;
-    for (auto& p : m_actorMap)
+    return m_trace;
+}
+
+void TestingServices::BugFindingScheduler::SetDeadline(std::chrono::steady_clock::time_point deadline)
+{
+    m_deadline = deadline;
+    m_hasDeadline = true;
+}
+
+void TestingServices::BugFindingScheduler::SetStrategy(IExplorationStrategy* strategy)
+{
+    m_strategy = strategy;
+}
+
+void TestingServices::BugFindingScheduler::SetPrefixHandler(std::function<void()> handler)
+{
+    m_prefixHandler = move(handler);
+}
+
+void TestingServices::BugFindingScheduler::NotifyEndOfPrefix()
+{
+    if (m_prefixHandler)
     {
-        processInfos.push_back(p.second.get());
+        // The handler is cleared first, as it may stop the iteration.
+        auto handler = move(m_prefixHandler);
+        m_prefixHandler = nullptr;
+        handler();
     }
+}
 
-    return processInfos;
+void TestingServices::BugFindingScheduler::SetEnabled(ActorInfo& process, bool isEnabled)
+{
+    process.IsEnabled = isEnabled;
+    m_enabledSet.SetEnabled(process.Index, isEnabled);
 }
 
 /// <summary>
@@ -268,20 +654,16 @@ std::vector<ActorInfo*> TestingServices::BugFindingScheduler::GetProcessInfos()
 /// </summary>
 void TestingServices::BugFindingScheduler::KillRemainingProcesses()
 {
-    for (auto& kvp : m_actorMap)
+    for (size_t index = 0; index < m_enabledSet.Size(); index++)
     {
-        auto process = kvp.second.get();
+        auto process = m_actorInfos[index].get();
         // std::cout << "checking: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
 
-        process->IsActive = true;
-        process->IsEnabled = false;
+        SetEnabled(*process, false);
         process->IsHalted = true;
         
         // Wakes up the process.
-        std::lock_guard<std::mutex> lock(process->m_lock);
-        // std::cout << "unlocking: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
-        process->m_cv.notify_all();
-        // std::cout << "unlocked: " << process->Id  << " :: " << std::this_thread::get_id() << std::endl;
+        process->Activate();
     }
 }
 
@@ -16,8 +16,16 @@
 #define MICROSOFT_P3_TESTINGSERVICES_SCHEDULING_BUGFINDINGSCHEDULER_H
 
 #include "ActorInfo.h"
+#include "EnabledSet.h"
+#include "VirtualClock.h"
 #include "../IExplorationStrategy.h"
+#include "../Liveness/LivenessChecker.h"
+#include "../Tracing/ScheduleTrace.h"
 #include "P3/Configuration.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <future>
 #include <memory>
 #include <string>
@@ -30,8 +38,9 @@ namespace Microsoft { namespace P3 { namespace TestingServices
     class BugFindingScheduler
     {
     public:
-        // Checks if the scheduler is running.
-        bool IsSchedulerRunning;
+        // Checks if the scheduler is running. The watchdog clears it while
+        // a hung process may still read it.
+        std::atomic<bool> IsSchedulerRunning;
 
         // Checks if the schedule has been fully explored.
         bool HasFullyExploredSchedule;
@@ -39,18 +48,50 @@ namespace Microsoft { namespace P3 { namespace TestingServices
         // True if a bug was found.
         bool BugFound;
 
-        BugFindingScheduler(Configuration* config, IExplorationStrategy* strategy);
+        // True if the iteration was cut off before it completed.
+        bool IsCutOff;
+
+        // Report of the first bug that was found.
+        std::string BugReport;
+
+        // True if the schedule completed while actors still had pending
+        // events that they defer.
+        bool IsDeadlocked;
+
+        // True if no scheduling point was reached within the watchdog timeout.
+        bool IsHung;
+
+        // Report of the deadlock or hang, if any.
+        std::string StuckReport;
+
+        // Type of the function that returns the fingerprint of the program state.
+        typedef std::function<uint64_t()> StateHasher;
+
+        // Creates a scheduler, which fingerprints the program state at every
+        // scheduling step with the specified hasher, if not empty.
+        BugFindingScheduler(Configuration* config, IExplorationStrategy* strategy, VirtualClock* clock,
+            StateHasher hasher);
         ~BugFindingScheduler();
 
         // Schedules the next machine to execute.
         void Schedule();
+
+        // Schedules the process whose handler runs next, on the thread of the
+        // caller, in single-thread mode, and returns its id.
+        long ScheduleNextHandler();
         
         // Returns the next nondeterministic boolean choice.
         bool GetNextNondeterministicBooleanChoice(int maxValue);
+
+        // Returns the next nondeterministic integer choice, in [0, maxValue).
+        int GetNextNondeterministicIntegerChoice(int maxValue);
         
         // Notify that an assertion has failed.
         void NotifyAssertionFailure(std::string text);
 
+        // Notify that the completed schedule left actors with pending events.
+        void NotifyDeadlock(const std::string& report);
+
         // Notify that a process has been created.
         void NotifyProcessCreated(long id);
         
@@ -63,15 +104,53 @@ namespace Microsoft { namespace P3 { namespace TestingServices
         // Notify that the process has halted.
         void NotifyProcessHalted(long id);
 
+        // Notify that the process has crashed with its node. It stays blocked
+        // until the iteration ends, and a process that is created later with
+        // the same id, when the node restarts, is a new process.
+        void NotifyProcessCrashed(long id);
+
+        // Notifies the strategy of an operation that the process with the
+        // specified index, or the program or a timer if negative, performed.
+        void NotifyOperation(EventTraceRecorder::RecordType type, long process, long target, uint64_t value);
+
+        // Returns the id of the scheduled process, or -1 if there is none.
+        long GetScheduledProcessId() const;
+
         // Wait for the task to start.
         void WaitForProcessToStart(long id);
 
-        // Blocks until the scheduler terminates.
+        // Blocks until the scheduler terminates, or until the watchdog
+        // detects that the iteration is hung.
         void Wait();
 
         // Stops the scheduler and terminates execution.
         void Stop();
 
+        // Resets the scheduler for a new iteration, keeping its storage.
+        void Reset();
+
+        // Returns the checker of the liveness monitors.
+        LivenessChecker& GetLivenessChecker();
+
+        // Returns the number of scheduling steps taken during this iteration.
+        size_t GetNumOfSchedulingSteps() const;
+
+        // Returns the trace of the choices taken by the scheduler.
+        ScheduleTrace& GetTrace();
+
+        // Cuts off the iteration at the first scheduling point after the
+        // specified time.
+        void SetDeadline(std::chrono::steady_clock::time_point deadline);
+
+        // Sets the strategy that takes the next choices, of this iteration
+        // and of the next ones.
+        void SetStrategy(IExplorationStrategy* strategy);
+
+        // Sets the handler that is called once, at the first choice of the
+        // iteration that has more than one option, or at its end if it has
+        // none. The steps before it are the same for every strategy.
+        void SetPrefixHandler(std::function<void()> handler);
+
     private:
         // The installed configuration.
         Configuration* m_config;
@@ -79,18 +158,119 @@ namespace Microsoft { namespace P3 { namespace TestingServices
         // The exploration strategy to be used for bug-finding.
         IExplorationStrategy* m_strategy;
 
+        // Clock whose timers fire at scheduling points.
+        VirtualClock* m_clock;
+
+        // Actor infos in creation order. Infos are kept across iterations,
+        // and the first m_enabledSet.Size() of them are in use.
+        std::vector<std::unique_ptr<ActorInfo>> m_actorInfos;
+
         // Map from unique ids to actor infos.
-        std::unordered_map<long, std::unique_ptr<ActorInfo>> m_actorMap;
+        std::unordered_map<long, ActorInfo*> m_actorMap;
+
+        // Ordered set of the actors that can be scheduled, maintained
+        // incrementally as actors are enabled and disabled.
+        EnabledSet m_enabledSet;
 
         // The info of the currently scheduled process.
         ActorInfo* m_scheduledProcessInfo;
 
+        // Number of scheduling steps taken during this iteration.
+        std::atomic<size_t> m_schedulingSteps;
+
+        // Number of scheduling points and choices reached during this
+        // iteration, which the watchdog reads from the waiting thread.
+        std::atomic<size_t> m_progress;
+
+        // Time without progress after which the iteration is hung, or zero.
+        std::chrono::milliseconds m_watchdogTimeout;
+
+        // Steps after which the iteration is cut off, or zero if unbounded.
+        size_t m_maxSchedulingSteps;
+
+        // Number of timers fired during this iteration, and the number after
+        // which no more timers fire, or zero if unbounded.
+        size_t m_numOfFiredTimers;
+        size_t m_maxTimerFirings;
+
+        // Checks the liveness monitors, and their temperature threshold.
+        LivenessChecker m_livenessChecker;
+        int m_livenessTemperatureThreshold;
+
+        // Set once the scheduler has stopped, so that it stops only once.
+        std::atomic<bool> m_hasStopped;
+
+        // Trace of the choices taken during this iteration.
+        ScheduleTrace m_trace;
+
+        // Time after which the iteration is cut off, if any.
+        std::chrono::steady_clock::time_point m_deadline;
+        bool m_hasDeadline;
+
+        // Called at the end of the prefix of the iteration, if set.
+        std::function<void()> m_prefixHandler;
+
         // Completes when the scheduler terminates.
         std::promise<void> m_completionSource;
 
-        std::vector<ActorInfo*> GetProcessInfos();
+        // Fingerprints the program state, if not empty.
+        StateHasher m_stateHasher;
+
+        // Position in the trace, and number of states entered by monitors,
+        // when a program state was first visited during this iteration.
+        struct StateVisit
+        {
+            size_t TracePosition;
+            size_t NumOfEnteredStates;
+        };
+
+        // First visit of each program state during this iteration.
+        std::unordered_map<uint64_t, StateVisit> m_stateVisits;
+
+        // Processes that were scheduled during a cycle of the execution.
+        std::vector<bool> m_cycleProcesses;
+
+        // Takes a scheduling step, and returns the info of the process that it
+        // chose, or null if no process exists yet.
+        ActorInfo* ScheduleNext();
+
+        // Calls the prefix handler, if set, at a choice with more than one option.
+        void NotifyEndOfPrefix();
+
+        // Reports a liveness bug if the program state closes a fair cycle that
+        // keeps a monitor hot, and prunes the iteration if the strategy chooses to.
+        void CheckVisitedState(uint64_t fingerprint);
+
+        // Checks if the cycle since the specified position in the trace is fair:
+        // every enabled process was scheduled during it.
+        bool IsFairCycle(size_t position);
+
+        // Reports a liveness bug if a monitor is in a hot state.
+        void CheckLivenessAtEndOfExecution();
+
+        // Reports the specified liveness bug.
+        void NotifyLivenessFailure(const std::string& report);
+
+        // Reports that the iteration is hung, and cancels the processes that
+        // wait to be scheduled. Must be called once the scheduler has stopped.
+        void NotifyHang();
+
+        // Enables or disables the specified process.
+        void SetEnabled(ActorInfo& process, bool isEnabled);
+
         void KillRemainingProcesses();
 
+        // Cancels the calling process if the scheduler has stopped. A process
+        // of a hung iteration can resume after the engine moved on, and must
+        // not touch the strategy that the next iteration uses.
+        void CancelIfStopped() const;
+
+        // Checks if a timer is pending, and the timer bound is not reached.
+        bool CanFireTimer() const;
+
+        // Fires the earliest pending timer, and counts it towards the bound.
+        void FireNextTimer();
+
         // Copy is disabled.
         BugFindingScheduler(const BugFindingScheduler& that) = delete;
         BugFindingScheduler &operator=(BugFindingScheduler const &) = delete;
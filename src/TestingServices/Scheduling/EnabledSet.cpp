@@ -0,0 +1,147 @@
+//-----------------------------------------------------------------------
+// <copyright file="EnabledSet.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "EnabledSet.h"
+#include <bitset>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+// Number of processes tracked by a single word of the bitset.
+static const size_t BitsPerWord = 64;
+
+// Returns the number of set bits in the specified word.
+static inline size_t CountBits(uint64_t word)
+{
+    return std::bitset<BitsPerWord>(word).count();
+}
+
+// Returns the position of the lowest set bit in the specified (non-zero) word.
+static inline size_t LowestBit(uint64_t word)
+{
+    return CountBits((word & (~word + 1)) - 1);
+}
+
+TestingServices::EnabledSet::EnabledSet()
+{
+    m_enabledCount = 0;
+}
+
+size_t TestingServices::EnabledSet::Size() const
+{
+    return m_processes.size();
+}
+
+size_t TestingServices::EnabledSet::EnabledCount() const
+{
+    return m_enabledCount;
+}
+
+ActorInfo* TestingServices::EnabledSet::Get(size_t index) const
+{
+    return m_processes[index];
+}
+
+bool TestingServices::EnabledSet::IsEnabled(size_t index) const
+{
+    return (m_enabledBits[index / BitsPerWord] >> (index % BitsPerWord)) & 1;
+}
+
+ActorInfo* TestingServices::EnabledSet::GetEnabled(size_t n) const
+{
+    for (size_t w = 0; w < m_enabledBits.size(); w++)
+    {
+        uint64_t word = m_enabledBits[w];
+        size_t count = CountBits(word);
+        if (n >= count)
+        {
+            n -= count;
+            continue;
+        }
+
+        // Clear the lower set bits until the n-th one is the lowest.
+        for (; n > 0; n--)
+        {
+            word &= word - 1;
+        }
+
+        return m_processes[w * BitsPerWord + LowestBit(word)];
+    }
+
+    return nullptr;
+}
+
+ActorInfo* TestingServices::EnabledSet::GetNextEnabled(size_t index) const
+{
+    if (m_enabledCount == 0)
+    {
+        return nullptr;
+    }
+
+    // Searches the word of the process for a higher bit first, and then
+    // the following words, wrapping around to the first one.
+    size_t start = (index + 1) % (m_enabledBits.size() * BitsPerWord);
+    size_t w = start / BitsPerWord;
+    uint64_t word = m_enabledBits[w] & (~uint64_t(0) << (start % BitsPerWord));
+    for (size_t i = 0; i <= m_enabledBits.size(); i++)
+    {
+        if (word != 0)
+        {
+            return m_processes[w * BitsPerWord + LowestBit(word)];
+        }
+
+        w = (w + 1) % m_enabledBits.size();
+        word = m_enabledBits[w];
+    }
+
+    return nullptr;
+}
+
+size_t TestingServices::EnabledSet::Add(ActorInfo* process)
+{
+    size_t index = m_processes.size();
+    m_processes.push_back(process);
+    if (index / BitsPerWord >= m_enabledBits.size())
+    {
+        m_enabledBits.push_back(0);
+    }
+
+    SetEnabled(index, true);
+    return index;
+}
+
+void TestingServices::EnabledSet::SetEnabled(size_t index, bool isEnabled)
+{
+    uint64_t mask = uint64_t(1) << (index % BitsPerWord);
+    uint64_t& word = m_enabledBits[index / BitsPerWord];
+    if (isEnabled && !(word & mask))
+    {
+        word |= mask;
+        m_enabledCount++;
+    }
+    else if (!isEnabled && (word & mask))
+    {
+        word &= ~mask;
+        m_enabledCount--;
+    }
+}
+
+void TestingServices::EnabledSet::Clear()
+{
+    m_processes.clear();
+    m_enabledBits.clear();
+    m_enabledCount = 0;
+}
+
+TestingServices::EnabledSet::~EnabledSet() { }
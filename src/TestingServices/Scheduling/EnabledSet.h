@@ -0,0 +1,78 @@
+//-----------------------------------------------------------------------
+// <copyright file="EnabledSet.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_SCHEDULING_ENABLEDSET_H
+#define MICROSOFT_P3_TESTINGSERVICES_SCHEDULING_ENABLEDSET_H
+
+#include "ActorInfo.h"
+#include <cstdint>
+#include <vector>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Ordered set of the processes that can be scheduled. Processes are kept
+    // densely in creation order, and a bitset tracks which of them are enabled.
+    // The set is updated incrementally by the scheduler, so that a strategy can
+    // pick the next process without allocating. Strategies only see it as const.
+    class EnabledSet
+    {
+    public:
+        EnabledSet();
+        ~EnabledSet();
+
+        // Returns the number of processes in the set.
+        size_t Size() const;
+
+        // Returns the number of enabled processes.
+        size_t EnabledCount() const;
+
+        // Returns the process with the specified index.
+        ActorInfo* Get(size_t index) const;
+
+        // Checks if the process with the specified index is enabled.
+        bool IsEnabled(size_t index) const;
+
+        // Returns the n-th enabled process, in creation order.
+        ActorInfo* GetEnabled(size_t n) const;
+
+        // Returns the first enabled process after the one with the specified
+        // index, in creation order and wrapping around, or null if none is enabled.
+        ActorInfo* GetNextEnabled(size_t index) const;
+
+        // Adds an enabled process, and returns its index.
+        size_t Add(ActorInfo* process);
+
+        // Enables or disables the process with the specified index.
+        void SetEnabled(size_t index, bool isEnabled);
+
+        // Removes all processes.
+        void Clear();
+
+    private:
+        // Processes in creation order.
+        std::vector<ActorInfo*> m_processes;
+
+        // One bit per process, set if the process is enabled.
+        std::vector<uint64_t> m_enabledBits;
+
+        // Number of set bits in the bitset.
+        size_t m_enabledCount;
+
+        // Copy is disabled.
+        EnabledSet(const EnabledSet& that) = delete;
+        EnabledSet &operator=(EnabledSet const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_SCHEDULING_ENABLEDSET_H
@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------
+// <copyright file="VirtualClock.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "VirtualClock.h"
+#include <algorithm>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+TestingServices::VirtualClock::VirtualClock(TimerHandler handler)
+{
+    m_handler = handler;
+    m_now = std::chrono::milliseconds(0);
+    m_lastTimerId = 0;
+}
+
+std::chrono::milliseconds TestingServices::VirtualClock::Now() const
+{
+    return m_now;
+}
+
+long TestingServices::VirtualClock::StartTimer(Actor& actor, std::chrono::milliseconds dueTime,
+    std::unique_ptr<Event> event)
+{
+    long id = ++m_lastTimerId;
+    auto due = m_now + std::max(dueTime, std::chrono::milliseconds(0));
+    m_timers.emplace(due, Timer{ id, &actor, std::move(event) });
+    return id;
+}
+
+void TestingServices::VirtualClock::StopTimer(long timer)
+{
+    for (auto it = m_timers.begin(); it != m_timers.end(); ++it)
+    {
+        if (it->second.Id == timer)
+        {
+            m_timers.erase(it);
+            return;
+        }
+    }
+}
+
+bool TestingServices::VirtualClock::HasPendingTimers() const
+{
+    return !m_timers.empty();
+}
+
+void TestingServices::VirtualClock::VisitPendingTimers(const TimerVisitor& visitor) const
+{
+    for (auto& entry : m_timers)
+    {
+        visitor(*(entry.second.Target), *(entry.second.Payload), entry.first - m_now);
+    }
+}
+
+void TestingServices::VirtualClock::FireNextTimer()
+{
+    auto next = m_timers.begin();
+    m_now = std::max(m_now, next->first);
+    auto target = next->second.Target;
+    auto event = std::move(next->second.Payload);
+    m_timers.erase(next);
+    m_handler(*target, std::move(event));
+}
+
+void TestingServices::VirtualClock::Reset()
+{
+    m_timers.clear();
+    m_now = std::chrono::milliseconds(0);
+    m_lastTimerId = 0;
+}
+
+TestingServices::VirtualClock::~VirtualClock() { }
@@ -0,0 +1,97 @@
+//-----------------------------------------------------------------------
+// <copyright file="VirtualClock.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_SCHEDULING_VIRTUALCLOCK_H
+#define MICROSOFT_P3_TESTINGSERVICES_SCHEDULING_VIRTUALCLOCK_H
+
+#include "P3/Event.h"
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+
+namespace Microsoft { namespace P3
+{
+    class Actor;
+} }
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Clock of a testing iteration, which only advances when a timer fires.
+    // The scheduler decides when the earliest pending timer fires, so that
+    // actors never sleep, and timeouts race with the other events.
+    class VirtualClock
+    {
+    public:
+        // Type of the function that delivers the event of a fired timer.
+        typedef std::function<void(Actor&, std::unique_ptr<Event>)> TimerHandler;
+
+        // Type of the function that visits a pending timer, with its target,
+        // its event, and the time left until it is due.
+        typedef std::function<void(Actor&, Event&, std::chrono::milliseconds)> TimerVisitor;
+
+        VirtualClock(TimerHandler handler);
+        ~VirtualClock();
+
+        // Returns the time elapsed since the start of the iteration.
+        std::chrono::milliseconds Now() const;
+
+        // Starts a timer that sends the specified event to the actor once
+        // the due time has elapsed, and returns its id.
+        long StartTimer(Actor& actor, std::chrono::milliseconds dueTime, std::unique_ptr<Event> event);
+
+        // Stops the timer with the specified id, if it has not fired yet.
+        void StopTimer(long timer);
+
+        // Checks if any timer has not fired yet.
+        bool HasPendingTimers() const;
+
+        // Visits the pending timers, in firing order.
+        void VisitPendingTimers(const TimerVisitor& visitor) const;
+
+        // Advances the time to the due time of the earliest pending timer,
+        // and fires it. Timers with the same due time fire in start order.
+        void FireNextTimer();
+
+        // Stops all timers, and resets the time.
+        void Reset();
+
+    private:
+        // A pending timer.
+        struct Timer
+        {
+            long Id;
+            Actor* Target;
+            std::unique_ptr<Event> Payload;
+        };
+
+        // Delivers the event of a fired timer.
+        TimerHandler m_handler;
+
+        // Pending timers, ordered by due time.
+        std::multimap<std::chrono::milliseconds, Timer> m_timers;
+
+        // The current time.
+        std::chrono::milliseconds m_now;
+
+        // Id of the last started timer.
+        long m_lastTimerId;
+
+        // Copy is disabled.
+        VirtualClock(const VirtualClock& that) = delete;
+        VirtualClock &operator=(VirtualClock const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_SCHEDULING_VIRTUALCLOCK_H
@@ -13,19 +13,290 @@
 //-----------------------------------------------------------------------
 
 #include "P3/TestingServices/Statistics/TestReport.h"
+#include <algorithm>
+#include <sstream>
 
 using namespace Microsoft::P3;
 using namespace TestingServices;
 
+// Magic bytes and version at the start of a serialized report.
+static const char ReportMagic[4] = { 'P', '3', 'T', 'R' };
+static const char ReportVersion = 2;
+
+// Writes a value in its native representation.
+template<typename T>
+static void WriteValue(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Reads a value written in its native representation.
+template<typename T>
+static bool ReadValue(std::istream& stream, T& value)
+{
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Returns the histogram bucket of the specified number of steps.
+static int GetHistogramBucket(int steps)
+{
+    int bucket = 0;
+    for (; steps > 0 && bucket < TestReport::NumOfHistogramBuckets - 1; steps >>= 1)
+    {
+        bucket++;
+    }
+
+    return bucket;
+}
+
+// Returns the name of the specified termination reason.
+static const char* GetTerminationName(TestReport::TerminationReason reason)
+{
+    switch (reason)
+    {
+    case TestReport::TerminationReason::Timeout:
+        return "Timeout";
+    case TestReport::TerminationReason::BugFound:
+        return "BugFound";
+    case TestReport::TerminationReason::StrategyExhausted:
+        return "StrategyExhausted";
+    case TestReport::TerminationReason::HangLimit:
+        return "HangLimit";
+    default:
+        return "IterationLimit";
+    }
+}
+
 TestingServices::TestReport::TestReport()
 {
     NumOfFoundBugs = 0;
+    NumOfDeadlocks = 0;
+    NumOfHangs = 0;
+    NumOfExploredSchedules = 0;
+    NumOfCutOffSchedules = 0;
+    TotalExploredSteps = 0;
+    MinExploredSteps = 0;
+    MaxExploredSteps = 0;
+    std::fill(ExploredStepsHistogram, ExploredStepsHistogram + NumOfHistogramBuckets, 0);
+    TestingTime = 0;
+    MinIterationTime = 0;
+    MaxIterationTime = 0;
+    TotalIterationTime = 0;
+    NumOfCreatedActors = 0;
+    NumOfSentEvents = 0;
+    NumOfProgramStates = 0;
+    Termination = TerminationReason::IterationLimit;
+}
+
+void TestingServices::TestReport::RecordIteration(int steps, double time, long long createdActors,
+    long long sentEvents)
+{
+    if (NumOfExploredSchedules == 0)
+    {
+        MinExploredSteps = steps;
+        MinIterationTime = time;
+    }
+    else
+    {
+        MinExploredSteps = std::min(MinExploredSteps, steps);
+        MinIterationTime = std::min(MinIterationTime, time);
+    }
+
+    NumOfExploredSchedules++;
+    TotalExploredSteps += steps;
+    MaxExploredSteps = std::max(MaxExploredSteps, steps);
+    ExploredStepsHistogram[GetHistogramBucket(steps)]++;
+    TotalIterationTime += time;
+    MaxIterationTime = std::max(MaxIterationTime, time);
+    NumOfCreatedActors += createdActors;
+    NumOfSentEvents += sentEvents;
+}
+
+double TestingServices::TestReport::GetSchedulesPerSecond() const
+{
+    return TestingTime > 0 ? NumOfExploredSchedules / TestingTime : 0;
+}
+
+double TestingServices::TestReport::GetAverageExploredSteps() const
+{
+    return NumOfExploredSchedules > 0 ? static_cast<double>(TotalExploredSteps) / NumOfExploredSchedules : 0;
+}
+
+double TestingServices::TestReport::GetAverageIterationTime() const
+{
+    return NumOfExploredSchedules > 0 ? TotalIterationTime / NumOfExploredSchedules : 0;
+}
+
+void TestingServices::TestReport::Merge(const TestReport& that)
+{
+    if (that.NumOfExploredSchedules > 0)
+    {
+        if (NumOfExploredSchedules == 0)
+        {
+            MinExploredSteps = that.MinExploredSteps;
+            MinIterationTime = that.MinIterationTime;
+        }
+        else
+        {
+            MinExploredSteps = std::min(MinExploredSteps, that.MinExploredSteps);
+            MinIterationTime = std::min(MinIterationTime, that.MinIterationTime);
+        }
+    }
+
+    NumOfFoundBugs += that.NumOfFoundBugs;
+    NumOfDeadlocks += that.NumOfDeadlocks;
+    NumOfHangs += that.NumOfHangs;
+    NumOfExploredSchedules += that.NumOfExploredSchedules;
+    NumOfCutOffSchedules += that.NumOfCutOffSchedules;
+    TotalExploredSteps += that.TotalExploredSteps;
+    MaxExploredSteps = std::max(MaxExploredSteps, that.MaxExploredSteps);
+    for (int i = 0; i < NumOfHistogramBuckets; i++)
+    {
+        ExploredStepsHistogram[i] += that.ExploredStepsHistogram[i];
+    }
+
+    // The campaigns ran in parallel, so the testing time is the longest of the two.
+    TestingTime = std::max(TestingTime, that.TestingTime);
+    MaxIterationTime = std::max(MaxIterationTime, that.MaxIterationTime);
+    TotalIterationTime += that.TotalIterationTime;
+    NumOfCreatedActors += that.NumOfCreatedActors;
+    NumOfSentEvents += that.NumOfSentEvents;
+
+    // The campaigns can visit the same states, so they are counted once their
+    // coverage is merged, and until then the count is at least the largest.
+    NumOfProgramStates = std::max(NumOfProgramStates, that.NumOfProgramStates);
+    BugIterations.insert(BugIterations.end(), that.BugIterations.begin(), that.BugIterations.end());
+    std::sort(BugIterations.begin(), BugIterations.end());
+
+    if (that.Termination == TerminationReason::BugFound)
+    {
+        Termination = TerminationReason::BugFound;
+    }
+}
+
+std::string TestingServices::TestReport::ToJson() const
+{
+    std::ostringstream json;
+    json << "{";
+    json << "\"numOfFoundBugs\":" << NumOfFoundBugs;
+    json << ",\"numOfDeadlocks\":" << NumOfDeadlocks;
+    json << ",\"numOfHangs\":" << NumOfHangs;
+    json << ",\"numOfExploredSchedules\":" << NumOfExploredSchedules;
+    json << ",\"numOfCutOffSchedules\":" << NumOfCutOffSchedules;
+    json << ",\"totalExploredSteps\":" << TotalExploredSteps;
+    json << ",\"minExploredSteps\":" << MinExploredSteps;
+    json << ",\"maxExploredSteps\":" << MaxExploredSteps;
+    json << ",\"averageExploredSteps\":" << GetAverageExploredSteps();
+
+    // Trailing empty buckets are omitted.
+    int numOfBuckets = NumOfHistogramBuckets;
+    while (numOfBuckets > 0 && ExploredStepsHistogram[numOfBuckets - 1] == 0)
+    {
+        numOfBuckets--;
+    }
+
+    json << ",\"exploredStepsHistogram\":[";
+    for (int i = 0; i < numOfBuckets; i++)
+    {
+        json << (i > 0 ? "," : "") << ExploredStepsHistogram[i];
+    }
+
+    json << "]";
+    json << ",\"testingTime\":" << TestingTime;
+    json << ",\"schedulesPerSecond\":" << GetSchedulesPerSecond();
+    json << ",\"minIterationTime\":" << MinIterationTime;
+    json << ",\"maxIterationTime\":" << MaxIterationTime;
+    json << ",\"averageIterationTime\":" << GetAverageIterationTime();
+    json << ",\"numOfCreatedActors\":" << NumOfCreatedActors;
+    json << ",\"numOfSentEvents\":" << NumOfSentEvents;
+    json << ",\"numOfProgramStates\":" << NumOfProgramStates;
+    json << ",\"bugIterations\":[";
+    for (size_t i = 0; i < BugIterations.size(); i++)
+    {
+        json << (i > 0 ? "," : "") << BugIterations[i];
+    }
+
+    json << "]";
+    json << ",\"termination\":\"" << GetTerminationName(Termination) << "\"";
+    json << "}";
+    return json.str();
+}
+
+void TestingServices::TestReport::Serialize(std::ostream& stream) const
+{
+    stream.write(ReportMagic, sizeof(ReportMagic));
+    stream.put(ReportVersion);
+    WriteValue(stream, NumOfFoundBugs);
+    WriteValue(stream, NumOfDeadlocks);
+    WriteValue(stream, NumOfHangs);
+    WriteValue(stream, NumOfExploredSchedules);
+    WriteValue(stream, NumOfCutOffSchedules);
+    WriteValue(stream, TotalExploredSteps);
+    WriteValue(stream, MinExploredSteps);
+    WriteValue(stream, MaxExploredSteps);
+    WriteValue(stream, ExploredStepsHistogram);
+    WriteValue(stream, TestingTime);
+    WriteValue(stream, MinIterationTime);
+    WriteValue(stream, MaxIterationTime);
+    WriteValue(stream, TotalIterationTime);
+    WriteValue(stream, NumOfCreatedActors);
+    WriteValue(stream, NumOfSentEvents);
+    WriteValue(stream, NumOfProgramStates);
+    WriteValue(stream, static_cast<int>(Termination));
+    WriteValue(stream, static_cast<int>(BugIterations.size()));
+    for (auto iteration : BugIterations)
+    {
+        WriteValue(stream, iteration);
+    }
+}
+
+bool TestingServices::TestReport::Deserialize(std::istream& stream)
+{
+    char magic[sizeof(ReportMagic)];
+    if (!stream.read(magic, sizeof(magic)) ||
+        !std::equal(magic, magic + sizeof(magic), ReportMagic) ||
+        stream.get() != ReportVersion)
+    {
+        return false;
+    }
+
+    int termination, numOfBugIterations;
+    if (!ReadValue(stream, NumOfFoundBugs) || !ReadValue(stream, NumOfDeadlocks) ||
+        !ReadValue(stream, NumOfHangs) || !ReadValue(stream, NumOfExploredSchedules) ||
+        !ReadValue(stream, NumOfCutOffSchedules) || !ReadValue(stream, TotalExploredSteps) ||
+        !ReadValue(stream, MinExploredSteps) || !ReadValue(stream, MaxExploredSteps) ||
+        !ReadValue(stream, ExploredStepsHistogram) || !ReadValue(stream, TestingTime) ||
+        !ReadValue(stream, MinIterationTime) || !ReadValue(stream, MaxIterationTime) ||
+        !ReadValue(stream, TotalIterationTime) || !ReadValue(stream, NumOfCreatedActors) ||
+        !ReadValue(stream, NumOfSentEvents) || !ReadValue(stream, NumOfProgramStates) ||
+        !ReadValue(stream, termination) ||
+        !ReadValue(stream, numOfBugIterations) || numOfBugIterations < 0)
+    {
+        return false;
+    }
+
+    Termination = static_cast<TerminationReason>(termination);
+    BugIterations.clear();
+    for (int i = 0; i < numOfBugIterations; i++)
+    {
+        int iteration;
+        if (!ReadValue(stream, iteration))
+        {
+            return false;
+        }
+
+        BugIterations.push_back(iteration);
+    }
+
+    return true;
 }
 
 TestReport* TestingServices::TestReport::CopyFrom(const TestReport& that)
 {
     auto copy = new TestReport();
-    copy->NumOfFoundBugs = that.NumOfFoundBugs;
+    copy->Merge(that);
+    copy->TestingTime = that.TestingTime;
+    copy->Termination = that.Termination;
     return copy;
 }
 
@@ -0,0 +1,172 @@
+//-----------------------------------------------------------------------
+// <copyright file="ScheduleTrace.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "ScheduleTrace.h"
+#include <algorithm>
+#include <fstream>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+// Magic bytes and version at the start of a serialized trace.
+static const char TraceMagic[4] = { 'P', '3', 'S', 'T' };
+static const uint8_t TraceVersion = 1;
+
+// Number of low bits of an encoded step that hold the step type.
+static const int StepTypeBits = 2;
+
+// Writes an unsigned integer using a variable-length encoding.
+static void WriteVarint(std::ostream& stream, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        stream.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+
+    stream.put(static_cast<char>(value));
+}
+
+// Reads an unsigned integer written with a variable-length encoding.
+static bool ReadVarint(std::istream& stream, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int byte = stream.get();
+        if (byte == std::char_traits<char>::eof())
+        {
+            return false;
+        }
+
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TestingServices::ScheduleTrace::ScheduleTrace()
+{
+    Seed = 0;
+    Iteration = 0;
+}
+
+void TestingServices::ScheduleTrace::AddSchedulingChoice(size_t index)
+{
+    m_steps.push_back({ StepType::SchedulingChoice, static_cast<uint32_t>(index) });
+}
+
+void TestingServices::ScheduleTrace::AddBooleanChoice(bool choice)
+{
+    m_steps.push_back({ StepType::BooleanChoice, choice ? 1u : 0u });
+}
+
+void TestingServices::ScheduleTrace::AddIntegerChoice(int choice)
+{
+    m_steps.push_back({ StepType::IntegerChoice, static_cast<uint32_t>(choice) });
+}
+
+size_t TestingServices::ScheduleTrace::Count() const
+{
+    return m_steps.size();
+}
+
+const ScheduleTrace::Step& TestingServices::ScheduleTrace::Get(size_t position) const
+{
+    return m_steps[position];
+}
+
+void TestingServices::ScheduleTrace::Clear()
+{
+    m_steps.clear();
+}
+
+void TestingServices::ScheduleTrace::Serialize(std::ostream& stream) const
+{
+    stream.write(TraceMagic, sizeof(TraceMagic));
+    stream.put(static_cast<char>(TraceVersion));
+    WriteVarint(stream, Seed);
+    WriteVarint(stream, static_cast<uint64_t>(Iteration));
+    WriteVarint(stream, m_steps.size());
+    for (auto& step : m_steps)
+    {
+        WriteVarint(stream, (static_cast<uint64_t>(step.Value) << StepTypeBits) |
+            static_cast<uint64_t>(step.Type));
+    }
+}
+
+bool TestingServices::ScheduleTrace::Deserialize(std::istream& stream)
+{
+    char magic[sizeof(TraceMagic)];
+    if (!stream.read(magic, sizeof(magic)) ||
+        !std::equal(magic, magic + sizeof(magic), TraceMagic) ||
+        stream.get() != TraceVersion)
+    {
+        return false;
+    }
+
+    uint64_t seed, iteration, count;
+    if (!ReadVarint(stream, seed) || !ReadVarint(stream, iteration) || !ReadVarint(stream, count))
+    {
+        return false;
+    }
+
+    Seed = static_cast<unsigned int>(seed);
+    Iteration = static_cast<int>(iteration);
+    m_steps.clear();
+    // The count is read from the stream, so only a bounded prefix is reserved.
+    m_steps.reserve(static_cast<size_t>(std::min<uint64_t>(count, 1 << 16)));
+    for (uint64_t i = 0; i < count; i++)
+    {
+        uint64_t encoded;
+        if (!ReadVarint(stream, encoded))
+        {
+            return false;
+        }
+
+        auto type = static_cast<StepType>(encoded & ((1 << StepTypeBits) - 1));
+        if (type > StepType::IntegerChoice)
+        {
+            return false;
+        }
+
+        m_steps.push_back({ type, static_cast<uint32_t>(encoded >> StepTypeBits) });
+    }
+
+    return true;
+}
+
+bool TestingServices::ScheduleTrace::SaveToFile(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        return false;
+    }
+
+    Serialize(file);
+    return static_cast<bool>(file);
+}
+
+bool TestingServices::ScheduleTrace::LoadFromFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return file && Deserialize(file);
+}
+
+TestingServices::ScheduleTrace::~ScheduleTrace() { }
@@ -0,0 +1,93 @@
+//-----------------------------------------------------------------------
+// <copyright file="ScheduleTrace.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_TRACING_SCHEDULETRACE_H
+#define MICROSOFT_P3_TESTINGSERVICES_TRACING_SCHEDULETRACE_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Sequence of the nondeterministic choices that were taken during a single
+    // testing iteration. Scheduling choices are recorded as the creation index
+    // of the scheduled process, so that a trace can be replayed exactly.
+    class ScheduleTrace
+    {
+    public:
+        // Type of a recorded choice.
+        enum class StepType : uint8_t
+        {
+            SchedulingChoice = 0,
+            BooleanChoice,
+            IntegerChoice
+        };
+
+        // A recorded choice.
+        struct Step
+        {
+            StepType Type;
+            uint32_t Value;
+        };
+
+        // Seed of the testing campaign that produced this trace.
+        unsigned int Seed;
+
+        // Iteration that produced this trace.
+        int Iteration;
+
+        ScheduleTrace();
+        ~ScheduleTrace();
+
+        // Records a scheduling choice.
+        void AddSchedulingChoice(size_t index);
+
+        // Records a nondeterministic boolean choice.
+        void AddBooleanChoice(bool choice);
+
+        // Records a nondeterministic integer choice.
+        void AddIntegerChoice(int choice);
+
+        // Returns the number of recorded choices.
+        size_t Count() const;
+
+        // Returns the recorded choice at the specified position.
+        const Step& Get(size_t position) const;
+
+        // Removes all recorded choices, keeping the allocated storage.
+        void Clear();
+
+        // Writes the trace in its compact binary format.
+        void Serialize(std::ostream& stream) const;
+
+        // Reads a trace in its compact binary format. Returns false if the
+        // stream does not contain a valid trace.
+        bool Deserialize(std::istream& stream);
+
+        // Writes the trace to the file with the specified path.
+        bool SaveToFile(const std::string& path) const;
+
+        // Reads the trace from the file with the specified path.
+        bool LoadFromFile(const std::string& path);
+
+    private:
+        // The recorded choices.
+        std::vector<Step> m_steps;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_TRACING_SCHEDULETRACE_H
@@ -0,0 +1,199 @@
+//-----------------------------------------------------------------------
+// <copyright file="TraceMinimizer.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "TraceMinimizer.h"
+#include "../ExplorationStrategies/GuidedReplayStrategy.h"
+#include "../../Runtime/BugFindingRuntime.h"
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <thread>
+
+using namespace Microsoft::P3;
+using namespace TestingServices;
+
+TestingServices::TraceMinimizer::TraceMinimizer(const Configuration& configuration, TestAction action)
+    : m_configuration(configuration)
+{
+    m_testAction = action;
+    m_maxChoices = 0;
+    m_numOfTasks = std::max(1u, std::thread::hardware_concurrency());
+    m_numOfRuns = 0;
+}
+
+bool TestingServices::TraceMinimizer::Minimize(const ScheduleTrace& trace, const std::string& bugReport,
+    ScheduleTrace& result)
+{
+    m_bugReport = bugReport;
+    m_maxChoices = 2 * trace.Count() + 16;
+
+    // Scheduling choices that keep running the previously scheduled process
+    // are implied by the guided replay strategy, so they are dropped upfront.
+    std::vector<ScheduleTrace::Step> steps;
+    bool hasPrevious = false;
+    uint32_t previous = 0;
+    for (size_t i = 0; i < trace.Count(); i++)
+    {
+        auto& step = trace.Get(i);
+        if (step.Type == ScheduleTrace::StepType::SchedulingChoice)
+        {
+            if (hasPrevious && step.Value == previous)
+            {
+                continue;
+            }
+
+            hasPrevious = true;
+            previous = step.Value;
+        }
+
+        steps.push_back(step);
+    }
+
+    ScheduleTrace best;
+    if (!RunCandidate(steps, best))
+    {
+        steps.clear();
+        for (size_t i = 0; i < trace.Count(); i++)
+        {
+            steps.push_back(trace.Get(i));
+        }
+
+        if (!RunCandidate(steps, best))
+        {
+            return false;
+        }
+    }
+
+    // Removes chunks of choices, refining the granularity until
+    // no single choice can be removed.
+    size_t granularity = 2;
+    while (steps.size() >= 2)
+    {
+        size_t chunkSize = (steps.size() + granularity - 1) / granularity;
+        std::vector<std::vector<ScheduleTrace::Step>> candidates;
+        for (size_t start = 0; start < steps.size(); start += chunkSize)
+        {
+            std::vector<ScheduleTrace::Step> complement(steps.begin(), steps.begin() + start);
+            complement.insert(complement.end(), steps.begin() + std::min(start + chunkSize, steps.size()), steps.end());
+            candidates.push_back(move(complement));
+        }
+
+        size_t index = RunCandidates(candidates, best);
+        if (index < candidates.size())
+        {
+            steps = move(candidates[index]);
+            granularity = std::max(granularity - 1, size_t(2));
+            continue;
+        }
+
+        if (granularity >= steps.size())
+        {
+            break;
+        }
+
+        granularity = std::min(granularity * 2, steps.size());
+    }
+
+    result = best;
+    result.Seed = trace.Seed;
+    result.Iteration = trace.Iteration;
+    return true;
+}
+
+size_t TestingServices::TraceMinimizer::RunCandidates(const std::vector<std::vector<ScheduleTrace::Step>>& candidates,
+    ScheduleTrace& executed)
+{
+    for (size_t batch = 0; batch < candidates.size(); batch += m_numOfTasks)
+    {
+        // Too many hung candidates are still blocked, so the minimization
+        // keeps the trace found so far.
+        if (m_quarantine.IsFull())
+        {
+            break;
+        }
+
+        size_t end = std::min(batch + m_numOfTasks, candidates.size());
+        std::vector<ScheduleTrace> traces(end - batch);
+        std::vector<std::future<bool>> tasks;
+        for (size_t i = batch; i < end; i++)
+        {
+            tasks.push_back(std::async(std::launch::async, &TraceMinimizer::RunCandidate, this,
+                std::cref(candidates[i]), std::ref(traces[i - batch])));
+        }
+
+        // Picks the first reproducing candidate, so that the result does not
+        // depend on the order in which the parallel executions complete.
+        size_t found = candidates.size();
+        for (size_t i = batch; i < end; i++)
+        {
+            if (tasks[i - batch].get() && found == candidates.size())
+            {
+                found = i;
+            }
+        }
+
+        m_numOfRuns += static_cast<int>(end - batch);
+        if (found < candidates.size())
+        {
+            executed = traces[found - batch];
+            return found;
+        }
+    }
+
+    return candidates.size();
+}
+
+bool TestingServices::TraceMinimizer::RunCandidate(const std::vector<ScheduleTrace::Step>& steps,
+    ScheduleTrace& executed)
+{
+    // Copy the configuration to pass it to the runtime.
+    std::unique_ptr<Configuration> configuration(Configuration::CopyFrom(m_configuration));
+    configuration->Verbosity = false;
+
+    GuidedReplayStrategy strategy(steps, m_maxChoices);
+    strategy.PrepareForNextIteration(0);
+
+    // Creates a new instance of the bug-finding runtime.
+    std::unique_ptr<BugFindingRuntime> runtime(new BugFindingRuntime(move(configuration), &strategy));
+
+    // Run the test.
+    runtime->RunTest(m_testAction);
+
+    // Wait for the runtime to terminate execution.
+    runtime->Wait();
+
+    auto scheduler = runtime->GetScheduler();
+    if (scheduler->IsHung)
+    {
+        // The blocked process still uses the runtime, so it is quarantined,
+        // and the candidate does not reproduce the bug.
+        m_quarantine.Add(move(runtime));
+        return false;
+    }
+
+    if (!scheduler->BugFound || scheduler->BugReport != m_bugReport)
+    {
+        return false;
+    }
+
+    executed = scheduler->GetTrace();
+    return true;
+}
+
+int TestingServices::TraceMinimizer::GetNumOfRuns() const
+{
+    return m_numOfRuns;
+}
+
+TestingServices::TraceMinimizer::~TraceMinimizer() { }
@@ -0,0 +1,80 @@
+//-----------------------------------------------------------------------
+// <copyright file="TraceMinimizer.h">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#ifndef MICROSOFT_P3_TESTINGSERVICES_TRACING_TRACEMINIMIZER_H
+#define MICROSOFT_P3_TESTINGSERVICES_TRACING_TRACEMINIMIZER_H
+
+#include "ScheduleTrace.h"
+#include "../../Runtime/RuntimeQuarantine.h"
+#include "P3/Configuration.h"
+#include "P3/TestingServices/BugFindingEngine.h"
+#include <string>
+#include <vector>
+
+namespace Microsoft { namespace P3 { namespace TestingServices
+{
+    // Shrinks the schedule trace of a buggy iteration using delta debugging.
+    // Candidate schedules drop subsets of the recorded choices, and are executed
+    // with the guided replay strategy (which runs non-preemptively wherever no
+    // recorded choice applies). A candidate is kept if it triggers the same bug.
+    // The candidates of each round are executed in parallel.
+    class TraceMinimizer
+    {
+    public:
+        TraceMinimizer(const Configuration& configuration, TestAction action);
+        ~TraceMinimizer();
+
+        // Minimizes the specified trace, which triggered the bug with the specified
+        // report. Returns false if the bug could not be reproduced.
+        bool Minimize(const ScheduleTrace& trace, const std::string& bugReport, ScheduleTrace& result);
+
+        // Returns the number of executed candidate schedules.
+        int GetNumOfRuns() const;
+
+    private:
+        // The runtime and testing configuration.
+        const Configuration& m_configuration;
+
+        // The entry point to the test.
+        TestAction m_testAction;
+
+        // The report of the bug to reproduce.
+        std::string m_bugReport;
+
+        // Maximum number of choices that a candidate can take.
+        size_t m_maxChoices;
+
+        // Number of candidates that are executed in parallel.
+        size_t m_numOfTasks;
+
+        // Number of executed candidate schedules.
+        int m_numOfRuns;
+
+        // The runtimes of hung candidates, until their processes return.
+        RuntimeQuarantine m_quarantine;
+
+        // Executes the specified candidates, and returns the index of the first one
+        // that reproduces the bug, or the number of candidates if none does.
+        size_t RunCandidates(const std::vector<std::vector<ScheduleTrace::Step>>& candidates, ScheduleTrace& executed);
+
+        // Executes the specified candidate, and returns true if it reproduces the bug.
+        bool RunCandidate(const std::vector<ScheduleTrace::Step>& steps, ScheduleTrace& executed);
+
+        // Copy is disabled.
+        TraceMinimizer(const TraceMinimizer& that) = delete;
+        TraceMinimizer &operator=(TraceMinimizer const &) = delete;
+    };
+} } }
+
+#endif // MICROSOFT_P3_TESTINGSERVICES_TRACING_TRACEMINIMIZER_H
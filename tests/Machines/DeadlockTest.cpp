@@ -0,0 +1,192 @@
+//-----------------------------------------------------------------------
+// <copyright file="DeadlockTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "P3/Machine.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace Microsoft::P3;
+using namespace Microsoft::P3::TestingServices;
+
+class Work : public Event
+{
+public:
+    Work() : Event("Work") { }
+};
+
+class Go : public Event
+{
+public:
+    Go() : Event("Go") { }
+};
+
+class Receiver : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetDeferredEvent("Work");
+        initState->SetOnEventGotoState("Go", "Ready");
+
+        auto readyState = AddState("Ready");
+        readyState->SetOnEventDoAction("Work", std::bind(&Receiver::ReadyOnWork, this));
+    }
+
+private:
+    void ReadyOnWork()
+    {
+        Assert(GetCurrentState() == "Ready", "Deferred event was handled in the wrong state.");
+    }
+};
+
+class Sender : public Machine
+{
+public:
+    static bool SendsGo;
+
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Sender::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        auto receiver = CreateMachine<Receiver>("Receiver");
+        Send(*receiver, std::make_unique<Work>());
+        if (SendsGo)
+        {
+            Send(*receiver, std::make_unique<Go>());
+        }
+    }
+};
+
+bool Sender::SendsGo = false;
+
+class Sleeper : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Sleeper::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        // Blocks outside of the scheduler.
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+};
+
+class Blocker : public Machine
+{
+public:
+    static std::atomic<bool> IsReleased;
+
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Blocker::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        // Blocks outside of the scheduler, until the test releases it.
+        while (!IsReleased.load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+};
+
+std::atomic<bool> Blocker::IsReleased(false);
+
+TEST_CASE("Deferred events are handled once the machine leaves the deferring state.", "[DeadlockTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 10;
+    configuration->RandomSchedulingSeed = 1;
+
+    Sender::SendsGo = true;
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Sender>("Sender");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+    REQUIRE(report->NumOfDeadlocks == 0);
+}
+
+TEST_CASE("Deadlock is reported when only deferred events are pending.", "[DeadlockTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 3;
+
+    Sender::SendsGo = false;
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Sender>("Sender");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+    REQUIRE(report->NumOfDeadlocks == 3);
+    REQUIRE(report->NumOfExploredSchedules == 3);
+}
+
+TEST_CASE("Hang is reported when no scheduling point is reached in time.", "[DeadlockTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 2;
+    configuration->WatchdogTimeout = 20;
+
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Sleeper>("Sleeper");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+    REQUIRE(report->NumOfHangs == 2);
+    REQUIRE(report->NumOfExploredSchedules == 2);
+}
+
+TEST_CASE("Campaign stops when too many hung iterations are still blocked.", "[DeadlockTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 20;
+    configuration->WatchdogTimeout = 20;
+
+    Blocker::IsReleased = false;
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Blocker>("Blocker");
+    });
+
+    // The blocked processes return once released, and are then canceled.
+    Blocker::IsReleased = true;
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+    REQUIRE(report->NumOfHangs == 8);
+    REQUIRE(report->NumOfExploredSchedules == 8);
+    REQUIRE(report->Termination == TestReport::TerminationReason::HangLimit);
+}
@@ -0,0 +1,165 @@
+//-----------------------------------------------------------------------
+// <copyright file="NetworkTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "P3/Machine.h"
+
+using namespace Microsoft::P3;
+
+class Write : public Event
+{
+public:
+    int Value;
+
+    Write(int value) : Event("Write"), Value(value) { }
+
+    std::unique_ptr<Event> Clone() const
+    {
+        return std::make_unique<Write>(Value);
+    }
+};
+
+class Read : public Event
+{
+public:
+    const ActorId* Id;
+
+    Read(const ActorId* id) : Event("Read"), Id(id) { }
+};
+
+class Value : public Event
+{
+public:
+    int Value;
+
+    Value(int value) : Event("Value"), Value(value) { }
+};
+
+class Store : public Machine
+{
+public:
+    static int NumOfStarts;
+    static bool IsChecked;
+
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Store::InitOnEntry, this));
+        initState->SetOnEventDoAction("Write", std::bind(&Store::InitOnWrite, this, std::placeholders::_1));
+        initState->SetOnEventDoAction("Read", std::bind(&Store::InitOnRead, this, std::placeholders::_1));
+    }
+
+private:
+    int m_value;
+
+    void InitOnEntry()
+    {
+        NumOfStarts++;
+        m_value = 0;
+    }
+
+    void InitOnWrite(std::unique_ptr<Event> event)
+    {
+        auto write = static_cast<Write*>(event.get());
+        Assert(!IsChecked || write->Value == m_value + 1, "Writes were applied out of order.");
+        m_value = write->Value;
+    }
+
+    void InitOnRead(std::unique_ptr<Event> event)
+    {
+        auto read = static_cast<Read*>(event.get());
+        Send(*(read->Id), std::make_unique<Value>(m_value));
+    }
+};
+
+int Store::NumOfStarts = 0;
+bool Store::IsChecked = true;
+
+class StoreClient : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&StoreClient::InitOnEntry, this));
+        initState->SetOnEventDoAction("Value", std::bind(&StoreClient::InitOnValue, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        auto store = CreateMachine<Store>(0, "Store");
+        Send(*store, std::make_unique<Write>(1));
+        Send(*store, std::make_unique<Write>(2));
+        Send(*store, std::make_unique<Read>(GetId()));
+    }
+
+    void InitOnValue(std::unique_ptr<Event> event)
+    {
+        auto value = static_cast<Value*>(event.get());
+        Assert(!Store::IsChecked || value->Value == 2, "Read a stale value.");
+    }
+};
+
+TEST_CASE("Events between nodes are delivered in order without network faults.", "[NetworkTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 50;
+    configuration->RandomSchedulingSeed = 1;
+
+    Store::IsChecked = true;
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<StoreClient>(1, "Client");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+    REQUIRE(report->NumOfExploredSchedules == 50);
+}
+
+TEST_CASE("Network faults break the assumptions of machines on other nodes.", "[NetworkTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 100;
+    configuration->RandomSchedulingSeed = 1;
+    configuration->MaxNetworkFaults = 2;
+
+    Store::IsChecked = true;
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<StoreClient>(1, "Client");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 1);
+}
+
+TEST_CASE("Crashed nodes restart their machines in the initial state.", "[NetworkTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 100;
+    configuration->RandomSchedulingSeed = 1;
+    configuration->MaxNetworkFaults = 1;
+
+    Store::IsChecked = false;
+    Store::NumOfStarts = 0;
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<StoreClient>(1, "Client");
+    });
+
+    REQUIRE(report->NumOfExploredSchedules == 100);
+    REQUIRE(Store::NumOfStarts > 100);
+}
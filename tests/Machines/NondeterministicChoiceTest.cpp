@@ -0,0 +1,81 @@
+//-----------------------------------------------------------------------
+// <copyright file="NondeterministicChoiceTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "P3/Machine.h"
+
+using namespace Microsoft::P3;
+
+class Chooser : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Chooser::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        int value = RandomInteger(4);
+        Assert(value >= 0 && value < 4, "Integer choice is out of range.");
+    }
+};
+
+class Failer : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Failer::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        bool fail = RandomBoolean() && RandomInteger(3) == 2;
+        Assert(!fail, "Reached the failing choice.");
+    }
+};
+
+TEST_CASE("Nondeterministic integer choices are within range.", "[NondeterministicChoiceTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 50;
+    configuration->RandomSchedulingSeed = 1;
+
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Chooser>("Chooser");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+}
+
+TEST_CASE("Nondeterministic choices are explored during testing.", "[NondeterministicChoiceTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 100;
+    configuration->RandomSchedulingSeed = 1;
+
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Failer>("Failer");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 1);
+}
@@ -0,0 +1,214 @@
+//-----------------------------------------------------------------------
+// <copyright file="TimerTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "P3/Machine.h"
+#include <chrono>
+
+using namespace Microsoft::P3;
+
+class Timeout : public Event
+{
+public:
+    Timeout() : Event("Timeout") { }
+};
+
+class Query : public Event
+{
+public:
+    const ActorId* Id;
+
+    Query(const ActorId* id) : Event("Query"), Id(id) { }
+};
+
+class Reply : public Event
+{
+public:
+    Reply() : Event("Reply") { }
+};
+
+class Waiter : public Machine
+{
+public:
+    static int NumOfTimeouts;
+
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Waiter::InitOnEntry, this));
+        initState->SetOnEventDoAction("Timeout", std::bind(&Waiter::InitOnTimeout, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        StartTimer(std::chrono::hours(2), std::make_unique<Timeout>());
+        StartTimer(std::chrono::hours(1), std::make_unique<Timeout>());
+    }
+
+    void InitOnTimeout()
+    {
+        NumOfTimeouts++;
+        Assert(Now() == std::chrono::hours(NumOfTimeouts), "Timer fired at the wrong virtual time.");
+    }
+};
+
+int Waiter::NumOfTimeouts = 0;
+
+class Heartbeat : public Machine
+{
+public:
+    static int NumOfBeats;
+
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Heartbeat::InitOnEntry, this));
+        initState->SetOnEventDoAction("Timeout", std::bind(&Heartbeat::InitOnTimeout, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        StartTimer(std::chrono::seconds(1), std::make_unique<Timeout>());
+    }
+
+    void InitOnTimeout()
+    {
+        NumOfBeats++;
+        StartTimer(std::chrono::seconds(1), std::make_unique<Timeout>());
+    }
+};
+
+int Heartbeat::NumOfBeats = 0;
+
+class Replier : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEventDoAction("Query", std::bind(&Replier::InitOnQuery, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnQuery(std::unique_ptr<Event> event)
+    {
+        auto query = static_cast<Query*>(event.get());
+        Send(*(query->Id), std::make_unique<Reply>());
+    }
+};
+
+class Querier : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Querier::InitOnEntry, this));
+        initState->SetOnEventGotoState("Reply", "Done");
+        initState->SetOnEventDoAction("Timeout", std::bind(&Querier::InitOnTimeout, this));
+
+        auto doneState = AddState("Done");
+        doneState->SetOnEntryAction(std::bind(&Querier::DoneOnEntry, this));
+    }
+
+private:
+    long m_timer;
+
+    void InitOnEntry()
+    {
+        m_timer = StartTimer(std::chrono::seconds(30), std::make_unique<Timeout>());
+        auto replier = CreateMachine<Replier>("Replier");
+        Send(*replier, std::make_unique<Query>(GetId()));
+    }
+
+    void InitOnTimeout()
+    {
+        Assert(false, "Query timed out.");
+    }
+
+    void DoneOnEntry()
+    {
+        StopTimer(m_timer);
+    }
+};
+
+TEST_CASE("Timers fire in virtual time without sleeping.", "[TimerTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 5;
+    configuration->RandomSchedulingSeed = 1;
+
+    Waiter::NumOfTimeouts = 0;
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        Waiter::NumOfTimeouts = 0;
+        runtime.CreateMachine<Waiter>("Waiter");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+    REQUIRE(report->NumOfExploredSchedules == 5);
+    REQUIRE(Waiter::NumOfTimeouts == 2);
+}
+
+TEST_CASE("A timer that restarts itself does not keep an iteration alive.", "[TimerTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 5;
+    configuration->MaxTimerFirings = 50;
+    configuration->RandomSchedulingSeed = 1;
+
+    Heartbeat::NumOfBeats = 0;
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        Heartbeat::NumOfBeats = 0;
+        runtime.CreateMachine<Heartbeat>("Heartbeat");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+    REQUIRE(report->NumOfExploredSchedules == 5);
+    REQUIRE(Heartbeat::NumOfBeats == 50);
+}
+
+TEST_CASE("Timeouts race with the other events during testing.", "[TimerTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 100;
+    configuration->RandomSchedulingSeed = 1;
+
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Querier>("Querier");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 1);
+}
+
+TEST_CASE("Stopped timers do not fire.", "[TimerTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->Strategy = TestingServices::ExplorationStrategy::RoundRobin;
+
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Querier>("Querier");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+    REQUIRE(report->NumOfDeadlocks == 0);
+}
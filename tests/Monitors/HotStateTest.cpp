@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------
+// <copyright file="HotStateTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "P3/Machine.h"
+#include "P3/Monitor.h"
+
+using namespace Microsoft::P3;
+
+class Request : public Event
+{
+public:
+    Request() : Event("Request") { }
+};
+
+class Response : public Event
+{
+public:
+    Response() : Event("Response") { }
+};
+
+class Progress : public Monitor
+{
+protected:
+    void Initialize()
+    {
+        auto idleState = AddState("Idle", true);
+        idleState->SetCold();
+        idleState->SetOnEventGotoState("Request", "Waiting");
+
+        auto waitingState = AddState("Waiting");
+        waitingState->SetHot();
+        waitingState->SetOnEventGotoState("Response", "Idle");
+    }
+};
+
+class Retry : public Event
+{
+public:
+    Retry() : Event("Retry") { }
+};
+
+class Retrier : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Retrier::InitOnEntry, this));
+        initState->SetOnEventGotoState("Retry", "Retrying");
+
+        auto retryingState = AddState("Retrying");
+        retryingState->SetOnEntryAction(std::bind(&Retrier::RetryingOnEntry, this));
+        retryingState->SetOnEventGotoState("Retry", "Retrying");
+    }
+
+private:
+    void InitOnEntry()
+    {
+        InvokeMonitor("Progress", std::make_unique<Request>());
+        Send(*GetId(), std::make_unique<Retry>());
+    }
+
+    void RetryingOnEntry()
+    {
+        Send(*GetId(), std::make_unique<Retry>());
+    }
+};
+
+static std::unique_ptr<Microsoft::P3::TestingServices::TestReport> RunRetrier(bool isStateHashingEnabled)
+{
+    // The round-robin strategy is not fair, so the cut-off iteration is not a liveness bug.
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->Strategy = Microsoft::P3::TestingServices::ExplorationStrategy::RoundRobin;
+    configuration->MaxSchedulingSteps = 100;
+    configuration->LivenessTemperatureThreshold = 1000;
+    configuration->EnableStateHashing = isStateHashingEnabled;
+
+    return Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.RegisterMonitor<Progress>("Progress");
+        runtime.CreateMachine<Retrier>("Retrier");
+    });
+}
+
+class Requester : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Requester::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        InvokeMonitor("Progress", std::make_unique<Request>());
+    }
+};
+
+class Responder : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Responder::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        InvokeMonitor("Progress", std::make_unique<Request>());
+        InvokeMonitor("Progress", std::make_unique<Response>());
+    }
+};
+
+TEST_CASE("Monitor in a hot state at the end of execution reports a liveness bug.", "[HotStateTest]")
+{
+    auto report = Test::Run(std::move(Test::GetDefaultConfiguration()), [](Runtime& runtime)
+    {
+        runtime.RegisterMonitor<Progress>("Progress");
+        runtime.CreateMachine<Requester>("Requester");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 1);
+}
+
+TEST_CASE("Monitor that leaves its hot state does not report a liveness bug.", "[HotStateTest]")
+{
+    auto report = Test::Run(std::move(Test::GetDefaultConfiguration()), [](Runtime& runtime)
+    {
+        runtime.RegisterMonitor<Progress>("Progress");
+        runtime.CreateMachine<Responder>("Responder");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+}
+
+TEST_CASE("Monitor that stays hot in a cycle of the execution reports a liveness bug.", "[HotStateTest]")
+{
+    REQUIRE(RunRetrier(false)->NumOfFoundBugs == 0);
+    REQUIRE(RunRetrier(true)->NumOfFoundBugs == 1);
+}
@@ -0,0 +1,175 @@
+//-----------------------------------------------------------------------
+// <copyright file="MonitorInvocationTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "P3/Machine.h"
+#include "P3/Monitor.h"
+
+using namespace Microsoft::P3;
+
+class Alarm : public Event
+{
+public:
+    Alarm() : Event("Alarm") { }
+
+    std::unique_ptr<Event> Clone() const
+    {
+        return std::make_unique<Alarm>();
+    }
+};
+
+class Clear : public Event
+{
+public:
+    Clear() : Event("Clear") { }
+
+    std::unique_ptr<Event> Clone() const
+    {
+        return std::make_unique<Clear>();
+    }
+};
+
+class Fault : public Event
+{
+public:
+    Fault() : Event("Fault") { }
+};
+
+class Siren : public Monitor
+{
+protected:
+    void Initialize()
+    {
+        auto quietState = AddState("Quiet", true);
+        quietState->SetCold();
+        quietState->SetOnEventGotoState("Alarm", "Ringing");
+        quietState->SetOnEventDoAction("Fault", [](std::unique_ptr<Event>) { });
+
+        auto ringingState = AddState("Ringing");
+        ringingState->SetHot();
+        ringingState->SetOnEventGotoState("Clear", "Quiet");
+    }
+};
+
+class Beacon : public Monitor
+{
+protected:
+    void Initialize()
+    {
+        auto darkState = AddState("Dark", true);
+        darkState->SetCold();
+        darkState->SetOnEventGotoState("Alarm", "Flashing");
+        darkState->SetOnEventDoAction("Fault", [](std::unique_ptr<Event>) { });
+
+        auto flashingState = AddState("Flashing");
+        flashingState->SetHot();
+        flashingState->SetOnEventGotoState("Clear", "Dark");
+    }
+};
+
+// Monitor invocations that the alerter performs on start.
+enum class Plan
+{
+    ClearSiren,
+    ClearBeacon,
+    ClearAll,
+    RaiseOnly,
+    Fault,
+    Unregistered
+};
+
+class Drill : public Event
+{
+public:
+    Plan Steps;
+
+    Drill(Plan steps) : Event("Drill"), Steps(steps) { }
+};
+
+class Alerter : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Alerter::InitOnEntry, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry(std::unique_ptr<Event> event)
+    {
+        auto steps = static_cast<Drill*>(event.get())->Steps;
+        switch (steps)
+        {
+        case Plan::ClearSiren:
+            InvokeMonitors(std::make_unique<Alarm>());
+            InvokeMonitor<Siren>(std::make_unique<Clear>());
+            break;
+        case Plan::ClearBeacon:
+            InvokeMonitors(std::make_unique<Alarm>());
+            InvokeMonitor<Beacon>(std::make_unique<Clear>());
+            break;
+        case Plan::ClearAll:
+            InvokeMonitors(std::make_unique<Alarm>());
+            InvokeMonitors(std::make_unique<Clear>());
+            break;
+        case Plan::RaiseOnly:
+            InvokeMonitors(std::make_unique<Alarm>());
+            break;
+        case Plan::Fault:
+            InvokeMonitors(std::make_unique<Fault>());
+            break;
+        case Plan::Unregistered:
+            InvokeMonitor<Siren>(std::make_unique<Alarm>());
+            break;
+        }
+    }
+};
+
+static std::unique_ptr<Microsoft::P3::TestingServices::TestReport> RunAlerter(Plan steps, bool registerSiren = true)
+{
+    return Test::Run(std::move(Test::GetDefaultConfiguration()), [steps, registerSiren](Runtime& runtime)
+    {
+        if (registerSiren)
+        {
+            runtime.RegisterMonitor<Siren>("Siren");
+        }
+
+        runtime.RegisterMonitor<Beacon>("Beacon");
+        runtime.CreateMachine<Alerter>("Alerter", std::make_unique<Drill>(steps));
+    });
+}
+
+TEST_CASE("Monitor invoked by type only receives its own events.", "[MonitorInvocationTest]")
+{
+    REQUIRE(RunAlerter(Plan::ClearSiren)->NumOfFoundBugs == 1);
+    REQUIRE(RunAlerter(Plan::ClearBeacon)->NumOfFoundBugs == 1);
+}
+
+TEST_CASE("Event invoked on all monitors reaches every monitor that handles it.", "[MonitorInvocationTest]")
+{
+    REQUIRE(RunAlerter(Plan::RaiseOnly)->NumOfFoundBugs == 1);
+    REQUIRE(RunAlerter(Plan::ClearAll)->NumOfFoundBugs == 0);
+}
+
+TEST_CASE("Event that cannot be copied is not invoked on several monitors.", "[MonitorInvocationTest]")
+{
+    REQUIRE(RunAlerter(Plan::Fault)->NumOfFoundBugs == 1);
+}
+
+TEST_CASE("Invoking a monitor of an unregistered type reports a bug.", "[MonitorInvocationTest]")
+{
+    REQUIRE(RunAlerter(Plan::Unregistered, false)->NumOfFoundBugs == 1);
+}
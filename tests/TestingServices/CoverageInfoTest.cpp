@@ -0,0 +1,69 @@
+//-----------------------------------------------------------------------
+// <copyright file="CoverageInfoTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../../src/TestingServices/Coverage/CoverageInfo.h"
+#include <sstream>
+
+using namespace Microsoft::P3::TestingServices;
+
+class CoveredMachine { };
+
+TEST_CASE("Coverage info counts each covered activity once.", "[CoverageInfoTest]")
+{
+    CoverageInfo coverage;
+    REQUIRE(!coverage.IsDeclared(typeid(CoveredMachine)));
+
+    coverage.DeclareState(typeid(CoveredMachine), false, "Init");
+    coverage.DeclareState(typeid(CoveredMachine), false, "Active");
+    coverage.DeclareEvent(typeid(CoveredMachine), "Active", "Ping");
+    REQUIRE(coverage.IsDeclared(typeid(CoveredMachine)));
+    REQUIRE(coverage.GetNumOfCoveredItems() == 0);
+
+    coverage.AddState(typeid(CoveredMachine), "Init");
+    coverage.AddState(typeid(CoveredMachine), "Active");
+    coverage.AddTransition(typeid(CoveredMachine), "Init", "Active");
+    coverage.AddEvent(typeid(CoveredMachine), "Active", "Ping");
+    REQUIRE(coverage.GetNumOfCoveredItems() == 4);
+
+    coverage.AddState(typeid(CoveredMachine), "Active");
+    coverage.AddEvent(typeid(CoveredMachine), "Active", "Ping");
+    REQUIRE(coverage.GetNumOfCoveredItems() == 4);
+
+    std::ostringstream report;
+    coverage.WriteReport(report);
+    REQUIRE(report.str().find("Total state coverage: 2/2 (100%)") != std::string::npos);
+    REQUIRE(report.str().find("Init --> Active") != std::string::npos);
+}
+
+TEST_CASE("Coverage info rejects a string longer than the stream.", "[CoverageInfoTest]")
+{
+    CoverageInfo coverage;
+    coverage.DeclareState(typeid(CoveredMachine), false, "Init");
+    coverage.AddState(typeid(CoveredMachine), "Init");
+
+    std::ostringstream stream;
+    coverage.Serialize(stream);
+
+    CoverageInfo copy;
+    std::istringstream valid(stream.str());
+    REQUIRE(copy.Deserialize(valid));
+    REQUIRE(copy.GetNumOfCoveredItems() == 1);
+
+    // One type, whose name claims the largest length, but has no data.
+    uint32_t fields[] = { 1, 0xFFFFFFFF };
+    std::string data(reinterpret_cast<const char*>(fields), sizeof(fields));
+    std::istringstream oversized(data);
+    REQUIRE(!copy.Deserialize(oversized));
+}
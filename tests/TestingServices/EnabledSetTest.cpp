@@ -0,0 +1,107 @@
+//-----------------------------------------------------------------------
+// <copyright file="EnabledSetTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../../src/TestingServices/Scheduling/EnabledSet.h"
+#include <memory>
+#include <vector>
+
+using namespace Microsoft::P3::TestingServices;
+
+// Processes that span three words of the bitset.
+static const size_t NumOfProcesses = 130;
+
+static std::vector<std::unique_ptr<ActorInfo>> CreateProcesses(EnabledSet& set)
+{
+    std::vector<std::unique_ptr<ActorInfo>> processes;
+    for (size_t i = 0; i < NumOfProcesses; i++)
+    {
+        processes.push_back(std::make_unique<ActorInfo>(static_cast<long>(i + 1), i));
+        REQUIRE(set.Add(processes.back().get()) == i);
+    }
+
+    return processes;
+}
+
+TEST_CASE("Enabled set counts the processes that are enabled and disabled.", "[EnabledSetTest]")
+{
+    EnabledSet set;
+    auto processes = CreateProcesses(set);
+    REQUIRE(set.Size() == NumOfProcesses);
+    REQUIRE(set.EnabledCount() == NumOfProcesses);
+
+    set.SetEnabled(63, false);
+    set.SetEnabled(64, false);
+    set.SetEnabled(64, false);
+    REQUIRE(set.EnabledCount() == NumOfProcesses - 2);
+    REQUIRE(!set.IsEnabled(63));
+    REQUIRE(!set.IsEnabled(64));
+    REQUIRE(set.IsEnabled(65));
+
+    set.SetEnabled(63, true);
+    set.SetEnabled(63, true);
+    REQUIRE(set.EnabledCount() == NumOfProcesses - 1);
+    REQUIRE(set.IsEnabled(63));
+
+    set.Clear();
+    REQUIRE(set.Size() == 0);
+    REQUIRE(set.EnabledCount() == 0);
+    REQUIRE(set.GetEnabled(0) == nullptr);
+    REQUIRE(set.GetNextEnabled(0) == nullptr);
+}
+
+TEST_CASE("Enabled set finds the n-th enabled process across words.", "[EnabledSetTest]")
+{
+    EnabledSet set;
+    auto processes = CreateProcesses(set);
+
+    // Only every third process stays enabled.
+    for (size_t i = 0; i < NumOfProcesses; i++)
+    {
+        set.SetEnabled(i, i % 3 == 0);
+    }
+
+    REQUIRE(set.EnabledCount() == (NumOfProcesses + 2) / 3);
+    for (size_t n = 0; n < set.EnabledCount(); n++)
+    {
+        REQUIRE(set.GetEnabled(n) == processes[3 * n].get());
+    }
+
+    REQUIRE(set.GetEnabled(set.EnabledCount()) == nullptr);
+}
+
+TEST_CASE("Enabled set wraps around to find the next enabled process.", "[EnabledSetTest]")
+{
+    EnabledSet set;
+    auto processes = CreateProcesses(set);
+    for (size_t i = 0; i < NumOfProcesses; i++)
+    {
+        set.SetEnabled(i, false);
+    }
+
+    REQUIRE(set.GetNextEnabled(0) == nullptr);
+
+    // The next process is found in the following word, and in the first one
+    // after wrapping around from the last.
+    set.SetEnabled(5, true);
+    set.SetEnabled(64, true);
+    REQUIRE(set.GetNextEnabled(5) == processes[64].get());
+    REQUIRE(set.GetNextEnabled(63) == processes[64].get());
+    REQUIRE(set.GetNextEnabled(64) == processes[5].get());
+    REQUIRE(set.GetNextEnabled(NumOfProcesses - 1) == processes[5].get());
+
+    // A single enabled process is the next one after itself.
+    set.SetEnabled(64, false);
+    REQUIRE(set.GetNextEnabled(5) == processes[5].get());
+}
@@ -0,0 +1,339 @@
+//-----------------------------------------------------------------------
+// <copyright file="ExplorationStrategyTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "P3/Machine.h"
+#include <cstdio>
+#include <string>
+
+using namespace Microsoft::P3;
+using namespace Microsoft::P3::TestingServices;
+
+class Hello : public Event
+{
+public:
+    int From;
+
+    Hello(int from) : Event("Hello"), From(from) { }
+};
+
+class Introduce : public Event
+{
+public:
+    const ActorId* Target;
+    int From;
+
+    Introduce(const ActorId* target, int from) : Event("Introduce"), Target(target), From(from) { }
+};
+
+class Greeted : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEventDoAction("Hello", std::bind(&Greeted::InitOnHello, this, std::placeholders::_1));
+        m_isGreeted = false;
+    }
+
+private:
+    bool m_isGreeted;
+
+    void InitOnHello(std::unique_ptr<Event> event)
+    {
+        auto hello = static_cast<Hello*>(event.get());
+        Assert(m_isGreeted || hello->From == 1, "The second greeter greeted first.");
+        m_isGreeted = true;
+    }
+};
+
+class Greeter : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Greeter::InitOnEntry, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry(std::unique_ptr<Event> event)
+    {
+        auto introduce = static_cast<Introduce*>(event.get());
+        Send(*(introduce->Target), std::make_unique<Hello>(introduce->From));
+    }
+};
+
+class Greetings : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Greetings::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        auto target = CreateMachine<Greeted>("Greeted");
+        CreateMachine<Greeter>("Greeter1", std::make_unique<Introduce>(target, 1));
+        CreateMachine<Greeter>("Greeter2", std::make_unique<Introduce>(target, 2));
+    }
+};
+
+class Add : public Event
+{
+public:
+    int Value;
+
+    Add(int value) : Event("Add"), Value(value) { }
+};
+
+class Counter : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEventDoAction("Add", std::bind(&Counter::InitOnAdd, this, std::placeholders::_1));
+        m_sum = 0;
+    }
+
+    size_t HashState() const
+    {
+        return m_sum;
+    }
+
+private:
+    int m_sum;
+
+    void InitOnAdd(std::unique_ptr<Event> event)
+    {
+        m_sum += static_cast<Add*>(event.get())->Value;
+    }
+};
+
+class Adder : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Adder::InitOnEntry, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry(std::unique_ptr<Event> event)
+    {
+        auto introduce = static_cast<Introduce*>(event.get());
+        Send(*(introduce->Target), std::make_unique<Add>(introduce->From));
+        Send(*(introduce->Target), std::make_unique<Add>(introduce->From));
+    }
+};
+
+class Additions : public Machine
+{
+public:
+    // Number of times that the setup of the test ran in this process.
+    static int NumOfSetups;
+
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Additions::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        NumOfSetups++;
+        auto target = CreateMachine<Counter>("Counter");
+        CreateMachine<Adder>("Adder1", std::make_unique<Introduce>(target, 1));
+        CreateMachine<Adder>("Adder2", std::make_unique<Introduce>(target, 1));
+    }
+};
+
+int Additions::NumOfSetups = 0;
+
+static std::unique_ptr<TestReport> RunAdditions(bool isStateHashingEnabled, int iterations = 100000,
+    const std::string& campaignFile = std::string(), bool scheduleOnlyAtReceives = false,
+    bool isSingleThreaded = false, int forkedProcesses = 0)
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->Strategy = ExplorationStrategy::DFS;
+    configuration->SchedulingIterations = iterations;
+    configuration->EnableStateHashing = isStateHashingEnabled;
+    configuration->CampaignFile = campaignFile;
+    configuration->ScheduleOnlyAtReceives = scheduleOnlyAtReceives;
+    configuration->EnableSingleThreadMode = isSingleThreaded;
+    configuration->ForkedProcesses = forkedProcesses;
+
+    return Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Additions>("Additions");
+    });
+}
+
+static std::unique_ptr<TestReport> RunGreetings(ExplorationStrategy strategy, bool scheduleOnlyAtReceives = false,
+    bool isSingleThreaded = false, int forkedProcesses = 0)
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->Strategy = strategy;
+    configuration->SchedulingIterations = 100;
+    configuration->RandomSchedulingSeed = 1;
+    configuration->ScheduleOnlyAtReceives = scheduleOnlyAtReceives;
+    configuration->EnableSingleThreadMode = isSingleThreaded;
+    configuration->ForkedProcesses = forkedProcesses;
+
+    return Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Greetings>("Greetings");
+    });
+}
+
+TEST_CASE("Round-robin strategy explores a single schedule.", "[ExplorationStrategyTest]")
+{
+    auto report = RunGreetings(ExplorationStrategy::RoundRobin);
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+    REQUIRE(report->NumOfExploredSchedules == 1);
+    REQUIRE(report->Termination == TestReport::TerminationReason::StrategyExhausted);
+}
+
+TEST_CASE("Delay-bounding strategy finds a bug that needs a delay.", "[ExplorationStrategyTest]")
+{
+    auto report = RunGreetings(ExplorationStrategy::DelayBounding);
+
+    REQUIRE(report->NumOfFoundBugs == 1);
+    REQUIRE(report->NumOfExploredSchedules > 1);
+}
+
+TEST_CASE("PCT strategy finds a bug that needs a priority change.", "[ExplorationStrategyTest]")
+{
+    auto report = RunGreetings(ExplorationStrategy::PCT);
+
+    REQUIRE(report->NumOfFoundBugs == 1);
+}
+
+TEST_CASE("DFS strategy finds a bug that needs a different order.", "[ExplorationStrategyTest]")
+{
+    auto report = RunGreetings(ExplorationStrategy::DFS);
+
+    REQUIRE(report->NumOfFoundBugs == 1);
+    REQUIRE(report->NumOfExploredSchedules > 1);
+}
+
+TEST_CASE("Scheduling only at receives explores fewer schedules that find the same bug.", "[ExplorationStrategyTest]")
+{
+    auto report = RunAdditions(false);
+    auto reducedReport = RunAdditions(false, 100000, std::string(), true);
+    auto buggyReport = RunGreetings(ExplorationStrategy::DFS, true);
+
+    REQUIRE(reducedReport->NumOfFoundBugs == 0);
+    REQUIRE(reducedReport->Termination == TestReport::TerminationReason::StrategyExhausted);
+    REQUIRE(reducedReport->NumOfExploredSchedules < report->NumOfExploredSchedules);
+    REQUIRE(reducedReport->TotalExploredSteps < report->TotalExploredSteps);
+    REQUIRE(buggyReport->NumOfFoundBugs == 1);
+}
+
+TEST_CASE("Single-thread mode explores the schedules of handlers that run to completion.", "[ExplorationStrategyTest]")
+{
+    auto report = RunAdditions(false);
+    auto singleThreadedReport = RunAdditions(false, 100000, std::string(), false, true);
+    auto buggyReport = RunGreetings(ExplorationStrategy::DFS, false, true);
+    auto randomReport = RunGreetings(ExplorationStrategy::Random, false, true);
+
+    REQUIRE(singleThreadedReport->NumOfFoundBugs == 0);
+    REQUIRE(singleThreadedReport->Termination == TestReport::TerminationReason::StrategyExhausted);
+    REQUIRE(singleThreadedReport->NumOfExploredSchedules < report->NumOfExploredSchedules);
+    REQUIRE(buggyReport->NumOfFoundBugs == 1);
+    REQUIRE(randomReport->NumOfFoundBugs == 1);
+}
+
+TEST_CASE("DFS strategy prunes the schedules that reach explored states.", "[ExplorationStrategyTest]")
+{
+    auto report = RunAdditions(false);
+    auto prunedReport = RunAdditions(true);
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+    REQUIRE(report->Termination == TestReport::TerminationReason::StrategyExhausted);
+    REQUIRE(prunedReport->NumOfFoundBugs == 0);
+    REQUIRE(prunedReport->Termination == TestReport::TerminationReason::StrategyExhausted);
+    REQUIRE(prunedReport->NumOfExploredSchedules < report->NumOfExploredSchedules);
+}
+
+TEST_CASE("DFS campaign resumes from the schedules that earlier runs explored.", "[ExplorationStrategyTest]")
+{
+    auto report = RunAdditions(false);
+
+    const std::string campaignFile = "ExplorationStrategyTest.campaign";
+    std::remove(campaignFile.c_str());
+    int numOfRuns = 0, numOfExploredSchedules = 0;
+    for (auto termination = TestReport::TerminationReason::IterationLimit;
+        termination == TestReport::TerminationReason::IterationLimit; numOfRuns++)
+    {
+        auto runReport = RunAdditions(false, 100, campaignFile);
+        numOfExploredSchedules += runReport->NumOfExploredSchedules;
+        termination = runReport->Termination;
+    }
+
+    std::remove(campaignFile.c_str());
+    REQUIRE(numOfRuns > 1);
+    REQUIRE(numOfExploredSchedules == report->NumOfExploredSchedules);
+}
+
+#ifdef __linux__
+TEST_CASE("Forked processes explore disjoint slices of the schedules from a shared setup.", "[ExplorationStrategyTest]")
+{
+    auto report = RunAdditions(false, 100000, std::string(), false, true);
+    Additions::NumOfSetups = 0;
+    auto forkedReport = RunAdditions(false, 100000, std::string(), false, true, 3);
+    int numOfSetups = Additions::NumOfSetups;
+    auto roundRobinReport = RunGreetings(ExplorationStrategy::RoundRobin, false, true, 3);
+    auto buggyReport = RunGreetings(ExplorationStrategy::DFS, false, true, 3);
+
+    REQUIRE(forkedReport->NumOfFoundBugs == 0);
+    REQUIRE(forkedReport->Termination == TestReport::TerminationReason::StrategyExhausted);
+    REQUIRE(forkedReport->NumOfExploredSchedules == report->NumOfExploredSchedules);
+    REQUIRE(numOfSetups == 1);
+    REQUIRE(roundRobinReport->NumOfExploredSchedules == 1);
+    REQUIRE(roundRobinReport->Termination == TestReport::TerminationReason::StrategyExhausted);
+    REQUIRE(buggyReport->NumOfFoundBugs >= 1);
+    REQUIRE(buggyReport->NumOfFoundBugs <= 3);
+    REQUIRE(buggyReport->Termination == TestReport::TerminationReason::BugFound);
+}
+
+TEST_CASE("Forked DFS campaign resumes the slices that earlier runs explored.", "[ExplorationStrategyTest]")
+{
+    auto report = RunAdditions(false, 100000, std::string(), false, true);
+
+    const std::string campaignFile = "ExplorationStrategyTest.forked.campaign";
+    std::remove(campaignFile.c_str());
+    int numOfRuns = 0, numOfExploredSchedules = 0;
+    for (auto termination = TestReport::TerminationReason::IterationLimit;
+        termination == TestReport::TerminationReason::IterationLimit; numOfRuns++)
+    {
+        auto runReport = RunAdditions(false, 6, campaignFile, false, true, 3);
+        numOfExploredSchedules += runReport->NumOfExploredSchedules;
+        termination = runReport->Termination;
+    }
+
+    std::remove(campaignFile.c_str());
+    REQUIRE(numOfRuns > 1);
+    REQUIRE(numOfExploredSchedules == report->NumOfExploredSchedules);
+}
+#endif
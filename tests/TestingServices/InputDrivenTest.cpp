@@ -0,0 +1,56 @@
+//-----------------------------------------------------------------------
+// <copyright file="InputDrivenTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "P3/Machine.h"
+
+using namespace Microsoft::P3;
+using namespace Microsoft::P3::TestingServices;
+
+class Picker : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Picker::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        bool fail = RandomBoolean() && RandomInteger(300) == 257;
+        Assert(!fail, "Reached the failing choice.");
+    }
+};
+
+TEST_CASE("Input-driven iterations derive their choices from the input.", "[InputDrivenTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->Strategy = ExplorationStrategy::InputDriven;
+    configuration->MaxSchedulingSteps = 100;
+
+    std::unique_ptr<BugFindingEngine> engine(BugFindingEngine::Create(std::move(configuration),
+        [](Runtime& runtime) { runtime.CreateMachine<Picker>("Picker"); }));
+
+    // The integer choice reads two bytes, in little-endian order.
+    const uint8_t failing[] = { 1, 1, 1 };
+    const uint8_t passing[] = { 1, 2, 1 };
+    REQUIRE(!engine->RunInput(passing, sizeof(passing)));
+    REQUIRE(!engine->RunInput(nullptr, 0));
+    REQUIRE(engine->RunInput(failing, sizeof(failing)));
+    REQUIRE(engine->RunInput(failing, sizeof(failing)));
+    REQUIRE(engine->GetReport()->NumOfExploredSchedules == 4);
+}
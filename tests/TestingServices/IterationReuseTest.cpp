@@ -0,0 +1,130 @@
+//-----------------------------------------------------------------------
+// <copyright file="IterationReuseTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "../../src/Runtime/BugFindingRuntime.h"
+#include "../../src/Runtime/IterationArena.h"
+#include "../../src/TestingServices/ExplorationStrategies/RandomStrategy.h"
+#include "P3/ActorId.h"
+#include "P3/Machine.h"
+#include <string>
+#include <vector>
+
+using namespace Microsoft::P3;
+using namespace Microsoft::P3::TestingServices;
+
+class Baton : public Event
+{
+public:
+    const ActorId* Relay;
+
+    Baton(const ActorId* relay) : Event("Baton"), Relay(relay) { }
+};
+
+class Runner : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Runner::InitOnEntry, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry(std::unique_ptr<Event> event)
+    {
+        Send(*(static_cast<Baton*>(event.get())->Relay), std::make_unique<Baton>(GetId()));
+    }
+};
+
+class Relay : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Relay::InitOnEntry, this));
+        initState->SetOnEventDoAction("Baton", [](std::unique_ptr<Event>) { });
+    }
+
+private:
+    void InitOnEntry()
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            CreateMachine<Runner>("Runner", std::make_unique<Baton>(GetId()));
+        }
+    }
+};
+
+TEST_CASE("Runtime reuses its worker threads across iterations.", "[IterationReuseTest]")
+{
+    RandomStrategy strategy(5);
+    std::unique_ptr<Configuration> configuration(Test::GetDefaultConfiguration());
+    BugFindingRuntime runtime(std::move(configuration), &strategy);
+    for (int iteration = 0; iteration < 500; iteration++)
+    {
+        strategy.PrepareForNextIteration(iteration);
+        if (iteration > 0)
+        {
+            runtime.Reset();
+        }
+
+        std::string name;
+        runtime.RunTest([&name](Runtime& runtime)
+        {
+            name = runtime.CreateMachine<Relay>("Relay")->GetName();
+        });
+
+        runtime.Wait();
+        REQUIRE(!runtime.GetScheduler()->BugFound);
+
+        // Actor ids restart with each iteration.
+        REQUIRE(name == "Relay(0)");
+
+        // An iteration runs four actors. The worker of each one can still be
+        // returning to the pool while the next iteration starts its actors,
+        // so the pool never needs more than twice as many workers.
+        REQUIRE(runtime.GetNumOfWorkers() <= 8);
+    }
+}
+
+TEST_CASE("Iteration arena reuses its chunks after it is released.", "[IterationReuseTest]")
+{
+    IterationArena arena;
+    IterationArena::Scope scope(arena);
+
+    // Enough allocations to span several chunks.
+    std::vector<void*> first;
+    for (int i = 0; i < 10000; i++)
+    {
+        first.push_back(IterationArena::AllocateObject(64));
+    }
+
+    REQUIRE(arena.GetNumOfObjects() == 10000);
+    for (auto ptr : first)
+    {
+        IterationArena::FreeObject(ptr);
+    }
+
+    REQUIRE(arena.GetNumOfObjects() == 0);
+    arena.Release();
+    for (int i = 0; i < 10000; i++)
+    {
+        void* ptr = IterationArena::AllocateObject(64);
+        REQUIRE(ptr == first[i]);
+        IterationArena::FreeObject(ptr);
+    }
+}
@@ -0,0 +1,69 @@
+//-----------------------------------------------------------------------
+// <copyright file="LogBufferTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../../src/Runtime/LogBuffer.h"
+#include <sstream>
+#include <string>
+
+using namespace Microsoft::P3;
+
+TEST_CASE("Log buffer formats its records like the runtime log.", "[LogBufferTest]")
+{
+    LogBuffer log(4);
+    log.Add(LogBuffer::RecordType::Send, "Client", "Ping", "Server");
+    log.Add(LogBuffer::RecordType::RandomBoolean, "Client", std::string(), std::string(), 1);
+    log.Add(LogBuffer::RecordType::StartTimer, "Server", "Tick", std::string(), 3, 50);
+
+    std::ostringstream stream;
+    log.Write(stream);
+    REQUIRE(stream.str() ==
+        "<SendLog> 'Client' sent event 'Ping' to 'Server'.\n"
+        "<RandomLog> 'Client' nondeterministically chose 'true'.\n"
+        "<TimerLog> 'Server' started timer 3 for event 'Tick' due in 50 ms.\n");
+}
+
+TEST_CASE("Log buffer keeps only its latest records.", "[LogBufferTest]")
+{
+    LogBuffer log(2);
+    for (int i = 0; i < 5; i++)
+    {
+        log.Add(LogBuffer::RecordType::Message, std::string(), "Message " + std::to_string(i));
+    }
+
+    REQUIRE(log.Count() == 5);
+    std::ostringstream stream;
+    log.Write(stream);
+    REQUIRE(stream.str() ==
+        "<LogBuffer> 3 earlier records were overwritten.\n"
+        "Message 3\n"
+        "Message 4\n");
+
+    log.Clear();
+    log.Add(LogBuffer::RecordType::Error, std::string(), "Failure");
+    std::ostringstream cleared;
+    log.Write(cleared);
+    REQUIRE(cleared.str() == "<ErrorLog> Failure\n");
+}
+
+TEST_CASE("Log buffer without capacity keeps no records.", "[LogBufferTest]")
+{
+    LogBuffer log(0);
+    log.Add(LogBuffer::RecordType::CreateMachine, "Client");
+
+    std::ostringstream stream;
+    log.Write(stream);
+    REQUIRE(log.Count() == 0);
+    REQUIRE(stream.str().empty());
+}
@@ -0,0 +1,300 @@
+//-----------------------------------------------------------------------
+// <copyright file="ProductionReplayTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "../../src/Runtime/EventTraceRecorder.h"
+#include "P3/Machine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::P3;
+using namespace Microsoft::P3::TestingServices;
+
+// Reporters in the order that the collector received their reports.
+static std::vector<int> ReceivedReports;
+static std::mutex ReceivedReportsLock;
+
+class Report : public Event
+{
+public:
+    int From;
+
+    Report(int from) : Event("Report"), From(from) { }
+};
+
+class Assign : public Event
+{
+public:
+    const ActorId* Target;
+    int From;
+
+    Assign(const ActorId* target, int from) : Event("Assign"), Target(target), From(from) { }
+};
+
+class Collector : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEventDoAction("Report", std::bind(&Collector::InitOnReport, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnReport(std::unique_ptr<Event> event)
+    {
+        std::lock_guard<std::mutex> lock(ReceivedReportsLock);
+        ReceivedReports.push_back(static_cast<Report*>(event.get())->From);
+    }
+};
+
+class Reporter : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Reporter::InitOnEntry, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry(std::unique_ptr<Event> event)
+    {
+        auto assign = static_cast<Assign*>(event.get());
+        Send(*(assign->Target), std::make_unique<Report>(assign->From));
+    }
+};
+
+class Reports : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Reports::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        auto target = CreateMachine<Collector>("Collector");
+        CreateMachine<Reporter>("Reporter1", std::make_unique<Assign>(target, 1));
+        CreateMachine<Reporter>("Reporter2", std::make_unique<Assign>(target, 2));
+    }
+};
+
+class Inspector : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEventDoAction("Report", std::bind(&Inspector::InitOnReport, this, std::placeholders::_1));
+        m_isInspected = false;
+    }
+
+private:
+    bool m_isInspected;
+
+    void InitOnReport(std::unique_ptr<Event> event)
+    {
+        Assert(m_isInspected || static_cast<Report*>(event.get())->From == 1, "The second reporter reported first.");
+        m_isInspected = true;
+    }
+};
+
+class Inspection : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Inspection::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        auto target = CreateMachine<Inspector>("Inspector");
+        CreateMachine<Reporter>("Reporter1", std::make_unique<Assign>(target, 1));
+        CreateMachine<Reporter>("Reporter2", std::make_unique<Assign>(target, 2));
+    }
+};
+
+class Tripwire : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Tripwire::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        Assert(false, "The tripwire was crossed.");
+    }
+};
+
+static const std::string TraceFile = "ProductionReplayTest.trace";
+
+// Writes a trace in which the reporter with the specified index reports first.
+static void RecordReports(EventTraceRecorder& recorder, int first)
+{
+    // The reporters are actors 12 and 13 of a production run.
+    recorder.Add(EventTraceRecorder::RecordType::CreateActor, -1, 10, 0);
+    recorder.Add(EventTraceRecorder::RecordType::CreateActor, 10, 11, 0);
+    recorder.Add(EventTraceRecorder::RecordType::CreateActor, 10, 12, 0);
+    recorder.Add(EventTraceRecorder::RecordType::CreateActor, 10, 13, 0);
+    recorder.Add(EventTraceRecorder::RecordType::SendEvent, 11 + first, 11,
+        EventTraceRecorder::HashName("Report"));
+    recorder.Add(EventTraceRecorder::RecordType::SendEvent, 14 - first, 11,
+        EventTraceRecorder::HashName("Report"));
+}
+
+static std::vector<int> ReplayReports()
+{
+    ReceivedReports.clear();
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->Strategy = ExplorationStrategy::ProductionReplay;
+    configuration->EventTraceFile = TraceFile;
+
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Reports>("Reports");
+    });
+
+    REQUIRE(report->NumOfFoundBugs == 0);
+    return ReceivedReports;
+}
+
+TEST_CASE("Production replay follows the recorded order of events.", "[ProductionReplayTest]")
+{
+    for (int first = 1; first <= 2; first++)
+    {
+        EventTraceRecorder recorder(TraceFile);
+        RecordReports(recorder, first);
+        REQUIRE(recorder.Flush());
+
+        REQUIRE(ReplayReports() == std::vector<int>({ first, 3 - first }));
+    }
+
+    std::remove(TraceFile.c_str());
+}
+
+TEST_CASE("Actor runtime records a trace that replays its order of events.", "[ProductionReplayTest]")
+{
+    ReceivedReports.clear();
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->EventTraceFile = TraceFile;
+    std::unique_ptr<Runtime> runtime(Runtime::Create(std::move(configuration)));
+    runtime->CreateMachine<Reports>("Reports");
+
+    std::vector<int> reports;
+    for (int i = 0; i < 1000 && reports.size() < 2; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::lock_guard<std::mutex> lock(ReceivedReportsLock);
+        reports = ReceivedReports;
+    }
+
+    // The trace is written once the handlers of the runtime have finished.
+    runtime.reset();
+    REQUIRE(reports.size() == 2);
+
+    std::vector<EventTraceRecorder::Record> records;
+    REQUIRE(EventTraceRecorder::LoadFromFile(TraceFile, records));
+    REQUIRE(std::count_if(records.begin(), records.end(), [](const EventTraceRecorder::Record& record)
+    {
+        return record.Type == EventTraceRecorder::RecordType::CreateActor;
+    }) == 4);
+
+    REQUIRE(ReplayReports() == reports);
+    std::remove(TraceFile.c_str());
+}
+
+TEST_CASE("Production replay explores the schedules around the trace after the first iteration.", "[ProductionReplayTest]")
+{
+    {
+        EventTraceRecorder recorder(TraceFile);
+        RecordReports(recorder, 1);
+    }
+
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->Strategy = ExplorationStrategy::ProductionReplay;
+    configuration->EventTraceFile = TraceFile;
+    configuration->SchedulingIterations = 100;
+    configuration->RandomSchedulingSeed = 1;
+
+    auto report = Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Inspection>("Inspection");
+    });
+
+    // The first iteration follows the trace, in which the first reporter
+    // reports first, and a later one deviates from it.
+    std::remove(TraceFile.c_str());
+    REQUIRE(report->NumOfFoundBugs == 1);
+    REQUIRE(report->BugIterations.size() == 1);
+    REQUIRE(report->BugIterations[0] > 0);
+}
+
+TEST_CASE("Event trace recorder writes the buffer of a thread once it is full.", "[ProductionReplayTest]")
+{
+    const size_t threshold = EventTraceRecorder::FlushThreshold;
+    std::vector<EventTraceRecorder::Record> records;
+    {
+        EventTraceRecorder recorder(TraceFile);
+        for (size_t i = 0; i < threshold + 1; i++)
+        {
+            recorder.Add(EventTraceRecorder::RecordType::IntegerChoice, 10, -1, i);
+        }
+
+        REQUIRE(EventTraceRecorder::LoadFromFile(TraceFile, records));
+        REQUIRE(records.size() == threshold);
+    }
+
+    REQUIRE(EventTraceRecorder::LoadFromFile(TraceFile, records));
+    std::remove(TraceFile.c_str());
+    REQUIRE(records.size() == threshold + 1);
+    REQUIRE(records.back().Value == threshold);
+}
+
+TEST_CASE("Actor runtime writes its trace when a handler fails.", "[ProductionReplayTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->EventTraceFile = TraceFile;
+    std::unique_ptr<Runtime> runtime(Runtime::Create(std::move(configuration)));
+    runtime->CreateMachine<Tripwire>("Tripwire");
+
+    // The trace is read while the runtime is still alive.
+    std::vector<EventTraceRecorder::Record> records;
+    for (int i = 0; i < 1000 && records.empty(); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        REQUIRE(EventTraceRecorder::LoadFromFile(TraceFile, records));
+    }
+
+    runtime.reset();
+    std::remove(TraceFile.c_str());
+    REQUIRE(records.size() == 1);
+    REQUIRE(records[0].Type == EventTraceRecorder::RecordType::CreateActor);
+}
@@ -0,0 +1,264 @@
+//-----------------------------------------------------------------------
+// <copyright file="ScheduleTraceTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "../../src/TestingServices/ExplorationStrategies/RandomStrategy.h"
+#include "../../src/TestingServices/Tracing/ScheduleTrace.h"
+#include "P3/Machine.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace Microsoft::P3;
+using namespace Microsoft::P3::TestingServices;
+
+class Ballot : public Event
+{
+public:
+    Ballot() : Event("Ballot") { }
+};
+
+class Close : public Event
+{
+public:
+    Close() : Event("Close") { }
+};
+
+class Enroll : public Event
+{
+public:
+    const ActorId* Tally;
+
+    Enroll(const ActorId* tally) : Event("Enroll"), Tally(tally) { }
+};
+
+class Tally : public Machine
+{
+protected:
+    void Initialize()
+    {
+        m_ballots = 0;
+        auto initState = AddState("Init", true);
+        initState->SetOnEventDoAction("Ballot", std::bind(&Tally::InitOnBallot, this));
+        initState->SetOnEventDoAction("Close", std::bind(&Tally::InitOnClose, this));
+    }
+
+private:
+    int m_ballots;
+
+    void InitOnBallot()
+    {
+        m_ballots++;
+    }
+
+    void InitOnClose()
+    {
+        Assert(m_ballots == 2, "The election closed before every ballot was counted.");
+    }
+};
+
+class Voter : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Voter::InitOnEntry, this, std::placeholders::_1));
+        initState->SetOnEventDoAction("Enroll", std::bind(&Voter::InitOnEntry, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry(std::unique_ptr<Event> event)
+    {
+        auto tally = static_cast<Enroll*>(event.get())->Tally;
+        if (RandomBoolean())
+        {
+            Send(*tally, std::make_unique<Ballot>());
+        }
+        else
+        {
+            // A voter that casts its ballot late gives the election a chance to close first.
+            Send(*GetId(), std::make_unique<Enroll>(tally));
+        }
+    }
+};
+
+class Closer : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Closer::InitOnEntry, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry(std::unique_ptr<Event> event)
+    {
+        Send(*(static_cast<Enroll*>(event.get())->Tally), std::make_unique<Close>());
+    }
+};
+
+class Election : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Election::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        auto tally = CreateMachine<Tally>("Tally");
+        CreateMachine<Voter>("Voter1", std::make_unique<Enroll>(tally));
+        CreateMachine<Voter>("Voter2", std::make_unique<Enroll>(tally));
+        CreateMachine<Closer>("Closer", std::make_unique<Enroll>(tally));
+    }
+};
+
+static std::unique_ptr<TestReport> RunElection(std::unique_ptr<Configuration> configuration)
+{
+    return Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Election>("Election");
+    });
+}
+
+// Returns the directory for temporary files.
+static std::string GetTempDirectory()
+{
+    for (auto name : { "TMPDIR", "TEMP", "TMP" })
+    {
+        auto value = std::getenv(name);
+        if (value != nullptr && *value != '\0')
+        {
+            return value;
+        }
+    }
+
+    return "/tmp";
+}
+
+TEST_CASE("Schedule trace round-trips through its binary format.", "[ScheduleTraceTest]")
+{
+    ScheduleTrace trace;
+    trace.Seed = 4242;
+    trace.Iteration = 17;
+    trace.AddSchedulingChoice(0);
+    trace.AddSchedulingChoice(300);
+    trace.AddBooleanChoice(true);
+    trace.AddBooleanChoice(false);
+    trace.AddIntegerChoice(70000);
+
+    std::stringstream stream;
+    trace.Serialize(stream);
+    auto data = stream.str();
+    REQUIRE(data.compare(0, 4, "P3ST") == 0);
+
+    ScheduleTrace copy;
+    REQUIRE(copy.Deserialize(stream));
+    REQUIRE(copy.Seed == 4242);
+    REQUIRE(copy.Iteration == 17);
+    REQUIRE(copy.Count() == trace.Count());
+    for (size_t i = 0; i < trace.Count(); i++)
+    {
+        REQUIRE(copy.Get(i).Type == trace.Get(i).Type);
+        REQUIRE(copy.Get(i).Value == trace.Get(i).Value);
+    }
+
+    // A truncated trace, and a trace that claims more steps than it has, are rejected.
+    std::istringstream truncated(data.substr(0, data.size() - 1));
+    REQUIRE(!copy.Deserialize(truncated));
+
+    ScheduleTrace empty;
+    std::ostringstream header;
+    empty.Serialize(header);
+    auto oversized = header.str();
+    oversized.back() = static_cast<char>(0xFF);
+    oversized += std::string(7, static_cast<char>(0xFF)) + std::string(1, 0x0F);
+    std::istringstream oversizedStream(oversized);
+    REQUIRE(!copy.Deserialize(oversizedStream));
+
+    std::istringstream garbage("P3XX");
+    REQUIRE(!copy.Deserialize(garbage));
+}
+
+TEST_CASE("Random strategy derives the seed of each iteration from the campaign seed.", "[ScheduleTraceTest]")
+{
+    REQUIRE(RandomStrategy::GetIterationSeed(7, 3) == RandomStrategy::GetIterationSeed(7, 3));
+    REQUIRE(RandomStrategy::GetIterationSeed(7, 3) != RandomStrategy::GetIterationSeed(7, 4));
+    REQUIRE(RandomStrategy::GetIterationSeed(7, 3) != RandomStrategy::GetIterationSeed(8, 3));
+
+    // An iteration makes the same choices without running the ones before it.
+    RandomStrategy campaign(7);
+    for (int iteration = 0; iteration < 3; iteration++)
+    {
+        campaign.PrepareForNextIteration(iteration);
+        int skipped;
+        campaign.GetNextIntegerChoice(1000, skipped);
+    }
+
+    RandomStrategy resumed(7);
+    resumed.PrepareForNextIteration(3);
+    campaign.PrepareForNextIteration(3);
+    for (int i = 0; i < 10; i++)
+    {
+        int expected, actual;
+        campaign.GetNextIntegerChoice(1000, expected);
+        resumed.GetNextIntegerChoice(1000, actual);
+        REQUIRE(actual == expected);
+    }
+}
+
+TEST_CASE("Replaying the saved trace of a bug reproduces the bug.", "[ScheduleTraceTest]")
+{
+    const std::string directory = GetTempDirectory();
+    const std::string traceFile = directory + "/bug_1.schedule";
+    const std::string logFile = directory + "/bug_1.log";
+    const std::string reportFile = directory + "/test_report.json";
+    std::remove(traceFile.c_str());
+    std::remove(logFile.c_str());
+
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->Strategy = ExplorationStrategy::Random;
+    configuration->RandomSchedulingSeed = 11;
+    configuration->SchedulingIterations = 1000;
+    configuration->OutputFilePath = directory;
+    REQUIRE(RunElection(std::move(configuration))->NumOfFoundBugs == 1);
+
+    // The log of the buggy iteration is kept in memory, and written by default.
+    std::ifstream log(logFile);
+    std::string line;
+    REQUIRE(std::getline(log, line));
+    log.close();
+
+    ScheduleTrace trace;
+    REQUIRE(trace.LoadFromFile(traceFile));
+    REQUIRE(trace.Seed == 11);
+    REQUIRE(trace.Count() > 0);
+
+    auto replayConfiguration = Test::GetDefaultConfiguration();
+    replayConfiguration->Strategy = ExplorationStrategy::Replay;
+    replayConfiguration->ScheduleFile = traceFile;
+    REQUIRE(RunElection(std::move(replayConfiguration))->NumOfFoundBugs == 1);
+
+    std::remove(traceFile.c_str());
+    std::remove(logFile.c_str());
+    std::remove(reportFile.c_str());
+}
@@ -0,0 +1,177 @@
+//-----------------------------------------------------------------------
+// <copyright file="StateFingerprintTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "../../src/TestingServices/Coverage/StateFingerprint.h"
+#include "P3/Machine.h"
+#include <chrono>
+
+using namespace Microsoft::P3;
+using namespace Microsoft::P3::TestingServices;
+
+TEST_CASE("State fingerprint does not depend on the order of its components.", "[StateFingerprintTest]")
+{
+    int first, second;
+    StateFingerprint fingerprint;
+    fingerprint.Update(&first, 1);
+    fingerprint.Update(&second, 2);
+
+    StateFingerprint reordered;
+    reordered.Update(&second, 2);
+    reordered.Update(&first, 1);
+
+    REQUIRE(fingerprint.Get() == reordered.Get());
+
+    StateFingerprint swapped;
+    swapped.Update(&first, 2);
+    swapped.Update(&second, 3);
+    REQUIRE(fingerprint.Get() != swapped.Get());
+}
+
+TEST_CASE("State fingerprint is updated incrementally.", "[StateFingerprintTest]")
+{
+    int first, second;
+    StateFingerprint fingerprint;
+    fingerprint.Update(&first, 1);
+    auto initial = fingerprint.Get();
+
+    fingerprint.Update(&second, 2);
+    fingerprint.Update(&first, 3);
+    REQUIRE(fingerprint.Get() != initial);
+
+    fingerprint.Update(&first, 1);
+    fingerprint.Remove(&second);
+    REQUIRE(fingerprint.Get() == initial);
+
+    fingerprint.Clear();
+    REQUIRE(fingerprint.Get() == 0);
+}
+
+TEST_CASE("Combined hashes depend on the order of the values.", "[StateFingerprintTest]")
+{
+    auto hash = StateFingerprint::Combine(StateFingerprint::Combine(0, StateFingerprint::Hash("Init")), 1);
+    auto reordered = StateFingerprint::Combine(StateFingerprint::Combine(0, 1), StateFingerprint::Hash("Init"));
+    REQUIRE(hash != reordered);
+}
+
+class Pulse : public Event
+{
+public:
+    Pulse() : Event("Pulse") { }
+};
+
+class Nudge : public Event
+{
+public:
+    Nudge() : Event("Nudge") { }
+};
+
+class Metronome : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Metronome::InitOnEntry, this));
+        initState->SetOnEventDoAction("Pulse", std::bind(&Metronome::InitOnPulse, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        StartTimer(std::chrono::seconds(1), std::make_unique<Pulse>());
+        StartTimer(std::chrono::seconds(2), std::make_unique<Pulse>());
+    }
+
+    void InitOnPulse()
+    {
+        StartTimer(std::chrono::seconds(2), std::make_unique<Pulse>());
+    }
+};
+
+class Sink : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEventDoAction("Nudge", [](std::unique_ptr<Event>) { });
+    }
+};
+
+class Nudger : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Nudger::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        auto sink = CreateMachine<Sink>("Sink");
+        Send(*sink, std::make_unique<Nudge>());
+        Send(*sink, std::make_unique<Nudge>());
+    }
+};
+
+static std::unique_ptr<TestReport> RunMetronome(int maxTimerFirings)
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->Strategy = ExplorationStrategy::DFS;
+    configuration->EnableStateHashing = true;
+    configuration->MaxTimerFirings = maxTimerFirings;
+
+    return Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Metronome>("Metronome");
+    });
+}
+
+static std::unique_ptr<TestReport> RunNudges(bool isStateHashingEnabled)
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->Strategy = ExplorationStrategy::DFS;
+    configuration->SchedulingIterations = 100;
+    configuration->EnableStateHashing = isStateHashingEnabled;
+
+    return Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Nudger>("Nudger");
+    });
+}
+
+TEST_CASE("Restarted timers reach the same program state at every beat.", "[StateFingerprintTest]")
+{
+    auto report = RunMetronome(10);
+    auto longerReport = RunMetronome(50);
+
+    REQUIRE(report->NumOfProgramStates == 1);
+    REQUIRE(longerReport->NumOfProgramStates == 1);
+}
+
+TEST_CASE("The scheduling points of a handler are distinct program states.", "[StateFingerprintTest]")
+{
+    // Once the sink handled the first nudge, the nudger is about to send the
+    // second one with the same fields, state and inboxes as before the first.
+    auto report = RunNudges(false);
+    auto hashedReport = RunNudges(true);
+
+    REQUIRE(hashedReport->Termination == TestReport::TerminationReason::StrategyExhausted);
+    REQUIRE(hashedReport->NumOfProgramStates == 9);
+    REQUIRE(hashedReport->NumOfExploredSchedules == report->NumOfExploredSchedules);
+}
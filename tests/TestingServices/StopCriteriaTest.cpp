@@ -0,0 +1,131 @@
+//-----------------------------------------------------------------------
+// <copyright file="StopCriteriaTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "P3/Machine.h"
+
+using namespace Microsoft::P3;
+using namespace Microsoft::P3::TestingServices;
+
+class Volley : public Event
+{
+public:
+    const ActorId* From;
+
+    Volley(const ActorId* from) : Event("Volley"), From(from) { }
+};
+
+class Player : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEventDoAction("Volley", std::bind(&Player::InitOnVolley, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnVolley(std::unique_ptr<Event> event)
+    {
+        Send(*(static_cast<Volley*>(event.get())->From), std::make_unique<Volley>(GetId()));
+    }
+};
+
+class Rally : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Rally::InitOnEntry, this));
+        initState->SetOnEventDoAction("Volley", std::bind(&Rally::InitOnVolley, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        auto player = CreateMachine<Player>("Player");
+        Send(*player, std::make_unique<Volley>(GetId()));
+    }
+
+    void InitOnVolley(std::unique_ptr<Event> event)
+    {
+        Send(*(static_cast<Volley*>(event.get())->From), std::make_unique<Volley>(GetId()));
+    }
+};
+
+// Runs the rally, which never ends on its own.
+static std::unique_ptr<TestReport> RunRally(std::unique_ptr<Configuration> configuration)
+{
+    return Test::Run(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Rally>("Rally");
+    });
+}
+
+TEST_CASE("Campaign stops when its wall-clock budget is exhausted.", "[StopCriteriaTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 0;
+    configuration->Timeout = 1;
+    configuration->MaxSchedulingSteps = 500;
+    auto report = RunRally(std::move(configuration));
+
+    REQUIRE(report->Termination == TestReport::TerminationReason::Timeout);
+    REQUIRE(report->NumOfExploredSchedules > 0);
+    REQUIRE(report->NumOfFoundBugs == 0);
+}
+
+TEST_CASE("Iteration that exceeds its wall-clock budget is cut off.", "[StopCriteriaTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 3;
+    configuration->IterationTimeout = 50;
+    auto report = RunRally(std::move(configuration));
+
+    REQUIRE(report->Termination == TestReport::TerminationReason::IterationLimit);
+    REQUIRE(report->NumOfExploredSchedules == 3);
+    REQUIRE(report->NumOfCutOffSchedules == 3);
+}
+
+TEST_CASE("Iteration that reaches the step bound is cut off.", "[StopCriteriaTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 5;
+    configuration->MaxSchedulingSteps = 100;
+    auto report = RunRally(std::move(configuration));
+
+    REQUIRE(report->Termination == TestReport::TerminationReason::IterationLimit);
+    REQUIRE(report->NumOfExploredSchedules == 5);
+    REQUIRE(report->NumOfCutOffSchedules == 5);
+    REQUIRE(report->MaxExploredSteps <= 100);
+}
+
+TEST_CASE("Single-thread iteration is cut off between two handlers.", "[StopCriteriaTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->EnableSingleThreadMode = true;
+    configuration->SchedulingIterations = 5;
+    configuration->MaxSchedulingSteps = 100;
+    auto report = RunRally(std::move(configuration));
+
+    REQUIRE(report->NumOfCutOffSchedules == 5);
+
+    auto timedConfiguration = Test::GetDefaultConfiguration();
+    timedConfiguration->EnableSingleThreadMode = true;
+    timedConfiguration->SchedulingIterations = 2;
+    timedConfiguration->IterationTimeout = 50;
+    REQUIRE(RunRally(std::move(timedConfiguration))->NumOfCutOffSchedules == 2);
+}
@@ -0,0 +1,188 @@
+//-----------------------------------------------------------------------
+// <copyright file="StrategyPortfolioTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "../../src/TestingServices/ExplorationStrategies/StrategyPortfolio.h"
+#include "P3/Machine.h"
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::P3;
+using namespace Microsoft::P3::TestingServices;
+
+// Number of racers, whose first two arrivals are states of the judge.
+static const int NumOfRacers = 12;
+
+class Lap : public Event
+{
+public:
+    const ActorId* Target;
+    int From;
+
+    Lap(const ActorId* target, int from) : Event("Lap"), Target(target), From(from) { }
+};
+
+class Judge : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto lap = std::bind(&Judge::OnLap, this, std::placeholders::_1);
+        AddState("Init", true)->SetOnEventDoAction("Lap", lap);
+        for (int first = 0; first < NumOfRacers; first++)
+        {
+            AddState("First" + std::to_string(first))->SetOnEventDoAction("Lap", lap);
+            for (int second = 0; second < NumOfRacers; second++)
+            {
+                if (second != first)
+                {
+                    AddState("First" + std::to_string(first) + "Second" + std::to_string(second))->
+                        SetOnEventDoAction("Lap", [](std::unique_ptr<Event>) { });
+                }
+            }
+        }
+    }
+
+private:
+    void OnLap(std::unique_ptr<Event> event)
+    {
+        auto state = GetCurrentState();
+        auto from = std::to_string(static_cast<Lap*>(event.get())->From);
+        Jump(state == "Init" ? "First" + from : state + "Second" + from);
+    }
+};
+
+class Racer : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Racer::InitOnEntry, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry(std::unique_ptr<Event> event)
+    {
+        auto lap = static_cast<Lap*>(event.get());
+        Send(*(lap->Target), std::make_unique<Lap>(nullptr, lap->From));
+    }
+};
+
+class Race : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Race::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        auto judge = CreateMachine<Judge>("Judge");
+        for (int racer = 0; racer < NumOfRacers; racer++)
+        {
+            CreateMachine<Racer>("Racer" + std::to_string(racer), std::make_unique<Lap>(judge, racer));
+        }
+    }
+};
+
+TEST_CASE("Strategy portfolio tries every strategy first.", "[StrategyPortfolioTest]")
+{
+    StrategyPortfolio portfolio;
+    std::vector<size_t> arms;
+    portfolio.Assign(portfolio.Size(), 10, arms);
+
+    REQUIRE(arms.size() == portfolio.Size());
+    std::sort(arms.begin(), arms.end());
+    for (size_t arm = 0; arm < arms.size(); arm++)
+    {
+        REQUIRE(arms[arm] == arm);
+    }
+}
+
+TEST_CASE("Strategy portfolio moves workers to productive strategies.", "[StrategyPortfolioTest]")
+{
+    StrategyPortfolio portfolio;
+    for (size_t arm = 0; arm < portfolio.Size(); arm++)
+    {
+        portfolio.Update(arm, 100, arm == 1 ? 50 : 0, 0);
+    }
+
+    std::vector<size_t> arms;
+    portfolio.Assign(8, 100, arms);
+
+    REQUIRE(std::count(arms.begin(), arms.end(), 1) > 2);
+    REQUIRE(portfolio.GetName(1) == "PCT(2)");
+}
+
+TEST_CASE("Strategy portfolio keeps its statistics across campaigns.", "[StrategyPortfolioTest]")
+{
+    StrategyPortfolio portfolio;
+    portfolio.Update(1, 100, 50, 1);
+    std::stringstream stream;
+    portfolio.SaveProgress(stream);
+
+    StrategyPortfolio resumed;
+    REQUIRE(resumed.LoadProgress(stream));
+    REQUIRE(resumed.Get(1).NumOfIterations == 100);
+    REQUIRE(resumed.Get(1).NumOfRewardedIterations == 50);
+    REQUIRE(resumed.Get(1).NumOfFoundBugs == 1);
+    REQUIRE(resumed.Get(0).NumOfIterations == 0);
+
+    std::stringstream empty;
+    REQUIRE_FALSE(resumed.LoadProgress(empty));
+}
+
+TEST_CASE("Strategy portfolio runs more iterations with strategies that cover new activities.", "[StrategyPortfolioTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+    configuration->SchedulingIterations = 4800;
+    configuration->ForkedProcesses = 6;
+    configuration->EnableStrategyPortfolio = true;
+    configuration->RandomSchedulingSeed = 1;
+
+    std::unique_ptr<BugFindingEngine> engine(BugFindingEngine::Create(std::move(configuration), [](Runtime& runtime)
+    {
+        runtime.CreateMachine<Race>("Race");
+    }));
+
+    engine->Run();
+    auto portfolio = engine->GetPortfolio();
+    REQUIRE(engine->GetReport()->NumOfExploredSchedules == 4800);
+    REQUIRE(portfolio != nullptr);
+
+    // Delay bounding mostly keeps the order in which the racers were created,
+    // while the other strategies keep covering new pairs of arrivals.
+    long long maxDelayBoundingIterations = 0, minOtherIterations = 4800;
+    for (size_t arm = 0; arm < portfolio->Size(); arm++)
+    {
+        auto& entry = portfolio->Get(arm);
+        if (entry.Strategy == ExplorationStrategy::DelayBounding)
+        {
+            maxDelayBoundingIterations = std::max(maxDelayBoundingIterations, entry.NumOfIterations);
+        }
+        else
+        {
+            minOtherIterations = std::min(minOtherIterations, entry.NumOfIterations);
+        }
+    }
+
+    REQUIRE(maxDelayBoundingIterations < minOtherIterations);
+}
@@ -0,0 +1,102 @@
+//-----------------------------------------------------------------------
+// <copyright file="TestReportTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "P3/TestingServices/Statistics/TestReport.h"
+#include <sstream>
+
+using namespace Microsoft::P3::TestingServices;
+
+TEST_CASE("Test report aggregates the statistics of its iterations.", "[TestReportTest]")
+{
+    TestReport report;
+    report.RecordIteration(5, 0.25, 2, 10);
+    report.RecordIteration(0, 0.5, 1, 0);
+    report.RecordIteration(40, 0.25, 3, 20);
+
+    REQUIRE(report.NumOfExploredSchedules == 3);
+    REQUIRE(report.TotalExploredSteps == 45);
+    REQUIRE(report.MinExploredSteps == 0);
+    REQUIRE(report.MaxExploredSteps == 40);
+    REQUIRE(report.GetAverageExploredSteps() == 15);
+    REQUIRE(report.ExploredStepsHistogram[0] == 1);
+    REQUIRE(report.ExploredStepsHistogram[3] == 1);
+    REQUIRE(report.ExploredStepsHistogram[6] == 1);
+    REQUIRE(report.MinIterationTime == 0.25);
+    REQUIRE(report.MaxIterationTime == 0.5);
+    REQUIRE(report.NumOfCreatedActors == 6);
+    REQUIRE(report.NumOfSentEvents == 30);
+}
+
+TEST_CASE("Test reports of parallel campaigns are merged.", "[TestReportTest]")
+{
+    TestReport first;
+    first.RecordIteration(10, 1, 1, 1);
+    first.TestingTime = 2;
+
+    TestReport second;
+    second.RecordIteration(4, 0.5, 1, 1);
+    second.RecordIteration(20, 1.5, 1, 1);
+    second.NumOfFoundBugs = 1;
+    second.BugIterations.push_back(1);
+    second.TestingTime = 3;
+    second.Termination = TestReport::TerminationReason::BugFound;
+
+    first.Merge(second);
+
+    REQUIRE(first.NumOfExploredSchedules == 3);
+    REQUIRE(first.NumOfFoundBugs == 1);
+    REQUIRE(first.MinExploredSteps == 4);
+    REQUIRE(first.MaxExploredSteps == 20);
+    REQUIRE(first.MinIterationTime == 0.5);
+    REQUIRE(first.TestingTime == 3);
+    REQUIRE(first.GetSchedulesPerSecond() == 1);
+    REQUIRE(first.BugIterations.size() == 1);
+    REQUIRE(first.Termination == TestReport::TerminationReason::BugFound);
+}
+
+TEST_CASE("Test report is exported as JSON.", "[TestReportTest]")
+{
+    TestReport report;
+    report.RecordIteration(3, 1, 2, 4);
+    report.NumOfFoundBugs = 1;
+    report.BugIterations.push_back(0);
+
+    auto json = report.ToJson();
+    REQUIRE(json.front() == '{');
+    REQUIRE(json.back() == '}');
+    REQUIRE(json.find("\"numOfFoundBugs\":1") != std::string::npos);
+    REQUIRE(json.find("\"exploredStepsHistogram\":[0,0,1]") != std::string::npos);
+    REQUIRE(json.find("\"bugIterations\":[0]") != std::string::npos);
+    REQUIRE(json.find("\"termination\":\"IterationLimit\"") != std::string::npos);
+}
+
+TEST_CASE("Test report is passed between processes in its binary format.", "[TestReportTest]")
+{
+    TestReport report;
+    report.RecordIteration(7, 0.5, 3, 12);
+    report.NumOfFoundBugs = 1;
+    report.BugIterations.push_back(4);
+    report.Termination = TestReport::TerminationReason::BugFound;
+
+    std::stringstream stream;
+    report.Serialize(stream);
+
+    TestReport copy;
+    REQUIRE(copy.Deserialize(stream));
+    REQUIRE(copy.ToJson() == report.ToJson());
+
+    std::stringstream invalid("P3XX");
+    REQUIRE(!copy.Deserialize(invalid));
+}
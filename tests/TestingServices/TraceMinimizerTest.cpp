@@ -0,0 +1,177 @@
+//-----------------------------------------------------------------------
+// <copyright file="TraceMinimizerTest.cpp">
+//      Copyright (c) Microsoft Corporation. All rights reserved.
+// 
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//      MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//      CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//      TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// </copyright>
+//-----------------------------------------------------------------------
+
+#include "../Framework/catch.hpp"
+#include "../Common.h"
+#include "../../src/Runtime/BugFindingRuntime.h"
+#include "../../src/TestingServices/ExplorationStrategies/RandomStrategy.h"
+#include "../../src/TestingServices/ExplorationStrategies/ReplayStrategy.h"
+#include "../../src/TestingServices/Tracing/TraceMinimizer.h"
+#include "P3/Machine.h"
+#include <string>
+
+using namespace Microsoft::P3;
+using namespace Microsoft::P3::TestingServices;
+
+class Deposit : public Event
+{
+public:
+    Deposit() : Event("Deposit") { }
+};
+
+class Audit : public Event
+{
+public:
+    Audit() : Event("Audit") { }
+};
+
+class Account : public Event
+{
+public:
+    const ActorId* Ledger;
+
+    Account(const ActorId* ledger) : Event("Account"), Ledger(ledger) { }
+};
+
+class Ledger : public Machine
+{
+protected:
+    void Initialize()
+    {
+        m_deposits = 0;
+        auto initState = AddState("Init", true);
+        initState->SetOnEventDoAction("Deposit", std::bind(&Ledger::InitOnDeposit, this));
+        initState->SetOnEventDoAction("Audit", std::bind(&Ledger::InitOnAudit, this));
+    }
+
+private:
+    int m_deposits;
+
+    void InitOnDeposit()
+    {
+        m_deposits++;
+    }
+
+    void InitOnAudit()
+    {
+        Assert(m_deposits == 30, "The ledger was audited before every deposit was made.");
+    }
+};
+
+class Depositor : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Depositor::InitOnEntry, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry(std::unique_ptr<Event> event)
+    {
+        auto ledger = static_cast<Account*>(event.get())->Ledger;
+        for (int i = 0; i < 10; i++)
+        {
+            Send(*ledger, std::make_unique<Deposit>());
+        }
+    }
+};
+
+class Auditor : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Auditor::InitOnEntry, this, std::placeholders::_1));
+    }
+
+private:
+    void InitOnEntry(std::unique_ptr<Event> event)
+    {
+        Send(*(static_cast<Account*>(event.get())->Ledger), std::make_unique<Audit>());
+    }
+};
+
+class Bank : public Machine
+{
+protected:
+    void Initialize()
+    {
+        auto initState = AddState("Init", true);
+        initState->SetOnEntryAction(std::bind(&Bank::InitOnEntry, this));
+    }
+
+private:
+    void InitOnEntry()
+    {
+        auto ledger = CreateMachine<Ledger>("Ledger");
+        CreateMachine<Depositor>("Depositor1", std::make_unique<Account>(ledger));
+        CreateMachine<Depositor>("Depositor2", std::make_unique<Account>(ledger));
+        CreateMachine<Depositor>("Depositor3", std::make_unique<Account>(ledger));
+        CreateMachine<Auditor>("Auditor", std::make_unique<Account>(ledger));
+    }
+};
+
+static void RunBank(Runtime& runtime)
+{
+    runtime.CreateMachine<Bank>("Bank");
+}
+
+// Runs an iteration of the bank with the specified strategy, and returns
+// true if it found a bug.
+static bool RunBankIteration(IExplorationStrategy& strategy, int iteration, const Configuration& configuration,
+    ScheduleTrace& trace, std::string& bugReport)
+{
+    strategy.PrepareForNextIteration(iteration);
+    std::unique_ptr<BugFindingRuntime> runtime(new BugFindingRuntime(
+        std::unique_ptr<Configuration>(Configuration::CopyFrom(configuration)), &strategy));
+    runtime->RunTest(RunBank);
+    runtime->Wait();
+
+    auto scheduler = runtime->GetScheduler();
+    trace = scheduler->GetTrace();
+    bugReport = scheduler->BugReport;
+    return scheduler->BugFound;
+}
+
+TEST_CASE("Minimized trace is shorter and reproduces the same bug.", "[TraceMinimizerTest]")
+{
+    auto configuration = Test::GetDefaultConfiguration();
+
+    // Finds a bug with a long random schedule.
+    RandomStrategy random(3);
+    ScheduleTrace trace;
+    std::string bugReport;
+    int iteration = 0;
+    while (!RunBankIteration(random, iteration, *configuration, trace, bugReport) || trace.Count() < 20)
+    {
+        iteration++;
+        REQUIRE(iteration < 1000);
+    }
+
+    TraceMinimizer minimizer(*configuration, RunBank);
+    ScheduleTrace minimized;
+    REQUIRE(minimizer.Minimize(trace, bugReport, minimized));
+    REQUIRE(minimized.Count() < trace.Count());
+    REQUIRE(minimizer.GetNumOfRuns() > 0);
+
+    ReplayStrategy replay(minimized);
+    ScheduleTrace replayed;
+    std::string replayedBugReport;
+    REQUIRE(RunBankIteration(replay, 0, *configuration, replayed, replayedBugReport));
+    REQUIRE(replayedBugReport == bugReport);
+    REQUIRE(!replay.HasDiverged());
+}